@@ -11,6 +11,7 @@
 
 #include <vector>
 #include <memory>
+#include <functional>
 #include "SetVisibilities.h"
 #include "CompilerConfig.h"
 #include "ProgramBuilder.h"
@@ -20,13 +21,20 @@
 
 DECL_PRIVATE_IMPL_FOR(Compiler)
 
+#if defined _WIN32 || defined __CYGWIN__
 #define COMPILE_PASS(prog, pipeline, args) \
     extern "C" void __declspec(dllexport) __stdcall compilePass(prog, pipeline, args)
+#else
+#define COMPILE_PASS(prog, pipeline, args) \
+    extern "C" void __attribute__ ((visibility ("default"))) compilePass(prog, pipeline, args)
+#endif
 
 namespace sfsl {
 
 class SFSL_API_PUBLIC Compiler final {
 public:
+    typedef std::function<void(ProgramBuilder)> ModuleHandler;
+
     Compiler(const CompilerConfig& config);
     ~Compiler();
 
@@ -34,11 +42,19 @@ public:
     void unloadPlugin(const std::string& pathToPluginDll);
 
     ProgramBuilder parse(const std::string& srcName, const std::string& srcContent);
+    ProgramBuilder parse(const std::string& srcName, const char* srcContent, size_t srcSize);
+    ProgramBuilder parseFile(const std::string& srcPath);
+    ProgramBuilder parseFiles(const std::vector<std::string>& srcPaths);
+
+    void parseByModule(const std::string& srcName, const char* srcContent, size_t srcSize, const ModuleHandler& onModule);
+    void parseFileByModule(const std::string& srcPath, const ModuleHandler& onModule);
 
     void compile(   ProgramBuilder progBuilder,
                     AbstractOutputCollector& collector,
                     const Pipeline& ppl = Pipeline::createDefault());
 
+    void dumpMemoryStats(std::ostream& o) const;
+
 private:
     PRIVATE_IMPL_PTR(Compiler) _impl;
 };
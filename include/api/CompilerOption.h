@@ -20,6 +20,9 @@ namespace opt {
 SFSL_DEF_OPTION(Reporter, AbstractReporter*)
 SFSL_DEF_OPTION(PrimitiveNamer, common::AbstractPrimitiveNamer*)
 SFSL_DEF_OPTION(InitialChunkSize, size_t)
+SFSL_DEF_OPTION(MaxChunkSize, size_t)
+SFSL_DEF_OPTION(ChunkGrowthFactor, size_t)
+SFSL_DEF_OPTION(LargeObjectSize, size_t)
 
 struct SFSL_API_PUBLIC AfterEachPhase {
     enum PrintOption {
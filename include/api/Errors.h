@@ -20,6 +20,12 @@ public:
     ~CompileError();
 };
 
+class SFSL_API_PUBLIC RuntimeError final : public std::runtime_error {
+public:
+    explicit RuntimeError(const std::string& msg);
+    ~RuntimeError();
+};
+
 }
 
 #endif
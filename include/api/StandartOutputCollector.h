@@ -12,6 +12,7 @@
 #include <iostream>
 #include <vector>
 #include "AbstractOutputCollector.h"
+#include "VirtualMachine.h"
 
 namespace sfsl {
 
@@ -29,6 +30,20 @@ private:
     std::vector<std::string> _result;
 };
 
+class SFSL_API_PUBLIC VMCollector : public AbstractOutputCollector {
+public:
+    VMCollector();
+    virtual ~VMCollector();
+
+    virtual void collect(PhaseContext& pctx);
+
+    VirtualMachine get() const;
+
+private:
+
+    VirtualMachine _vm;
+};
+
 class SFSL_API_PUBLIC ErrorCountCollector : public AbstractOutputCollector {
 public:
     ErrorCountCollector();
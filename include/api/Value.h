@@ -0,0 +1,58 @@
+//
+//  Value.h
+//  SFSL
+//
+//  Created by Romain Beguet on 17.10.16.
+//  Copyright (c) 2016 Romain Beguet. All rights reserved.
+//
+
+#ifndef __SFSL__API_Value__
+#define __SFSL__API_Value__
+
+#include <cstdint>
+#include <type_traits>
+
+namespace sfsl {
+
+namespace vm {
+
+/**
+ * @brief The Integer type of the virtual machine (same as the compiler's, i.e. 4 or 8 bytes)
+ */
+typedef std::conditional<sizeof(void*) == 8, int64_t, int32_t>::type int_t;
+
+/**
+ * @brief The Real type of the virtual machine (float for 32bit archs and double for 64 archs)
+ */
+typedef std::conditional<sizeof(void*) == 8, double, float>::type real_t;
+
+/**
+ * @brief Represents a value manipulated by the virtual machine.
+ * Strings, objects and classes refer to memory owned by the virtual machine:
+ * they stay valid as long as they are reachable from the running program.
+ */
+struct Value final {
+    enum TYPE { UNDEFINED, UNIT, BOOL, INT, REAL, STRING, OBJECT, CLASS, METHOD, NATIVE };
+
+    Value() : type(UNDEFINED), ref(nullptr) {}
+
+    static Value Unit() { Value v; v.type = UNIT; return v; }
+    static Value Bool(bool b) { Value v; v.type = BOOL; v.b = b; return v; }
+    static Value Int(int_t i) { Value v; v.type = INT; v.i = i; return v; }
+    static Value Real(real_t r) { Value v; v.type = REAL; v.r = r; return v; }
+
+    TYPE type;
+
+    union {
+        bool b;
+        int_t i;
+        real_t r;
+        void* ref;
+    };
+};
+
+}
+
+}
+
+#endif
@@ -0,0 +1,119 @@
+//
+//  VirtualMachine.h
+//  SFSL
+//
+//  Created by Romain Beguet on 17.10.16.
+//  Copyright (c) 2016 Romain Beguet. All rights reserved.
+//
+
+#ifndef __SFSL__API_VirtualMachine__
+#define __SFSL__API_VirtualMachine__
+
+#include <iostream>
+#include <vector>
+#include <memory>
+#include <functional>
+#include "SetVisibilities.h"
+#include "Value.h"
+
+DECL_PRIVATE_IMPL_FOR(VirtualMachine)
+
+namespace sfsl {
+
+namespace vm {
+
+/**
+ * @brief Gives native methods access to the state of the virtual machine.
+ * Errors should be reported by throwing a #sfsl::RuntimeError.
+ */
+class SFSL_API_PUBLIC RuntimeCtx {
+public:
+    virtual ~RuntimeCtx();
+
+    virtual Value makeString(const std::string& str) = 0;
+    virtual const std::string& getString(Value str) const = 0;
+
+    virtual Value getField(Value obj, size_t index) const = 0;
+    virtual void setField(Value obj, size_t index, Value val) = 0;
+
+    /**
+     * @brief Calls the method at index `methodIndex` of the virtual table of `callee`.
+     * Function objects have their `()` method at index 0.
+     */
+    virtual Value callMethod(Value callee, size_t methodIndex, const std::vector<Value>& args) = 0;
+};
+
+/**
+ * @brief A method implemented on the host side. `self` is the object on which
+ * the method is called (or the native itself when called as a function),
+ * and `args` points to the arguments of the call.
+ */
+typedef std::function<Value(RuntimeCtx& ctx, Value self, Value* args)> NativeMethod;
+
+}
+
+class SFSL_API_PUBLIC VirtualMachine final {
+public:
+    ~VirtualMachine();
+
+    operator bool() const;
+
+    /**
+     * @return True if the program refers to the definition with the given name
+     */
+    bool has(const std::string& symbol) const;
+
+    /**
+     * @brief Binds a native method to the definition with the given name (typically an extern def).
+     * Natives should be linked before the first call to #get or #call, since this
+     * is when the definitions of the program are created. Has no effect if the
+     * program does not refer to the definition.
+     */
+    VirtualMachine& link(const std::string& symbol, vm::NativeMethod native);
+
+    /**
+     * @return The value of the definition with the given name
+     */
+    vm::Value get(const std::string& symbol);
+
+    /**
+     * @brief Calls the definition with the given name as a function, e.g.
+     * `vm.call("$ENTRY_POINT$")` or `vm.call("example.f:(sfsl.lang.int)->sfsl.lang.int", {vm::Value::Int(2)})`.
+     * Values returned to the caller stay valid until the next call to the virtual machine.
+     */
+    vm::Value call(const std::string& symbol, const std::vector<vm::Value>& args = {});
+
+    vm::RuntimeCtx& getContext();
+
+    /**
+     * @brief Writes the program executed by this virtual machine to a module file,
+     * which can later be loaded with #load without going through the compiler again.
+     * @param path The path of the module file to create
+     */
+    void save(const std::string& path) const;
+
+    /**
+     * @brief Creates a virtual machine executing the program contained in the given module file.
+     * The file is memory mapped, and must have been written by #save on a compatible platform.
+     * @param path The path of the module file
+     * @return The virtual machine
+     */
+    static VirtualMachine load(const std::string& path);
+
+    /**
+     * @brief Prints the content of the program (constants, classes, methods and code)
+     * in a human readable form
+     */
+    void dump(std::ostream& o) const;
+
+private:
+    friend class VMCollector;
+
+    VirtualMachine(PRIVATE_IMPL_PTR(VirtualMachine) impl);
+
+    PRIVATE_IMPL_PTR(VirtualMachine) _impl;
+};
+
+}
+
+#endif
@@ -359,6 +359,7 @@ bool AST2BAST::isVisibleDef(T* def) const {
 template<typename BAST_NODE, typename DEF, typename... BAST_ARGS_REST>
 void AST2BAST::addDefinitionToProgram(DEF* def, BAST_ARGS_REST... args) {
     BAST_NODE* node = make<BAST_NODE>(getDefId(def), std::forward<BAST_ARGS_REST>(args)...);
+    node->setPos(*def);
     if (isVisibleDef(def)) {
         _visibleDefs.push_back(node);
     } else {
@@ -391,6 +392,9 @@ BASTNode* AST2BAST::makeBad() {
 
 Expression* AST2BAST::transform(ast::Expression* node) {
     node->onVisit(this);
+    if (_created) {
+        _created->setPos(*node);
+    }
     return static_cast<Expression*>(_created);
 }
 
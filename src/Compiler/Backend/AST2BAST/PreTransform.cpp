@@ -148,7 +148,7 @@ struct InitializerBuilder final {
         : _clss(clss), _ctx(ctx), _mngr(_ctx->memoryManager()) { }
 
     void addInitializationOf(Identifier* field) {
-        Identifier* arg = _mngr.New<Identifier>(field->getValue() + "$arg");
+        Identifier* arg = _mngr.New<Identifier>(_ctx->names().intern(field->getValue() + "$arg"));
         sym::VariableSymbol* argSym = _mngr.New<sym::VariableSymbol>(arg->getValue(), "");
         arg->setSymbol(argSym);
 
@@ -163,16 +163,16 @@ struct InitializerBuilder final {
 
         _body.push_back(_mngr.New<This>());
 
-        std::string name = _clss->getName() + "$init";
+        common::Name name = _ctx->names().intern(_clss->getName() + "$init");
 
         FunctionCreation* func = _mngr.New<FunctionCreation>(
                     name, nullptr, _mngr.New<Tuple>(_params), _mngr.New<Block>(_body));
 
-        func->setType(_mngr.New<type::MethodType>(
+        func->setType(type::MethodType::create(
                           _clss,
                           std::vector<TypeExpression*>(),
                           std::vector<type::Type*>(),
-                          nullptr, type::Environment::Empty));
+                          nullptr, type::Environment::Empty, _ctx));
 
         Identifier* initIdent = _mngr.New<Identifier>(name);
         DefineDecl* initDef = _mngr.New<DefineDecl>(initIdent, nullptr, func, DefFlags::NONE);
@@ -234,7 +234,7 @@ struct ClassPatcher final {
         _fieldCaptures[id] = id->getSymbol();
     }
 
-    Change addNewField(const std::string& name) {
+    Change addNewField(common::Name name) {
         // Make new field
         Identifier* newField = _mngr.New<Identifier>(name);
         sym::VariableSymbol* newFieldSym = _mngr.New<sym::VariableSymbol>(name, "");
@@ -322,24 +322,22 @@ void PreTransformAnalysis::visit(ClassDecl* clss) {
 
     if (!thisClassSymbol) {
         // Create the `this` class symbol
-        thisClassSymbol = _mngr.New<sym::VariableSymbol>(parentMost->getName() + ".this", "");
+        thisClassSymbol = _mngr.New<sym::VariableSymbol>(_ctx->names().intern(parentMost->getName() + ".this"), "");
         setVariableInfo(thisClassSymbol, _mngr.New<ThisInfo>());
     }
 
     // Assign the FieldInfo to every field of the class
-    for (const auto& pair : clss->getScope()->getAllSymbols()) {
-        if (sym::Symbol* s = pair.second.symbol) {
-            if (!getVariableInfo(s)) {
-                // If not a static member, assign it a FieldInfo
-                if (!(sym::getIfSymbolOfType<sym::TypeSymbol>(s) ||
-                       (sym::getIfSymbolOfType<sym::DefinitionSymbol>(s) &&
-                        sym::getIfSymbolOfType<sym::DefinitionSymbol>(s)->getDef()->isStatic())
-                    )) {
-                    setVariableInfo(s, _mngr.New<FieldInfo>(thisClassSymbol));
-                }
+    clss->getScope()->getAllSymbols().forEachSymbol([this, thisClassSymbol](common::Name, sym::Symbol* s) {
+        if (s && !getVariableInfo(s)) {
+            // If not a static member, assign it a FieldInfo
+            if (!(sym::getIfSymbolOfType<sym::TypeSymbol>(s) ||
+                   (sym::getIfSymbolOfType<sym::DefinitionSymbol>(s) &&
+                    sym::getIfSymbolOfType<sym::DefinitionSymbol>(s)->getDef()->isStatic())
+                )) {
+                setVariableInfo(s, _mngr.New<FieldInfo>(thisClassSymbol));
             }
         }
-    }
+    });
 
     // Visit the trees
     visitClassDecl(clss);
@@ -447,8 +445,9 @@ PreTransformImplementation::PreTransformImplementation(
             (_boxType = type::getIf<type::TypeConstructorType>(res.Box())))
     {
         if (type::ProperType* pt = boxOf(res.Int() /*for example, not important*/)) {
-            if ((_boxValueFieldSym = pt->getClass()->getScope()->getSymbol<sym::VariableSymbol>("value", false))) {
-                _boxValueFieldIdent = _mngr.New<Identifier>("value");
+            common::Name value = _ctx->names().intern("value");
+            if ((_boxValueFieldSym = pt->getClass()->getScope()->getSymbol<sym::VariableSymbol>(value, false))) {
+                _boxValueFieldIdent = _mngr.New<Identifier>(value);
                 _boxValueFieldIdent->setSymbol(_boxValueFieldSym);
             } else {
                 _ctx->reporter().fatal(*pt->getClass(), "Class Box should contain a field `value`, but it does not");
@@ -613,7 +612,7 @@ bool PreTransformImplementation::isClassThis(sym::Symbol* symbol) const {
 
 Expression* PreTransformImplementation::makeBoxInstantiationOf(type::Type* tp) {
     type::ProperType* boxOfT = boxOf(tp);
-    TypeIdentifier* tid = make<TypeIdentifier>("Box");
+    TypeIdentifier* tid = make<TypeIdentifier>(_ctx->names().intern("Box"));
     tid->setSymbol(_boxSymbol);
     Instantiation* inst = make<Instantiation>(tid);
     inst->setType(boxOfT);
@@ -14,6 +14,7 @@
 
 #include <iostream>
 #include "../../../Common/MemoryManageable.h"
+#include "../../../Common/Positionnable.h"
 
 namespace sfsl {
 
@@ -25,9 +26,11 @@ class BASTVisitor;
  * @brief An abstract class that represents a node of the Backend Abstract Syntax Tree.
  * This class must be extended by every Backend AST node.
  */
-class BASTNode : public common::MemoryManageable {
+class BASTNode : public common::MemoryManageable, public common::Positionnable {
 public:
 
+    static const common::MEMORY_CATEGORY MemoryCategory = common::MEM_BAST;
+
     /**
      * @brief Destroys the ASTNode
      */
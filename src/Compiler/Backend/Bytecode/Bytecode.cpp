@@ -7,6 +7,7 @@
 //
 
 #include "Bytecode.h"
+#include "BytecodeBuffer.h"
 #include "../../../Utils/Utils.h"
 
 #define ARG_SEP "\t\t"
@@ -38,14 +39,32 @@ MakeClass::~MakeClass() {
 
 }
 
+size_t MakeClass::getAttrCount() const {
+    return _attrCount;
+}
+
+size_t MakeClass::getDefCount() const {
+    return _defCount;
+}
+
+OP_CODE MakeClass::getOpCode() const {
+    return OP_MAKE_CLASS;
+}
+
 void MakeClass::appendTo(std::ostream& o) const {
     o << "mk_class" << ARG_SEP << _attrCount << ARG_SEP << _defCount;
 }
 
+void MakeClass::encode(BytecodeBuffer& out) const {
+    out.emit(OP_MAKE_CLASS, *this);
+    out.writeUInt(_attrCount);
+    out.writeUInt(_defCount);
+}
+
 // MAKE FUNCTION
 
 
-MakeMethod::MakeMethod(size_t varCount, Label* end) : _varCount(varCount), _end(end) {
+MakeMethod::MakeMethod(size_t varCount, Label* entry) : _varCount(varCount), _entry(entry) {
 
 }
 
@@ -53,8 +72,26 @@ MakeMethod::~MakeMethod() {
 
 }
 
+size_t MakeMethod::getVarCount() const {
+    return _varCount;
+}
+
+Label* MakeMethod::getEntryLabel() const {
+    return _entry;
+}
+
+OP_CODE MakeMethod::getOpCode() const {
+    return OP_MAKE_METHOD;
+}
+
 void MakeMethod::appendTo(std::ostream& o) const {
-    o << "mk_mthd" << ARG_SEP << _varCount << ARG_SEP << _end->getName();
+    o << "mk_mthd" << ARG_SEP << _varCount << ARG_SEP << _entry->getName();
+}
+
+void MakeMethod::encode(BytecodeBuffer& out) const {
+    out.emit(OP_MAKE_METHOD, *this);
+    out.writeUInt(_varCount);
+    out.writeLabel(_entry);
 }
 
 // STORE CONSTANT
@@ -67,10 +104,23 @@ StoreConst::~StoreConst() {
 
 }
 
+size_t StoreConst::getIndex() const {
+    return _index;
+}
+
+OP_CODE StoreConst::getOpCode() const {
+    return OP_STORE_CONST;
+}
+
 void StoreConst::appendTo(std::ostream& o) const {
     o << "store_cst" << ARG_SEP << _index;
 }
 
+void StoreConst::encode(BytecodeBuffer& out) const {
+    out.emit(OP_STORE_CONST, *this);
+    out.writeUInt(_index);
+}
+
 // LOAD CONSTANT
 
 LoadConst::LoadConst(size_t index) : _index(index) {
@@ -81,10 +131,23 @@ LoadConst::~LoadConst() {
 
 }
 
+size_t LoadConst::getIndex() const {
+    return _index;
+}
+
+OP_CODE LoadConst::getOpCode() const {
+    return OP_LOAD_CONST;
+}
+
 void LoadConst::appendTo(std::ostream &o) const {
     o << "load_cst" << ARG_SEP << _index;
 }
 
+void LoadConst::encode(BytecodeBuffer& out) const {
+    out.emit(OP_LOAD_CONST, *this);
+    out.writeUInt(_index);
+}
+
 // INSTANTIATE
 
 Instantiate::Instantiate() {
@@ -95,10 +158,18 @@ Instantiate::~Instantiate() {
 
 }
 
+OP_CODE Instantiate::getOpCode() const {
+    return OP_INSTANTIATE;
+}
+
 void Instantiate::appendTo(std::ostream& o) const {
     o << "inst_class";
 }
 
+void Instantiate::encode(BytecodeBuffer& out) const {
+    out.emit(OP_INSTANTIATE, *this);
+}
+
 // PUSH CONSTANT UNIT
 
 PushConstUnit::PushConstUnit() {
@@ -109,10 +180,18 @@ PushConstUnit::~PushConstUnit() {
 
 }
 
+OP_CODE PushConstUnit::getOpCode() const {
+    return OP_PUSH_UNIT;
+}
+
 void PushConstUnit::appendTo(std::ostream &o) const {
     o << "push_u";
 }
 
+void PushConstUnit::encode(BytecodeBuffer& out) const {
+    out.emit(OP_PUSH_UNIT, *this);
+}
+
 // PUSH CONSTANT BOOLEAN
 
 PushConstBool::PushConstBool(sfsl_bool_t val) : _val(val) {
@@ -123,10 +202,23 @@ PushConstBool::~PushConstBool() {
 
 }
 
+sfsl_bool_t PushConstBool::getValue() const {
+    return _val;
+}
+
+OP_CODE PushConstBool::getOpCode() const {
+    return OP_PUSH_BOOL;
+}
+
 void PushConstBool::appendTo(std::ostream& o) const {
     o << "push_b" << ARG_SEP << (_val ? 1 : 0);
 }
 
+void PushConstBool::encode(BytecodeBuffer& out) const {
+    out.emit(OP_PUSH_BOOL, *this);
+    out.writeUInt(_val ? 1 : 0);
+}
+
 // PUSH CONSTANT INTEGER
 
 PushConstInt::PushConstInt(sfsl_int_t val) : _val(val) {
@@ -137,10 +229,23 @@ PushConstInt::~PushConstInt() {
 
 }
 
+sfsl_int_t PushConstInt::getValue() const {
+    return _val;
+}
+
+OP_CODE PushConstInt::getOpCode() const {
+    return OP_PUSH_INT;
+}
+
 void PushConstInt::appendTo(std::ostream& o) const {
     o << "push_i" << ARG_SEP << _val;
 }
 
+void PushConstInt::encode(BytecodeBuffer& out) const {
+    out.emit(OP_PUSH_INT, *this);
+    out.writeInt(_val);
+}
+
 // PUSH CONSTANT REAL
 
 PushConstReal::PushConstReal(sfsl_real_t val) : _val(val) {
@@ -151,10 +256,50 @@ PushConstReal::~PushConstReal() {
 
 }
 
+sfsl_real_t PushConstReal::getValue() const {
+    return _val;
+}
+
+OP_CODE PushConstReal::getOpCode() const {
+    return OP_PUSH_REAL;
+}
+
 void PushConstReal::appendTo(std::ostream& o) const {
     o << "push_r" << ARG_SEP << _val;
 }
 
+void PushConstReal::encode(BytecodeBuffer& out) const {
+    out.emit(OP_PUSH_REAL, *this);
+    out.writeReal(_val);
+}
+
+// PUSH CONSTANT STRING
+
+PushConstString::PushConstString(const std::string& val) : _val(val) {
+
+}
+
+PushConstString::~PushConstString() {
+
+}
+
+const std::string& PushConstString::getValue() const {
+    return _val;
+}
+
+OP_CODE PushConstString::getOpCode() const {
+    return OP_PUSH_STRING;
+}
+
+void PushConstString::appendTo(std::ostream& o) const {
+    o << "push_s" << ARG_SEP << "\"" << _val << "\"";
+}
+
+void PushConstString::encode(BytecodeBuffer& out) const {
+    out.emit(OP_PUSH_STRING, *this);
+    out.writeString(_val);
+}
+
 // LOAD STACK
 
 LoadStack::LoadStack(size_t index) : _index(index) {
@@ -165,10 +310,23 @@ LoadStack::~LoadStack() {
 
 }
 
+size_t LoadStack::getIndex() const {
+    return _index;
+}
+
+OP_CODE LoadStack::getOpCode() const {
+    return OP_LOAD_STACK;
+}
+
 void LoadStack::appendTo(std::ostream& o) const {
     o << "load" << ARG_SEP << _index;
 }
 
+void LoadStack::encode(BytecodeBuffer& out) const {
+    out.emit(OP_LOAD_STACK, *this);
+    out.writeUInt(_index);
+}
+
 // STORE STACK
 
 StoreStack::StoreStack(size_t index) : _index(index) {
@@ -179,10 +337,23 @@ StoreStack::~StoreStack() {
 
 }
 
+size_t StoreStack::getIndex() const {
+    return _index;
+}
+
+OP_CODE StoreStack::getOpCode() const {
+    return OP_STORE_STACK;
+}
+
 void StoreStack::appendTo(std::ostream& o) const {
     o << "store" << ARG_SEP << _index;
 }
 
+void StoreStack::encode(BytecodeBuffer& out) const {
+    out.emit(OP_STORE_STACK, *this);
+    out.writeUInt(_index);
+}
+
 // LOAD FIELD
 
 
@@ -194,10 +365,23 @@ LoadField::~LoadField() {
 
 }
 
+size_t LoadField::getIndex() const {
+    return _index;
+}
+
+OP_CODE LoadField::getOpCode() const {
+    return OP_LOAD_FIELD;
+}
+
 void LoadField::appendTo(std::ostream& o) const {
     o << "ld_field" << ARG_SEP << _index;
 }
 
+void LoadField::encode(BytecodeBuffer& out) const {
+    out.emit(OP_LOAD_FIELD, *this);
+    out.writeUInt(_index);
+}
+
 // STORE FIELD
 
 StoreField::StoreField(size_t index) : _index(index) {
@@ -208,10 +392,23 @@ StoreField::~StoreField() {
 
 }
 
+size_t StoreField::getIndex() const {
+    return _index;
+}
+
+OP_CODE StoreField::getOpCode() const {
+    return OP_STORE_FIELD;
+}
+
 void StoreField::appendTo(std::ostream& o) const {
     o << "st_field" << ARG_SEP << _index;
 }
 
+void StoreField::encode(BytecodeBuffer& out) const {
+    out.emit(OP_STORE_FIELD, *this);
+    out.writeUInt(_index);
+}
+
 // POP
 
 Pop::Pop() {
@@ -222,10 +419,18 @@ Pop::~Pop() {
 
 }
 
+OP_CODE Pop::getOpCode() const {
+    return OP_POP;
+}
+
 void Pop::appendTo(std::ostream& o) const {
     o << "pop";
 }
 
+void Pop::encode(BytecodeBuffer& out) const {
+    out.emit(OP_POP, *this);
+}
+
 // DUPLICATE
 
 Dup::Dup() {
@@ -236,10 +441,18 @@ Dup::~Dup() {
 
 }
 
+OP_CODE Dup::getOpCode() const {
+    return OP_DUP;
+}
+
 void Dup::appendTo(std::ostream& o) const {
     o << "dup";
 }
 
+void Dup::encode(BytecodeBuffer& out) const {
+    out.emit(OP_DUP, *this);
+}
+
 // RETURN
 
 Return::Return() {
@@ -250,10 +463,18 @@ Return::~Return() {
 
 }
 
+OP_CODE Return::getOpCode() const {
+    return OP_RETURN;
+}
+
 void Return::appendTo(std::ostream& o) const {
     o << "ret";
 }
 
+void Return::encode(BytecodeBuffer& out) const {
+    out.emit(OP_RETURN, *this);
+}
+
 // LABEL
 
 Label::Label(const std::string& name) : _name(name) {
@@ -268,10 +489,48 @@ const std::string& Label::getName() const {
     return _name;
 }
 
+OP_CODE Label::getOpCode() const {
+    return OP_LABEL;
+}
+
 void Label::appendTo(std::ostream &o) const {
     o << _name << ":";
 }
 
+void Label::encode(BytecodeBuffer& out) const {
+    out.bindLabel(this);
+}
+
+// NAME CONSTANT
+
+NameConst::NameConst(size_t index, const std::string& name) : _index(index), _name(name) {
+
+}
+
+NameConst::~NameConst() {
+
+}
+
+size_t NameConst::getIndex() const {
+    return _index;
+}
+
+const std::string& NameConst::getName() const {
+    return _name;
+}
+
+OP_CODE NameConst::getOpCode() const {
+    return OP_NAME_CONST;
+}
+
+void NameConst::appendTo(std::ostream& o) const {
+    o << "name_cst" << ARG_SEP << _index << ARG_SEP << _name;
+}
+
+void NameConst::encode(BytecodeBuffer& out) const {
+    out.nameConst(_index, _name);
+}
+
 // IF FALSE
 
 
@@ -283,10 +542,23 @@ IfFalse::~IfFalse() {
 
 }
 
+Label* IfFalse::getLabel() const {
+    return _label;
+}
+
+OP_CODE IfFalse::getOpCode() const {
+    return OP_IF_FALSE;
+}
+
 void IfFalse::appendTo(std::ostream &o) const {
     o << "if_false" << ARG_SEP << _label->getName();
 }
 
+void IfFalse::encode(BytecodeBuffer& out) const {
+    out.emit(OP_IF_FALSE, *this);
+    out.writeLabel(_label);
+}
+
 // JUMP
 
 Jump::Jump(Label *label) : _label(label) {
@@ -297,10 +569,23 @@ Jump::~Jump() {
 
 }
 
+Label* Jump::getLabel() const {
+    return _label;
+}
+
+OP_CODE Jump::getOpCode() const {
+    return OP_JUMP;
+}
+
 void Jump::appendTo(std::ostream &o) const {
     o << "jump" << ARG_SEP << _label->getName();
 }
 
+void Jump::encode(BytecodeBuffer& out) const {
+    out.emit(OP_JUMP, *this);
+    out.writeLabel(_label);
+}
+
 // VIRTUAL CALL
 
 VCall::VCall(size_t methodIndex, size_t argCount) : _methodIndex(methodIndex), _argCount(argCount) {
@@ -311,10 +596,28 @@ VCall::~VCall() {
 
 }
 
+size_t VCall::getMethodIndex() const {
+    return _methodIndex;
+}
+
+size_t VCall::getArgCount() const {
+    return _argCount;
+}
+
+OP_CODE VCall::getOpCode() const {
+    return OP_VCALL;
+}
+
 void VCall::appendTo(std::ostream& o) const {
     o << "vcall" << ARG_SEP << _methodIndex << ARG_SEP << _argCount;
 }
 
+void VCall::encode(BytecodeBuffer& out) const {
+    out.emit(OP_VCALL, *this);
+    out.writeUInt(_methodIndex);
+    out.writeUInt(_argCount);
+}
+
 }
 
 }
@@ -17,14 +17,36 @@ namespace sfsl {
 
 namespace bc {
 
+class BytecodeBuffer;
+
+/**
+ * @brief Enumerates the opcodes of the sfsl bytecode.
+ * The stack effect of each instruction is documented on its class.
+ */
+enum OP_CODE {
+    OP_LABEL, OP_NAME_CONST, OP_MAKE_CLASS, OP_MAKE_METHOD, OP_STORE_CONST, OP_LOAD_CONST, OP_INSTANTIATE,
+    OP_PUSH_UNIT, OP_PUSH_BOOL, OP_PUSH_INT, OP_PUSH_REAL, OP_PUSH_STRING,
+    OP_LOAD_STACK, OP_STORE_STACK, OP_LOAD_FIELD, OP_STORE_FIELD,
+    OP_POP, OP_DUP, OP_RETURN, OP_IF_FALSE, OP_JUMP, OP_VCALL,
+
+    OP_COUNT
+};
+
 /**
  * @brief Represents an abstract bytecode instruction
  */
 class BCInstruction : public common::MemoryManageable, public common::Positionnable {
 public:
 
+    static const common::MEMORY_CATEGORY MemoryCategory = common::MEM_BYTECODE;
+
     virtual ~BCInstruction();
 
+    /**
+     * @return The opcode of the instruction
+     */
+    virtual OP_CODE getOpCode() const = 0;
+
     /**
      * @brief Appends a string representation of the bytecode instruction
      * to the given output stream
@@ -32,6 +54,12 @@ public:
      */
     virtual void appendTo(std::ostream& o) const = 0;
 
+    /**
+     * @brief Appends the compact encoding of the instruction to the given buffer
+     * @param out The buffer to fill
+     */
+    virtual void encode(BytecodeBuffer& out) const = 0;
+
     /**
      * @return a string representation of the token with details
      */
@@ -47,6 +75,9 @@ inline std::ostream& operator <<(std::ostream& o, const BCInstruction& i) {
  *  BYTECODE INSTRUCTIONS
  */
 
+/**
+ * @brief Pseudo instruction marking a position in the code. Does not touch the stack.
+ */
 class Label : public BCInstruction {
 public:
     Label(const std::string& name);
@@ -54,19 +85,52 @@ public:
 
     const std::string& getName() const;
 
+    virtual OP_CODE getOpCode() const override;
     virtual void appendTo(std::ostream &o) const override;
+    virtual void encode(BytecodeBuffer& out) const override;
+
+private:
+
+    std::string _name;
+};
+
+/**
+ * @brief Pseudo instruction binding a symbolic name to a slot of the constant pool,
+ * so that the slot can be found (and linked) by name at runtime. Does not touch the stack.
+ */
+class NameConst : public BCInstruction {
+public:
+    NameConst(size_t index, const std::string& name);
+    virtual ~NameConst();
+
+    size_t getIndex() const;
+    const std::string& getName() const;
+
+    virtual OP_CODE getOpCode() const override;
+    virtual void appendTo(std::ostream& o) const override;
+    virtual void encode(BytecodeBuffer& out) const override;
 
 private:
 
+    size_t _index;
     std::string _name;
 };
 
+/**
+ * @brief Pops `defCount` methods and pushes a class whose instances have `attrCount` fields
+ * and whose virtual table contains the popped methods (in the order they were pushed).
+ */
 class MakeClass : public BCInstruction {
 public:
     MakeClass(size_t attrCount, size_t defCount);
     virtual ~MakeClass();
 
+    size_t getAttrCount() const;
+    size_t getDefCount() const;
+
+    virtual OP_CODE getOpCode() const override;
     virtual void appendTo(std::ostream &o) const override;
+    virtual void encode(BytecodeBuffer& out) const override;
 
 private:
 
@@ -74,197 +138,340 @@ private:
     size_t _defCount;
 };
 
+/**
+ * @brief Pushes a method whose code starts at `entry`.
+ * The frame of the method has `varCount` local slots (`this` and the arguments included).
+ */
 class MakeMethod : public BCInstruction {
 public:
-    MakeMethod(size_t varCount, Label* end);
+    MakeMethod(size_t varCount, Label* entry);
     virtual ~MakeMethod();
 
+    size_t getVarCount() const;
+    Label* getEntryLabel() const;
+
+    virtual OP_CODE getOpCode() const override;
     virtual void appendTo(std::ostream& o) const override;
+    virtual void encode(BytecodeBuffer& out) const override;
 
 private:
 
     size_t _varCount;
-    Label* _end;
+    Label* _entry;
 };
 
+/**
+ * @brief Pops a value and stores it in the slot `index` of the constant pool.
+ */
 class StoreConst : public BCInstruction {
 public:
     StoreConst(size_t index);
     virtual ~StoreConst();
 
+    size_t getIndex() const;
+
+    virtual OP_CODE getOpCode() const override;
     virtual void appendTo(std::ostream &o) const override;
+    virtual void encode(BytecodeBuffer& out) const override;
 
 private:
 
     size_t _index;
 };
 
+/**
+ * @brief Pushes the value stored in the slot `index` of the constant pool.
+ */
 class LoadConst : public BCInstruction {
 public:
     LoadConst(size_t index);
     virtual ~LoadConst();
 
+    size_t getIndex() const;
+
+    virtual OP_CODE getOpCode() const override;
     virtual void appendTo(std::ostream &o) const override;
+    virtual void encode(BytecodeBuffer& out) const override;
 
 private:
 
     size_t _index;
 };
 
+/**
+ * @brief Pops a class and pushes a new instance of it, with all its fields set to unit.
+ */
 class Instantiate : public BCInstruction {
 public:
     Instantiate();
     virtual ~Instantiate();
 
+    virtual OP_CODE getOpCode() const override;
     virtual void appendTo(std::ostream &o) const override;
+    virtual void encode(BytecodeBuffer& out) const override;
 };
 
+/**
+ * @brief Pushes the unit value.
+ */
 class PushConstUnit : public BCInstruction {
 public:
     PushConstUnit();
     virtual ~PushConstUnit();
 
+    virtual OP_CODE getOpCode() const override;
     virtual void appendTo(std::ostream &o) const override;
+    virtual void encode(BytecodeBuffer& out) const override;
 };
 
+/**
+ * @brief Pushes a boolean constant.
+ */
 class PushConstBool : public BCInstruction {
 public:
     PushConstBool(sfsl_bool_t val);
     virtual ~PushConstBool();
 
+    sfsl_bool_t getValue() const;
+
+    virtual OP_CODE getOpCode() const override;
     virtual void appendTo(std::ostream &o) const override;
+    virtual void encode(BytecodeBuffer& out) const override;
 
 private:
 
     sfsl_bool_t _val;
 };
 
+/**
+ * @brief Pushes an integer constant.
+ */
 class PushConstInt : public BCInstruction {
 public:
     PushConstInt(sfsl_int_t val);
     virtual ~PushConstInt();
 
+    sfsl_int_t getValue() const;
+
+    virtual OP_CODE getOpCode() const override;
     virtual void appendTo(std::ostream& o) const override;
+    virtual void encode(BytecodeBuffer& out) const override;
 
 private:
 
     sfsl_int_t _val;
 };
 
+/**
+ * @brief Pushes a real constant.
+ */
 class PushConstReal : public BCInstruction {
 public:
     PushConstReal(sfsl_real_t val);
     virtual ~PushConstReal();
 
+    sfsl_real_t getValue() const;
+
+    virtual OP_CODE getOpCode() const override;
     virtual void appendTo(std::ostream& o) const override;
+    virtual void encode(BytecodeBuffer& out) const override;
 
 private:
 
     sfsl_real_t _val;
 };
 
+/**
+ * @brief Pushes a string constant.
+ */
+class PushConstString : public BCInstruction {
+public:
+    PushConstString(const std::string& val);
+    virtual ~PushConstString();
+
+    const std::string& getValue() const;
+
+    virtual OP_CODE getOpCode() const override;
+    virtual void appendTo(std::ostream& o) const override;
+    virtual void encode(BytecodeBuffer& out) const override;
+
+private:
+
+    std::string _val;
+};
+
+/**
+ * @brief Pushes the local variable `index` of the current frame (0 is `this`).
+ */
 class LoadStack : public BCInstruction {
 public:
     LoadStack(size_t index);
     virtual ~LoadStack();
 
+    size_t getIndex() const;
+
+    virtual OP_CODE getOpCode() const override;
     virtual void appendTo(std::ostream &o) const override;
+    virtual void encode(BytecodeBuffer& out) const override;
 
 private:
 
     size_t _index;
 };
 
+/**
+ * @brief Stores the value on top of the stack in the local variable `index`,
+ * without popping it.
+ */
 class StoreStack : public BCInstruction {
 public:
     StoreStack(size_t index);
     virtual ~StoreStack();
 
+    size_t getIndex() const;
+
+    virtual OP_CODE getOpCode() const override;
     virtual void appendTo(std::ostream &o) const override;
+    virtual void encode(BytecodeBuffer& out) const override;
 
 private:
 
     size_t _index;
 };
 
+/**
+ * @brief Pops an object and pushes the value of its field `index`.
+ */
 class LoadField : public BCInstruction {
 public:
     LoadField(size_t index);
     virtual ~LoadField();
 
+    size_t getIndex() const;
+
+    virtual OP_CODE getOpCode() const override;
     virtual void appendTo(std::ostream &o) const override;
+    virtual void encode(BytecodeBuffer& out) const override;
 
 private:
 
     size_t _index;
 };
 
+/**
+ * @brief Pops a value and an object, stores the value in the field `index`
+ * of the object and pushes the value back.
+ */
 class StoreField : public BCInstruction {
 public:
     StoreField(size_t index);
     virtual ~StoreField();
 
+    size_t getIndex() const;
+
+    virtual OP_CODE getOpCode() const override;
     virtual void appendTo(std::ostream &o) const override;
+    virtual void encode(BytecodeBuffer& out) const override;
 
 private:
 
     size_t _index;
 };
 
+/**
+ * @brief Pops the value on top of the stack.
+ */
 class Pop : public BCInstruction {
 public:
     Pop();
     virtual ~Pop();
 
+    virtual OP_CODE getOpCode() const override;
     virtual void appendTo(std::ostream &o) const override;
+    virtual void encode(BytecodeBuffer& out) const override;
 };
 
+/**
+ * @brief Duplicates the value on top of the stack.
+ */
 class Dup : public BCInstruction {
 public:
     Dup();
     virtual ~Dup();
 
+    virtual OP_CODE getOpCode() const override;
     virtual void appendTo(std::ostream &o) const override;
+    virtual void encode(BytecodeBuffer& out) const override;
 };
 
+/**
+ * @brief Pops the result, leaves the current frame and pushes the result
+ * in place of the callee and its arguments.
+ */
 class Return : public BCInstruction {
 public:
     Return();
     virtual ~Return();
 
+    virtual OP_CODE getOpCode() const override;
     virtual void appendTo(std::ostream &o) const override;
+    virtual void encode(BytecodeBuffer& out) const override;
 };
 
+/**
+ * @brief Pops a boolean, and jumps to `label` if it is false.
+ */
 class IfFalse : public BCInstruction {
 public:
     IfFalse(Label* label);
     virtual ~IfFalse();
 
+    Label* getLabel() const;
+
+    virtual OP_CODE getOpCode() const override;
     virtual void appendTo(std::ostream &o) const override;
+    virtual void encode(BytecodeBuffer& out) const override;
 
 private:
 
     Label* _label;
 };
 
+/**
+ * @brief Unconditionally jumps to `label`.
+ */
 class Jump : public BCInstruction {
 public:
     Jump(Label* label);
     virtual ~Jump();
 
+    Label* getLabel() const;
+
+    virtual OP_CODE getOpCode() const override;
     virtual void appendTo(std::ostream &o) const override;
+    virtual void encode(BytecodeBuffer& out) const override;
 
 private:
 
     Label* _label;
 };
 
+/**
+ * @brief Calls the method at index `methodIndex` of the virtual table of the callee.
+ * Expects the callee followed by `argCount` arguments on the stack, which become
+ * the first locals of the new frame.
+ */
 class VCall : public BCInstruction {
 public:
     VCall(size_t methodIndex, size_t argCount);
     virtual ~VCall();
 
+    size_t getMethodIndex() const;
+    size_t getArgCount() const;
+
+    virtual OP_CODE getOpCode() const override;
     virtual void appendTo(std::ostream &o) const override;
+    virtual void encode(BytecodeBuffer& out) const override;
 
 private:
 
@@ -0,0 +1,390 @@
+//
+//  BytecodeBuffer.cpp
+//  SFSL
+//
+//  Created by Romain Beguet on 18.10.16.
+//  Copyright (c) 2016 Romain Beguet. All rights reserved.
+//
+
+#include <cstring>
+#include <algorithm>
+#include "BytecodeBuffer.h"
+#include "../../../Compiler/Common/Reporter.h"
+#include "../../../Compiler/Frontend/Lexer/InputSourceName.h"
+
+namespace sfsl {
+
+namespace bc {
+
+static const size_t NO_POSITION = (size_t)-1;
+
+BytecodeBuffer::BytecodeBuffer() : _lastPositions(1, NO_POSITION), _finished(false) {
+
+}
+
+BytecodeBuffer::~BytecodeBuffer() {
+
+}
+
+void BytecodeBuffer::emit(OP_CODE op, const common::Positionnable& pos) {
+    checkWriting();
+
+    const std::string* sourceName = &pos.getSourceName().getName();
+    auto it = _sourceIndices.find(sourceName);
+    if (it == _sourceIndices.end()) {
+        it = _sourceIndices.insert(std::make_pair(sourceName, _sources.size())).first;
+        _sources.push_back(*sourceName);
+    }
+
+    out::Cursor here(_out.here());
+    size_t& last(_lastPositions[here.segment]);
+
+    if (last == NO_POSITION || _pendingPositions[last].source != it->second
+            || _pendingPositions[last].start != pos.getStartPosition()
+            || _pendingPositions[last].end != pos.getEndPosition()) {
+        last = _pendingPositions.size();
+        _pendingPositions.push_back(PendingPosition{here, it->second, pos.getStartPosition(), pos.getEndPosition()});
+    }
+
+    _out << (uint8_t)op;
+}
+
+void BytecodeBuffer::writeUInt(size_t val) {
+    uint8_t bytes[(sizeof(size_t) * 8 + 6) / 7];
+    size_t count = 0;
+    while (val >= 0x80) {
+        bytes[count++] = (uint8_t)(val | 0x80);
+        val >>= 7;
+    }
+    bytes[count++] = (uint8_t)val;
+    _out.write(bytes, count);
+}
+
+void BytecodeBuffer::writeInt(sfsl_int_t val) {
+    typedef std::make_unsigned<sfsl_int_t>::type usfsl_int_t;
+    writeUInt((size_t)(((usfsl_int_t)val << 1) ^ (usfsl_int_t)(val >> (sizeof(sfsl_int_t) * 8 - 1))));
+}
+
+void BytecodeBuffer::writeReal(sfsl_real_t val) {
+    uint8_t bytes[sizeof(sfsl_real_t)];
+    std::memcpy(bytes, &val, sizeof(sfsl_real_t));
+    _out.write(bytes, sizeof(sfsl_real_t));
+}
+
+void BytecodeBuffer::writeString(const std::string& str) {
+    auto it = _stringIndices.find(str);
+    if (it == _stringIndices.end()) {
+        it = _stringIndices.insert(std::make_pair(str, _strings.size())).first;
+        _strings.push_back(str);
+    }
+    writeUInt(it->second);
+}
+
+void BytecodeBuffer::writeLabel(const Label* label) {
+    static const uint8_t placeholder[4] = {0xFF, 0xFF, 0xFF, 0xFF};
+    _labelRefs.push_back(LabelRef{_out.here(), label});
+    _out.write(placeholder, 4);
+}
+
+void BytecodeBuffer::bindLabel(const Label* label) {
+    checkWriting();
+    _labels[label] = LabelState{_out.here(), true};
+}
+
+out::Cursor BytecodeBuffer::here() const {
+    return _out.here();
+}
+
+out::Cursor BytecodeBuffer::newSection() {
+    checkWriting();
+    _lastPositions.push_back(NO_POSITION);
+    return _out.newSegment();
+}
+
+void BytecodeBuffer::seek(out::Cursor cursor) {
+    _out.seek(cursor);
+}
+
+void BytecodeBuffer::finish() {
+    checkWriting();
+    _finished = true;
+
+    std::vector<size_t> offsets(_out.segmentOffsets());
+    if (offsets.back() >= UNBOUND_LABEL) {
+        throw common::CompilationFatalError("Bytecode is too large for its label references");
+    }
+
+    _code = _out.assemble();
+    _out = out::SegmentedOutput<uint8_t>();
+
+    auto absolute = [&](out::Cursor c) { return offsets[c.segment] + c.offset; };
+
+    for (const LabelRef& ref : _labelRefs) {
+        auto it = _labels.find(ref.label);
+        if (it != _labels.end() && it->second.bound) {
+            writeFixed32(absolute(ref.at), (uint32_t)absolute(it->second.pos));
+        }
+    }
+
+    std::stable_sort(_pendingPositions.begin(), _pendingPositions.end(),
+                     [](const PendingPosition& a, const PendingPosition& b) { return a.at.segment < b.at.segment; });
+
+    for (const PendingPosition& pos : _pendingPositions) {
+        if (_positions.empty() || _positions.back().source != pos.source
+                || _positions.back().start != pos.start || _positions.back().end != pos.end) {
+            _positions.push_back(PositionEntry{absolute(pos.at), pos.source, pos.start, pos.end});
+        }
+    }
+
+    _labelRefs.clear();
+    _pendingPositions.clear();
+}
+
+void BytecodeBuffer::nameConst(size_t index, const std::string& name) {
+    if (index >= _constNames.size()) {
+        _constNames.resize(index + 1);
+    }
+    _constNames[index] = name;
+}
+
+const std::vector<uint8_t>& BytecodeBuffer::getCode() const {
+    checkFinished();
+    return _code;
+}
+
+const std::vector<std::string>& BytecodeBuffer::getStrings() const {
+    return _strings;
+}
+
+const std::vector<std::string>& BytecodeBuffer::getConstNames() const {
+    return _constNames;
+}
+
+const std::vector<std::string>& BytecodeBuffer::getSources() const {
+    return _sources;
+}
+
+const std::vector<BytecodeBuffer::PositionEntry>& BytecodeBuffer::getPositions() const {
+    return _positions;
+}
+
+const BytecodeBuffer::PositionEntry* BytecodeBuffer::findPosition(size_t offset) const {
+    auto it = std::upper_bound(_positions.begin(), _positions.end(), offset,
+                               [](size_t off, const PositionEntry& entry) { return off < entry.offset; });
+
+    return it == _positions.begin() ? nullptr : &*(it - 1);
+}
+
+bool BytecodeBuffer::decode(size_t& offset, DecodedInstruction& instr) const {
+    checkFinished();
+
+    if (offset >= _code.size()) {
+        return false;
+    }
+
+    instr.offset = offset;
+    instr.opcode = (OP_CODE)_code[offset++];
+    instr.arg = 0;
+    instr.arg2 = 0;
+
+    switch (instr.opcode) {
+    case OP_MAKE_CLASS:
+    case OP_VCALL:
+        instr.arg = readUInt(offset);
+        instr.arg2 = readUInt(offset);
+        break;
+
+    case OP_MAKE_METHOD:
+        instr.arg = readUInt(offset);
+        instr.arg2 = readFixed32(offset);
+        break;
+
+    case OP_STORE_CONST:
+    case OP_LOAD_CONST:
+    case OP_LOAD_STACK:
+    case OP_STORE_STACK:
+    case OP_LOAD_FIELD:
+    case OP_STORE_FIELD:
+    case OP_PUSH_BOOL:
+    case OP_PUSH_STRING:
+        instr.arg = readUInt(offset);
+        break;
+
+    case OP_PUSH_INT: {
+        size_t zz = readUInt(offset);
+        instr.intValue = (sfsl_int_t)(zz >> 1) ^ -(sfsl_int_t)(zz & 1);
+        break;
+    }
+
+    case OP_PUSH_REAL:
+        if (offset + sizeof(sfsl_real_t) > _code.size()) {
+            throw common::CompilationFatalError("Invalid bytecode: truncated real operand");
+        }
+        std::memcpy(&instr.realValue, _code.data() + offset, sizeof(sfsl_real_t));
+        offset += sizeof(sfsl_real_t);
+        break;
+
+    case OP_IF_FALSE:
+    case OP_JUMP:
+        instr.arg = readFixed32(offset);
+        break;
+
+    case OP_INSTANTIATE:
+    case OP_PUSH_UNIT:
+    case OP_POP:
+    case OP_DUP:
+    case OP_RETURN:
+        break;
+
+    default:
+        throw common::CompilationFatalError("Invalid bytecode: unknown opcode " + utils::T_toString((int)instr.opcode));
+    }
+
+    return true;
+}
+
+std::vector<BCInstruction*> BytecodeBuffer::toInstructions(const CompCtx_Ptr& ctx) const {
+    common::AbstractMemoryManager& mngr(ctx->memoryManager());
+    std::vector<BCInstruction*> instrs;
+    std::map<size_t, Label*> labels;
+    std::vector<src::InputSourceName> sources;
+
+    for (const std::string& source : _sources) {
+        sources.push_back(src::InputSourceName::make(ctx, source));
+    }
+
+    auto setPos = [&](BCInstruction* instr, size_t offset) {
+        if (const PositionEntry* entry = findPosition(offset)) {
+            instr->setPos(entry->start, entry->end, sources[entry->source]);
+        }
+    };
+
+    auto labelAt = [&](size_t offset) {
+        Label*& label(labels[offset]);
+        if (!label) {
+            label = mngr.New<Label>("L" + utils::T_toString(offset));
+        }
+        return label;
+    };
+
+    for (size_t i = 0; i < _constNames.size(); ++i) {
+        instrs.push_back(mngr.New<NameConst>(i, _constNames[i]));
+    }
+
+    size_t offset = 0;
+    DecodedInstruction dec;
+
+    // create the labels first, so that they can be inserted when reaching their offset
+
+    while (decode(offset, dec)) {
+        if (dec.opcode == OP_MAKE_METHOD) {
+            labelAt(dec.arg2);
+        } else if (dec.opcode == OP_IF_FALSE || dec.opcode == OP_JUMP) {
+            labelAt(dec.arg);
+        }
+    }
+
+    auto nextLabel = labels.begin();
+    offset = 0;
+
+    while (decode(offset, dec)) {
+        for (; nextLabel != labels.end() && nextLabel->first <= dec.offset; ++nextLabel) {
+            setPos(nextLabel->second, dec.offset);
+            instrs.push_back(nextLabel->second);
+        }
+
+        BCInstruction* instr;
+
+        switch (dec.opcode) {
+        case OP_MAKE_CLASS:     instr = mngr.New<MakeClass>(dec.arg, dec.arg2); break;
+        case OP_MAKE_METHOD:    instr = mngr.New<MakeMethod>(dec.arg, labelAt(dec.arg2)); break;
+        case OP_STORE_CONST:    instr = mngr.New<StoreConst>(dec.arg); break;
+        case OP_LOAD_CONST:     instr = mngr.New<LoadConst>(dec.arg); break;
+        case OP_INSTANTIATE:    instr = mngr.New<Instantiate>(); break;
+        case OP_PUSH_UNIT:      instr = mngr.New<PushConstUnit>(); break;
+        case OP_PUSH_BOOL:      instr = mngr.New<PushConstBool>(dec.arg != 0); break;
+        case OP_PUSH_INT:       instr = mngr.New<PushConstInt>(dec.intValue); break;
+        case OP_PUSH_REAL:      instr = mngr.New<PushConstReal>(dec.realValue); break;
+        case OP_PUSH_STRING:    instr = mngr.New<PushConstString>(_strings.at(dec.arg)); break;
+        case OP_LOAD_STACK:     instr = mngr.New<LoadStack>(dec.arg); break;
+        case OP_STORE_STACK:    instr = mngr.New<StoreStack>(dec.arg); break;
+        case OP_LOAD_FIELD:     instr = mngr.New<LoadField>(dec.arg); break;
+        case OP_STORE_FIELD:    instr = mngr.New<StoreField>(dec.arg); break;
+        case OP_POP:            instr = mngr.New<Pop>(); break;
+        case OP_DUP:            instr = mngr.New<Dup>(); break;
+        case OP_RETURN:         instr = mngr.New<Return>(); break;
+        case OP_IF_FALSE:       instr = mngr.New<IfFalse>(labelAt(dec.arg)); break;
+        case OP_JUMP:           instr = mngr.New<Jump>(labelAt(dec.arg)); break;
+        case OP_VCALL:          instr = mngr.New<VCall>(dec.arg, dec.arg2); break;
+        default:                throw common::CompilationFatalError("Invalid bytecode: unexpected opcode");
+        }
+
+        setPos(instr, dec.offset);
+        instrs.push_back(instr);
+    }
+
+    for (; nextLabel != labels.end(); ++nextLabel) {
+        instrs.push_back(nextLabel->second);
+    }
+
+    return instrs;
+}
+
+void BytecodeBuffer::writeFixed32(size_t at, uint32_t val) {
+    _code[at]     = (uint8_t)(val);
+    _code[at + 1] = (uint8_t)(val >> 8);
+    _code[at + 2] = (uint8_t)(val >> 16);
+    _code[at + 3] = (uint8_t)(val >> 24);
+}
+
+size_t BytecodeBuffer::readUInt(size_t& offset) const {
+    static const size_t bitCount = sizeof(size_t) * 8;
+
+    size_t val = 0;
+    for (size_t shift = 0; offset < _code.size(); shift += 7) {
+        if (shift >= bitCount) {
+            throw common::CompilationFatalError("Invalid bytecode: operand too large");
+        }
+
+        uint8_t byte = _code[offset++];
+        size_t bits = (size_t)(byte & 0x7F);
+
+        if (shift + 7 > bitCount && (bits >> (bitCount - shift)) != 0) {
+            throw common::CompilationFatalError("Invalid bytecode: operand too large");
+        }
+
+        val |= bits << shift;
+        if (!(byte & 0x80)) {
+            return val;
+        }
+    }
+    throw common::CompilationFatalError("Invalid bytecode: truncated operand");
+}
+
+uint32_t BytecodeBuffer::readFixed32(size_t& offset) const {
+    if (offset + 4 > _code.size()) {
+        throw common::CompilationFatalError("Invalid bytecode: truncated label reference");
+    }
+    uint32_t val = (uint32_t)_code[offset]
+                 | ((uint32_t)_code[offset + 1] << 8)
+                 | ((uint32_t)_code[offset + 2] << 16)
+                 | ((uint32_t)_code[offset + 3] << 24);
+    offset += 4;
+    return val;
+}
+
+void BytecodeBuffer::checkWriting() const {
+    if (_finished) {
+        throw common::CompilationFatalError("Cannot write to a finished bytecode buffer");
+    }
+}
+
+void BytecodeBuffer::checkFinished() const {
+    if (!_finished) {
+        throw common::CompilationFatalError("Cannot read a bytecode buffer which is not finished");
+    }
+}
+
+}
+
+}
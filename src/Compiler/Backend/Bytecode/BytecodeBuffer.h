@@ -0,0 +1,215 @@
+//
+//  BytecodeBuffer.h
+//  SFSL
+//
+//  Created by Romain Beguet on 18.10.16.
+//  Copyright (c) 2016 Romain Beguet. All rights reserved.
+//
+
+#ifndef __SFSL__BytecodeBuffer__
+#define __SFSL__BytecodeBuffer__
+
+#include <iostream>
+#include <vector>
+#include <map>
+#include <unordered_map>
+#include <cstdint>
+#include "Bytecode.h"
+#include "../CodeGen/CodeGenOutput.h"
+#include "../../../Compiler/Common/CompilationContext.h"
+
+namespace sfsl {
+
+namespace bc {
+
+/**
+ * @brief A bytecode instruction decoded from a #sfsl::bc::BytecodeBuffer.
+ *
+ * Operands by opcode:
+ * - LOAD/STORE_CONST, LOAD/STORE_STACK, LOAD/STORE_FIELD: arg = index
+ * - MAKE_CLASS: arg = attribute count, arg2 = method count
+ * - MAKE_METHOD: arg = variable count, arg2 = offset of the entry label
+ * - PUSH_BOOL: arg = 0 or 1, PUSH_INT: intValue, PUSH_REAL: realValue, PUSH_STRING: arg = string index
+ * - IF_FALSE, JUMP: arg = offset of the target label
+ * - VCALL: arg = method index in the virtual table, arg2 = argument count
+ */
+struct DecodedInstruction final {
+    OP_CODE opcode;
+    size_t offset;
+    size_t arg;
+    union {
+        size_t arg2;
+        sfsl_int_t intValue;
+        sfsl_real_t realValue;
+    };
+};
+
+/**
+ * @brief Dense encoding of the bytecode, written directly by the bytecode generator.
+ *
+ * Each instruction is a one byte opcode followed by its operands, which are encoded as
+ * LEB128 varints (zigzag encoded for integer literals), except reals which are stored on
+ * their full width and label references which are 4 bytes wide so that they can be patched
+ * once the code is assembled. Labels and constant names are not part of the code stream:
+ * labels resolve to byte offsets and names are kept in a table indexed by constant slot.
+ * Source positions live in a side table which only gets an entry when the position changes.
+ *
+ * The code is written in sections (typically one for the initialization code and one per method
+ * body), which are concatenated by #finish in the order of their creation, at which point the
+ * label references are patched. The reading methods can only be used once the buffer is finished.
+ */
+class BytecodeBuffer final : public common::MemoryManageable {
+public:
+
+    static const common::MEMORY_CATEGORY MemoryCategory = common::MEM_BYTECODE;
+
+    /**
+     * @brief Maps the instructions starting at `offset` (up to the next entry)
+     * to a source position. `source` indexes #getSources.
+     */
+    struct PositionEntry final {
+        size_t offset;
+        size_t source;
+        size_t start;
+        size_t end;
+    };
+
+    BytecodeBuffer();
+    virtual ~BytecodeBuffer();
+
+    // writing
+
+    /**
+     * @brief Starts a new instruction
+     * @param op The opcode of the instruction
+     * @param pos The position of the instruction in the source
+     */
+    void emit(OP_CODE op, const common::Positionnable& pos);
+
+    void writeUInt(size_t val);
+    void writeInt(sfsl_int_t val);
+    void writeReal(sfsl_real_t val);
+    void writeString(const std::string& str);
+
+    /**
+     * @brief Writes a reference to the label, which will be patched once the code is assembled
+     */
+    void writeLabel(const Label* label);
+
+    /**
+     * @brief Binds the label to the current location
+     */
+    void bindLabel(const Label* label);
+
+    /**
+     * @return The current location in the code
+     */
+    out::Cursor here() const;
+
+    /**
+     * @brief Creates a new section, placed after all the existing ones
+     * @return The location of the beginning of the section
+     */
+    out::Cursor newSection();
+
+    /**
+     * @brief Sets the location at which the next instructions are written.
+     * Should be the end of a section.
+     */
+    void seek(out::Cursor cursor);
+
+    /**
+     * @brief Assembles the sections and patches the label references.
+     * Nothing can be written after this call.
+     */
+    void finish();
+
+    /**
+     * @brief Names the constant pool slot `index`
+     */
+    void nameConst(size_t index, const std::string& name);
+
+    // reading
+
+    const std::vector<uint8_t>& getCode() const;
+    const std::vector<std::string>& getStrings() const;
+    const std::vector<std::string>& getConstNames() const;
+    const std::vector<std::string>& getSources() const;
+    const std::vector<PositionEntry>& getPositions() const;
+
+    /**
+     * @return The position entry covering the given offset, or nullptr if there is none
+     */
+    const PositionEntry* findPosition(size_t offset) const;
+
+    /**
+     * @brief Decodes the instruction starting at `offset`
+     * @param offset The offset of the instruction, updated to the offset of the next one
+     * @param instr Filled with the decoded instruction
+     * @return False if there is no more instruction to decode
+     */
+    bool decode(size_t& offset, DecodedInstruction& instr) const;
+
+    /**
+     * @brief Recreates the object form of the bytecode, for inspection purposes.
+     * Constant names come first, and labels are created for every jump target.
+     *
+     * @param ctx The compilation context in which to allocate the instructions
+     * @return The list of instructions
+     */
+    std::vector<BCInstruction*> toInstructions(const CompCtx_Ptr& ctx) const;
+
+    static const uint32_t UNBOUND_LABEL = UINT32_MAX;
+
+private:
+
+    struct LabelState final {
+        out::Cursor pos;
+        bool bound;
+    };
+
+    struct LabelRef final {
+        out::Cursor at;
+        const Label* label;
+    };
+
+    struct PendingPosition final {
+        out::Cursor at;
+        size_t source;
+        size_t start;
+        size_t end;
+    };
+
+    void writeFixed32(size_t at, uint32_t val);
+
+    size_t readUInt(size_t& offset) const;
+    uint32_t readFixed32(size_t& offset) const;
+
+    void checkWriting() const;
+    void checkFinished() const;
+
+    out::SegmentedOutput<uint8_t> _out;
+    std::vector<LabelRef> _labelRefs;
+    std::vector<PendingPosition> _pendingPositions;
+    std::vector<size_t> _lastPositions;
+    bool _finished;
+
+    std::vector<uint8_t> _code;
+
+    std::vector<std::string> _strings;
+    std::map<std::string, size_t> _stringIndices;
+
+    std::vector<std::string> _constNames;
+
+    std::vector<std::string> _sources;
+    std::map<const std::string*, size_t> _sourceIndices;
+    std::vector<PositionEntry> _positions;
+
+    std::unordered_map<const Label*, LabelState> _labels;
+};
+
+}
+
+}
+
+#endif
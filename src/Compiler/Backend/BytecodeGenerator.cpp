@@ -7,22 +7,6 @@
 //
 
 #include "BytecodeGenerator.h"
-#include "../Frontend/AST/Visitors/ASTTypeIdentifier.h"
-#include "../Frontend/AST/Visitors/ASTSymbolExtractor.h"
-
-#define START_WRITING_TO_CONSTANT_POOL \
-    out::Cursor* __old = Here(); \
-    Seek(*_constantPoolCursor); \
-    bool __oldAlreadyCP = __old->equivalent(*_constantPoolCursor);
-
-#define RESTART_WRITING_TO_CONSTANT_POOL \
-    __old = Here(); \
-    Seek(*_constantPoolCursor); \
-    __oldAlreadyCP = __old->equivalent(*_constantPoolCursor);
-
-#define STOP_WRITING_TO_CONSTANT_POOL \
-    *_constantPoolCursor = Here(); \
-    if (!__oldAlreadyCP) { Seek(__old); }
 
 namespace sfsl {
 
@@ -30,8 +14,8 @@ namespace bc {
 
 // BYTECODE GENERATOR
 
-BytecodeGenerator::BytecodeGenerator(CompCtx_Ptr& ctx, out::CodeGenOutput<BCInstruction*>& out)
-    : CodeGenerator(ctx, out), _constantPoolCursor(std::make_shared<out::Cursor*>(Here())) {
+BytecodeGenerator::BytecodeGenerator(CompCtx_Ptr& ctx, BytecodeBuffer& out)
+    : CodeGenerator(ctx, out), _labelCount(0) {
 
 }
 
@@ -39,183 +23,115 @@ BytecodeGenerator::~BytecodeGenerator() {
 
 }
 
-BytecodeGenerator::BytecodeGenerator(CompCtx_Ptr& ctx, out::CodeGenOutput<BCInstruction*>& out, std::shared_ptr<out::Cursor*> constantPoolCursor)
-    : CodeGenerator(ctx, out), _constantPoolCursor(constantPoolCursor) {
-
-}
-
-out::Cursor* BytecodeGenerator::Here() const {
-    return _out.here();
-}
-
-out::Cursor* BytecodeGenerator::End() const {
-    return _out.end();
-}
-
-void BytecodeGenerator::Seek(out::Cursor* cursor) {
-    _out.seek(cursor);
-}
-
 Label* BytecodeGenerator::MakeLabel(const common::Positionnable& pos, const std::string& name) {
-    Label* label = _mngr.New<Label>(name);
+    Label* label = _mngr.New<Label>(name + utils::T_toString(_labelCount++));
     label->setPos(pos);
     return label;
 }
 
 void BytecodeGenerator::BindLabel(Label* label) {
-    Emit(label);
+    label->encode(_out);
 }
 
 template<typename T, typename... Args>
-T* BytecodeGenerator::Emit(const common::Positionnable& pos, Args... args) {
-    T* instr = _mngr.New<T>(std::forward<Args>(args)...);
-    instr->setPos(pos);
-    _out << instr;
-    return instr;
+void BytecodeGenerator::Emit(const common::Positionnable& pos, Args... args) {
+    T instr(std::forward<Args>(args)...);
+    instr.setPos(pos);
+    instr.encode(_out);
 }
 
-template<typename T>
-T* BytecodeGenerator::Emit(T* instr) {
-    _out << instr;
-    return instr;
-}
+size_t BytecodeGenerator::getConstLoc(const common::Positionnable& pos, const std::string& name) {
+    auto it = _constLocs.find(name);
+    if (it != _constLocs.end()) {
+        return it->second;
+    }
 
-const std::string& BytecodeGenerator::getClassLoc(ClassDecl* clss) {
-    return clss->getUserdata<ClassUserData>()->getDefId();
-}
+    size_t loc = _constLocs.size();
+    _constLocs[name] = loc;
 
-const std::string& BytecodeGenerator::getDefLoc(sym::DefinitionSymbol* def) {
-    return def->getUserdata<DefUserData>()->getDefId();
-}
+    Emit<NameConst>(pos, loc, name);
 
-size_t BytecodeGenerator::getVarLoc(sym::VariableSymbol* var) {
-    return var->getUserdata<VarUserData>()->getVarLoc();
-}
-
-bool BytecodeGenerator::isVariableAttribute(sym::VariableSymbol* var) {
-    return var->getUserdata<VarUserData>()->isAttribute();
+    return loc;
 }
 
 // DEFAULT BYTECODE GENERATOR
 
-DefaultBytecodeGenerator::DefaultBytecodeGenerator(CompCtx_Ptr& ctx, out::CodeGenOutput<BCInstruction*>& out)
+DefaultBytecodeGenerator::DefaultBytecodeGenerator(CompCtx_Ptr& ctx, BytecodeBuffer& out)
     :   BytecodeGenerator(ctx, out) {
 
 }
 
-DefaultBytecodeGenerator::DefaultBytecodeGenerator(CompCtx_Ptr& ctx, out::CodeGenOutput<BCInstruction*>& out, std::shared_ptr<out::Cursor*> constantPoolCursor)
-    :   BytecodeGenerator(ctx, out, constantPoolCursor) {
-
-}
-
 DefaultBytecodeGenerator::~DefaultBytecodeGenerator() {
 
 }
 
-void DefaultBytecodeGenerator::visit(ASTNode*) {
+void DefaultBytecodeGenerator::visit(BASTNode*) {
 
 }
 
 void DefaultBytecodeGenerator::visit(Program* prog) {
-    ASTImplicitVisitor::visit(prog);
-}
-
-void DefaultBytecodeGenerator::visit(ModuleDecl* module) {
-    ASTImplicitVisitor::visit(module);
-}
-
-void DefaultBytecodeGenerator::visit(TypeDecl* tdecl) {
-    ASTImplicitVisitor::visit(tdecl);
-}
-
-void DefaultBytecodeGenerator::visit(ClassDecl* clss) {
-    /*if (TRY_INSERT(_visitedNodes, clss)) {
-        for (TypeDecl* tdecl : clss->getTypeDecls()) {
-            tdecl->onVisit(this);
-        }
-
-        for (DefineDecl* def : clss->getDefs()) {
-            def->onVisit(this);
-        }
-
-        ClassUserData* clssData = clss->getUserdata<ClassUserData>();
-
-        if (clssData->isAbstract()) {
-            return;
-        }
-
-        START_WRITING_TO_CONSTANT_POOL
-
-        for (sym::DefinitionSymbol* def : clssData->getDefs()) {
-            Emit<LoadConst>(*clss, getDefLoc(def));
-        }
-
-        Emit<MakeClass>(*clss, clssData->getAttrCount(), clssData->getDefCount());
-        Emit<StoreConst>(*clss, getClassLoc(clss));
-
-        STOP_WRITING_TO_CONSTANT_POOL
-    }*/
-}
-
-void DefaultBytecodeGenerator::visit(DefineDecl* decl) {
-    /*if (decl->isExtern() || decl->isAbstract()) {
-        return;
+    for (Definition* def : prog->getVisibleDefinitions()) {
+        _defs[def->getName()] = def;
     }
 
-    if (TRY_INSERT(_visitedNodes, decl)) {
-        START_WRITING_TO_CONSTANT_POOL
-
-        decl->getValue()->onVisit(this);
-        Emit<StoreConst>(*decl, getDefLoc(decl->getSymbol()));
-
-        STOP_WRITING_TO_CONSTANT_POOL
-    }*/
-}
-
-void DefaultBytecodeGenerator::visit(ProperTypeKindSpecifier* ptks) {
-
-}
+    for (Definition* def : prog->getHiddenDefinitions()) {
+        _defs[def->getName()] = def;
+    }
 
-void DefaultBytecodeGenerator::visit(TypeConstructorKindSpecifier* tcks) {
+    for (Definition* def : prog->getVisibleDefinitions()) {
+        generateDefinition(def->getName());
+    }
 
-}
+    for (Definition* def : prog->getHiddenDefinitions()) {
+        generateDefinition(def->getName());
+    }
 
-void DefaultBytecodeGenerator::visit(TypeMemberAccess* tdot) {
+    Emit<PushConstUnit>(*prog);
+    Emit<Return>(*prog);
 
+    _out.finish();
 }
 
-void DefaultBytecodeGenerator::visit(TypeTuple* ttuple) {
+void DefaultBytecodeGenerator::visit(MethodDef* meth) {
+    Label* methEntry = MakeLabel(*meth, "mthd");
+    Emit<MakeMethod>(*meth, meth->getVarCount(), methEntry);
+    Emit<StoreConst>(*meth, getConstLoc(*meth, meth->getName()));
 
-}
-
-void DefaultBytecodeGenerator::visit(TypeConstructorCreation* typeconstructor) {
+    // the body goes to its own section, so that the initialization code doesn't have to jump over it
 
-}
+    out::Cursor initCode = _out.here();
+    _out.seek(_out.newSection());
 
-void DefaultBytecodeGenerator::visit(TypeConstructorCall* tcall) {
+    BindLabel(methEntry);
 
-}
+    if (meth->getMethodBody()) {
+        meth->getMethodBody()->onVisit(this);
+    } else {
+        Emit<PushConstUnit>(*meth);
+    }
 
-void DefaultBytecodeGenerator::visit(TypeIdentifier* tident) {
+    Emit<Return>(*meth);
 
+    _out.seek(initCode);
 }
 
-void DefaultBytecodeGenerator::visit(TypeParameter* tparam) {
-
-}
+void DefaultBytecodeGenerator::visit(ClassDef* clss) {
+    for (DefIdentifier* defid : clss->getMethods()) {
+        defid->onVisit(this);
+    }
 
-void DefaultBytecodeGenerator::visit(ExpressionStatement* exp) {
-    ASTImplicitVisitor::visit(exp);
+    Emit<MakeClass>(*clss, clss->getFieldCount(), clss->getMethods().size());
+    Emit<StoreConst>(*clss, getConstLoc(*clss, clss->getName()));
 }
 
-void DefaultBytecodeGenerator::visit(AssignmentExpression* aex) {
-    aex->getRhs()->onVisit(this);
-    AssignmentBytecodeGenerator abg(_ctx, _out, _constantPoolCursor);
-    aex->getLhs()->onVisit(&abg);
-}
+void DefaultBytecodeGenerator::visit(GlobalDef* global) {
+    if (global->getBody()) {
+        global->getBody()->onVisit(this);
+    } else {
+        Emit<PushConstUnit>(*global);
+    }
 
-void DefaultBytecodeGenerator::visit(TypeSpecifier* tps) {
-    tps->getSpecified()->onVisit(this);
+    Emit<StoreConst>(*global, getConstLoc(*global, global->getName()));
 }
 
 void DefaultBytecodeGenerator::visit(Block* block) {
@@ -232,6 +148,30 @@ void DefaultBytecodeGenerator::visit(Block* block) {
     }
 }
 
+void DefaultBytecodeGenerator::visit(DefIdentifier* defid) {
+    Emit<LoadConst>(*defid, getConstLoc(*defid, defid->getValue()));
+}
+
+void DefaultBytecodeGenerator::visit(VarIdentifier* varid) {
+    Emit<LoadStack>(*varid, varid->getLocalId());
+}
+
+void DefaultBytecodeGenerator::visit(FieldAccess* fieldacc) {
+    fieldacc->getAccessed()->onVisit(this);
+    Emit<LoadField>(*fieldacc, fieldacc->getFieldId());
+}
+
+void DefaultBytecodeGenerator::visit(FieldAssignmentExpression* fassign) {
+    fassign->getAccessed()->onVisit(this);
+    fassign->getValue()->onVisit(this);
+    Emit<StoreField>(*fassign, fassign->getFieldId());
+}
+
+void DefaultBytecodeGenerator::visit(VarAssignmentExpression* vassign) {
+    vassign->getValue()->onVisit(this);
+    Emit<StoreStack>(*vassign, vassign->getAssignedVarLocalId());
+}
+
 void DefaultBytecodeGenerator::visit(IfExpression* ifexpr) {
     Label* elseLabel = MakeLabel(*ifexpr, "else");
     Label* outLabel = MakeLabel(*ifexpr, "out");
@@ -257,108 +197,27 @@ void DefaultBytecodeGenerator::visit(IfExpression* ifexpr) {
     BindLabel(outLabel);
 }
 
-void DefaultBytecodeGenerator::visit(MemberAccess* dot) {
-    dot->getAccessed()->onVisit(this);
-
-    if (sym::VariableSymbol* var = sym::getIfSymbolOfType<sym::VariableSymbol>(dot->getSymbol())) {
-        Emit<LoadField>(*dot, getVarLoc(var));
-    }
-}
-
-void DefaultBytecodeGenerator::visit(Tuple* tuple) {
-    ASTImplicitVisitor::visit(tuple);
+void DefaultBytecodeGenerator::visit(DynamicMethodCall* dmethcall) {
+    dmethcall->getCallee()->onVisit(this);
 
-    if (tuple->getExpressions().size() == 0) {
-        Emit<PushConstUnit>(*tuple);
+    for (Expression* arg : dmethcall->getArgs()) {
+        arg->onVisit(this);
     }
-}
-
-void DefaultBytecodeGenerator::visit(FunctionCreation* func) {
-    /*if (type::ProperType* pt = type::getIf<type::ProperType>(func->type())) {
-        pt->getClass()->onVisit(this);
-
-        // TODO: Call the constructor of the function's class
-        size_t classLoc = pt->getClass()->getUserdata<ClassUserData>()->getClassLoc();
-        Emit<LoadConst>(*func, classLoc);
-        Emit<Instantiate>(*func);
-    } else {
-        Label* funcEnd = MakeLabel(*func, "mthd_end");
-        Emit<MakeMethod>(*func, func->getUserdata<FuncUserData>()->getVarCount(), funcEnd);
 
-        func->getBody()->onVisit(this);
-        Emit<Return>(*func);
-
-        BindLabel(funcEnd);
-    }*/
+    Emit<VCall>(*dmethcall, dmethcall->getVirtualId(), dmethcall->getArgs().size());
 }
 
-void DefaultBytecodeGenerator::visit(FunctionCall* call) {
-    if (call->getCallee()->type()->getTypeKind() == type::TYPE_METHOD) {
-        bool isCallToConstructor = false;
-
-        if (MemberAccess* dot = getIfNodeOfType<MemberAccess>(call->getCallee(), _ctx)) {
-            dot->getAccessed()->onVisit(this);
-
-            if (isNodeOfType<Instantiation>(dot->getAccessed(), _ctx)) {
-                isCallToConstructor = true;
-                Emit<Dup>(*dot->getAccessed());
-            }
-        }
-        else if (isNodeOfType<Identifier>(call->getCallee(), _ctx)) { // implicit this
-            Emit<LoadStack>(*call->getCallee(), 0);
-        }
-
-        sym::DefinitionSymbol* def = static_cast<sym::DefinitionSymbol*>(ASTSymbolExtractor::extractSymbol(call->getCallee(), _ctx));
-        size_t virtualLoc = def->getUserdata<VirtualDefUserData>()->getVirtualLocation();
-
-        for (Expression* expr : call->getArgs()) {
-            expr->onVisit(this);
-        }
-
-        Emit<VCall>(*call, virtualLoc, call->getArgs().size());
-
-        if (isCallToConstructor) {
-            Emit<Pop>(*call);
-        }
-    }
+void DefaultBytecodeGenerator::visit(StaticMethodCall* smethcall) {
+    _ctx->reporter().fatal(*smethcall, "Static method calls are not supported by the bytecode generator");
 }
 
 void DefaultBytecodeGenerator::visit(Instantiation* inst) {
-    /*if (type::ProperType* pt = type::getIf<type::ProperType>(inst->type()->apply(_ctx))) {
-        ClassDecl* clss = pt->getClass();
-        size_t classLoc = clss->getUserdata<ClassUserData>()->getClassLoc();
-        Emit<LoadConst>(*inst, classLoc);
-        Emit<Instantiate>(*inst);
-    }*/
-}
-
-void DefaultBytecodeGenerator::visit(Identifier* ident) {
-    /*switch (ident->getSymbol()->getSymbolType()) {
-    case sym::SYM_VAR: {
-        sym::VariableSymbol* var = static_cast<sym::VariableSymbol*>(ident->getSymbol());
-        if (isVariableAttribute(var)) {
-            Emit<LoadStack>(*ident, 0);
-            Emit<LoadField>(*ident, getVarLoc(var));
-        } else {
-            Emit<LoadStack>(*ident, getVarLoc(var));
-        }
-        break;
-    }
-
-    case sym::SYM_DEF: {
-        sym::DefinitionSymbol* def = static_cast<sym::DefinitionSymbol*>(ident->getSymbol());
-        def->getDef()->onVisit(this);
-        Emit<LoadConst>(*ident, getDefLoc(def));
-        break;
-    }
-
-    default:
-        break;
-    }*/
+    inst->getClassId()->onVisit(this);
+    Emit<Instantiate>(*inst);
 }
 
-void DefaultBytecodeGenerator::visit(This* ths) {
-    Emit<LoadStack>(*ths, 0);
+void DefaultBytecodeGenerator::visit(UnitLiteral* unitlit) {
+    Emit<PushConstUnit>(*unitlit);
 }
 
 void DefaultBytecodeGenerator::visit(BoolLiteral* boollit) {
@@ -373,68 +232,42 @@ void DefaultBytecodeGenerator::visit(RealLiteral* reallit) {
     Emit<PushConstReal>(*reallit, reallit->getValue());
 }
 
-// ASSIGNMENT BYTECODE GENERATOR
-
-DefaultBytecodeGenerator::AssignmentBytecodeGenerator::AssignmentBytecodeGenerator(CompCtx_Ptr& ctx, out::CodeGenOutput<BCInstruction*>& out)
-    : BytecodeGenerator(ctx, out) {
-
+void DefaultBytecodeGenerator::visit(StringLiteral* strlit) {
+    Emit<PushConstString>(*strlit, strlit->getValue());
 }
 
-DefaultBytecodeGenerator::AssignmentBytecodeGenerator::AssignmentBytecodeGenerator(CompCtx_Ptr& ctx, out::CodeGenOutput<BCInstruction*>& out, std::shared_ptr<out::Cursor*> constantPoolCursor)
-    : BytecodeGenerator(ctx, out, constantPoolCursor) {
+void DefaultBytecodeGenerator::generateDefinition(const std::string& name) {
+    auto it = _defs.find(name);
+    if (it == _defs.end() || !_visitedDefs.insert(name).second) {
+        return; // extern definition or already generated
+    }
 
-}
+    DependencyCollector collector;
+    it->second->onVisit(&collector);
 
-DefaultBytecodeGenerator::AssignmentBytecodeGenerator::~AssignmentBytecodeGenerator() {
+    for (const std::string& dep : collector.getDependencies()) {
+        generateDefinition(dep);
+    }
 
+    it->second->onVisit(this);
 }
 
-void DefaultBytecodeGenerator::AssignmentBytecodeGenerator::visit(ASTNode*) {
+// DEPENDENCY COLLECTOR
 
-}
+DefaultBytecodeGenerator::DependencyCollector::DependencyCollector() {
 
-void DefaultBytecodeGenerator::AssignmentBytecodeGenerator::visit(TypeSpecifier* tps) {
-    tps->getSpecified()->onVisit(this);
 }
 
-void DefaultBytecodeGenerator::AssignmentBytecodeGenerator::visit(MemberAccess* dot) {
-    DefaultBytecodeGenerator dbg(_ctx, _out, _constantPoolCursor);
-    dot->getAccessed()->onVisit(&dbg);
+DefaultBytecodeGenerator::DependencyCollector::~DependencyCollector() {
 
-    if (sym::VariableSymbol* var = sym::getIfSymbolOfType<sym::VariableSymbol>(dot->getSymbol())) {
-        Emit<StoreField>(*dot, getVarLoc(var));
-    }
 }
 
-void DefaultBytecodeGenerator::AssignmentBytecodeGenerator::visit(IfExpression* ifexpr) {
-    Label* elseLabel = MakeLabel(*ifexpr, "else");
-    Label* outLabel = MakeLabel(*ifexpr, "out");
-
-    // if cond is false, jump to the else label
-    DefaultBytecodeGenerator dbg(_ctx, _out, _constantPoolCursor);
-    ifexpr->getCondition()->onVisit(&dbg);
-    Emit<IfFalse>(*ifexpr->getCondition(), elseLabel);
-
-    // code for the then part, plus the jump to the end of the if
-    ifexpr->getThen()->onVisit(this);
-    Emit<Jump>(*ifexpr->getThen(), outLabel);
-
-    // label and code for the else part
-    BindLabel(elseLabel);
-    ifexpr->getElse()->onVisit(this); // no need to check if it has an else part because it is a requirement
-
-    // label for the end of the if
-    BindLabel(outLabel);
+void DefaultBytecodeGenerator::DependencyCollector::visit(DefIdentifier* defid) {
+    _deps.push_back(defid->getValue());
 }
 
-void DefaultBytecodeGenerator::AssignmentBytecodeGenerator::visit(Identifier* ident) {
-    sym::VariableSymbol* var = static_cast<sym::VariableSymbol*>(ident->getSymbol());
-    if (isVariableAttribute(var)) {
-        Emit<LoadStack>(*ident, 0);
-        Emit<StoreField>(*ident, getVarLoc(var));
-    } else {
-        Emit<StoreStack>(*ident, getVarLoc(var));
-    }
+const std::vector<std::string>& DefaultBytecodeGenerator::DependencyCollector::getDependencies() const {
+    return _deps;
 }
 
 }
@@ -10,110 +10,112 @@
 #define __SFSL__BytecodeGenerator__
 
 #include <iostream>
+#include <map>
+#include <set>
 #include "CodeGen/CodeGenerator.h"
 #include "Bytecode/Bytecode.h"
-#include "AST2BAST/PreTransform.h"
+#include "Bytecode/BytecodeBuffer.h"
+#include "BAST/Nodes/Nodes.h"
 
 namespace sfsl {
 
 namespace bc {
 
-using namespace ast;
+using namespace bast;
 
-class BytecodeGenerator : public out::CodeGenerator<BCInstruction*> {
+/**
+ * @brief Base class for the generators of bytecode. Instructions are encoded
+ * directly into a #sfsl::bc::BytecodeBuffer, without being allocated.
+ */
+class BytecodeGenerator : public out::CodeGenerator<BytecodeBuffer> {
 public:
-    BytecodeGenerator(CompCtx_Ptr& ctx, out::CodeGenOutput<BCInstruction*>& out);
+    BytecodeGenerator(CompCtx_Ptr& ctx, BytecodeBuffer& out);
     virtual ~BytecodeGenerator();
 
 protected:
 
-    BytecodeGenerator(CompCtx_Ptr& ctx, out::CodeGenOutput<BCInstruction*>& out, std::shared_ptr<out::Cursor*> constantPoolCursor);
-
-    out::Cursor* Here() const;
-    out::Cursor* End() const;
-    void Seek(out::Cursor* cursor);
-
     Label* MakeLabel(const common::Positionnable& pos, const std::string& name);
     void BindLabel(Label* label);
 
     template<typename T, typename... Args>
-    T* Emit(const common::Positionnable& pos, Args... args);
-
-    template<typename T>
-    T* Emit(T* instr);
-
-    const std::string& getClassLoc(ast::ClassDecl* clss);
-    const std::string& getDefLoc(sym::DefinitionSymbol* def);
-    size_t getVarLoc(sym::VariableSymbol* var);
-
-    bool isVariableAttribute(sym::VariableSymbol* var);
-
-    std::shared_ptr<out::Cursor*> _constantPoolCursor;
+    void Emit(const common::Positionnable& pos, Args... args);
+
+    /**
+     * @brief Returns the slot of the constant pool assigned to the given definition name.
+     * The first time a name is requested, a new slot is allocated and named in the
+     * constant pool so that it can be linked at runtime.
+     *
+     * @param pos The position to give to the NameConst instruction
+     * @param name The name of the definition
+     * @return The index of the slot
+     */
+    size_t getConstLoc(const common::Positionnable& pos, const std::string& name);
+
+    std::map<std::string, size_t> _constLocs;
+    size_t _labelCount;
 };
 
 /**
- * @brief Base class for visitors that generate code from the AST
+ * @brief Generates the bytecode of a program from its backend AST.
+ *
+ * The generated code is meant to be executed once from its first instruction:
+ * it creates every definition of the program (in an order where a definition comes after
+ * the ones it depends on), storing each of them in its own constant pool slot, and finally
+ * returns unit. The bodies of the methods follow this initialization code.
  */
 class DefaultBytecodeGenerator : public BytecodeGenerator {
 public:
 
-    DefaultBytecodeGenerator(CompCtx_Ptr& ctx, out::CodeGenOutput<BCInstruction*>& out);
-    DefaultBytecodeGenerator(CompCtx_Ptr& ctx, out::CodeGenOutput<BCInstruction*>& out, std::shared_ptr<out::Cursor*> constantPoolCursor);
+    DefaultBytecodeGenerator(CompCtx_Ptr& ctx, BytecodeBuffer& out);
     virtual ~DefaultBytecodeGenerator();
 
-    virtual void visit(ASTNode*) override;
+    virtual void visit(BASTNode*) override;
 
     virtual void visit(Program* prog) override;
 
-    virtual void visit(ModuleDecl* module) override;
-    virtual void visit(TypeDecl* tdecl) override;
-    virtual void visit(ClassDecl* clss) override;
-    virtual void visit(DefineDecl* decl) override;
-
-    virtual void visit(ProperTypeKindSpecifier* ptks) override;
-    virtual void visit(TypeConstructorKindSpecifier* tcks) override;
-
-    virtual void visit(TypeMemberAccess* tdot) override;
-    virtual void visit(TypeTuple* ttuple) override;
-    virtual void visit(TypeConstructorCreation* typeconstructor) override;
-    virtual void visit(TypeConstructorCall* tcall) override;
-    virtual void visit(TypeIdentifier* tident) override;
-    virtual void visit(TypeParameter* tparam) override;
-
-    virtual void visit(ExpressionStatement* exp) override;
+    virtual void visit(MethodDef* meth) override;
+    virtual void visit(ClassDef* clss) override;
+    virtual void visit(GlobalDef* global) override;
 
-    virtual void visit(AssignmentExpression* aex) override;
-    virtual void visit(TypeSpecifier* tps) override;
     virtual void visit(Block* block) override;
+    virtual void visit(DefIdentifier* defid) override;
+    virtual void visit(VarIdentifier* varid) override;
+    virtual void visit(FieldAccess* fieldacc) override;
+    virtual void visit(FieldAssignmentExpression* fassign) override;
+    virtual void visit(VarAssignmentExpression* vassign) override;
     virtual void visit(IfExpression* ifexpr) override;
-    virtual void visit(MemberAccess* dot) override;
-    virtual void visit(Tuple* tuple) override;
-    virtual void visit(FunctionCreation* func) override;
-    virtual void visit(FunctionCall* call) override;
+    virtual void visit(DynamicMethodCall* dmethcall) override;
+    virtual void visit(StaticMethodCall* smethcall) override;
     virtual void visit(Instantiation* inst) override;
-    virtual void visit(Identifier* ident) override;
-    virtual void visit(This* ths) override;
+    virtual void visit(UnitLiteral* unitlit) override;
     virtual void visit(BoolLiteral* boollit) override;
     virtual void visit(IntLiteral* intlit) override;
     virtual void visit(RealLiteral* reallit) override;
+    virtual void visit(StringLiteral* strlit) override;
 
 private:
 
-    class AssignmentBytecodeGenerator : public BytecodeGenerator {
+    /**
+     * @brief Collects the names of the definitions referenced by a backend AST node
+     */
+    class DependencyCollector : public BASTImplicitVisitor {
     public:
-        AssignmentBytecodeGenerator(CompCtx_Ptr& ctx, out::CodeGenOutput<BCInstruction*>& out);
-        AssignmentBytecodeGenerator(CompCtx_Ptr& ctx, out::CodeGenOutput<BCInstruction*>& out, std::shared_ptr<out::Cursor*> constantPoolCursor);
-        virtual ~AssignmentBytecodeGenerator();
+        DependencyCollector();
+        virtual ~DependencyCollector();
 
-        virtual void visit(ASTNode*) override;
+        virtual void visit(DefIdentifier* defid) override;
 
-        virtual void visit(TypeSpecifier* tps) override;
-        virtual void visit(MemberAccess* dot) override;
-        virtual void visit(IfExpression* ifexpr) override;
-        virtual void visit(Identifier* ident) override;
+        const std::vector<std::string>& getDependencies() const;
+
+    private:
+
+        std::vector<std::string> _deps;
     };
 
-    std::set<ASTNode*> _visitedNodes;
+    void generateDefinition(const std::string& name);
+
+    std::map<std::string, Definition*> _defs;
+    std::set<std::string> _visitedDefs;
 };
 
 }
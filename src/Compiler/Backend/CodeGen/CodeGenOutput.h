@@ -11,7 +11,7 @@
 
 #include <iostream>
 #include <vector>
-#include <list>
+#include <algorithm>
 #include "../../../Utils/Utils.h"
 #include "../../../Compiler/Common/CompilationContext.h"
 
@@ -20,21 +20,26 @@ namespace sfsl {
 namespace out {
 
 /**
- * @brief Interface for objects storing informations
- * relative to a location in the output code
+ * @brief A location in the output code: an offset in one of its segments
  */
-class Cursor : public common::MemoryManageable {
-public:
-    virtual bool equivalent(Cursor* other) const;
+struct Cursor final {
+    size_t segment;
+    size_t offset;
+
+    bool operator==(const Cursor& other) const {
+        return segment == other.segment && offset == other.offset;
+    }
 
-protected:
-    Cursor();
-    virtual ~Cursor();
+    bool operator!=(const Cursor& other) const {
+        return !(*this == other);
+    }
 };
 
 template<typename T>
 /**
- * @brief Interface representing the destination of the generated code
+ * @brief Interface representing the destination of the generated code.
+ * The code is written to segments, which are concatenated in the order of
+ * their creation to form the final output.
  */
 class CodeGenOutput {
 public:
@@ -42,7 +47,7 @@ public:
     virtual ~CodeGenOutput() {}
 
     /**
-     * @brief Appends a value to the destination object
+     * @brief Writes a value at the current location, and moves after it
      * @param t The value to be added
      * @return This
      */
@@ -51,110 +56,122 @@ public:
     /**
      * @return A cursor to the actual location
      */
-    virtual Cursor* here() const = 0;
+    virtual Cursor here() const = 0;
 
     /**
-     * @return A cursor to the end of the output object
+     * @return A cursor to the end of the last segment
      */
-    virtual Cursor* end() const = 0;
+    virtual Cursor end() const = 0;
 
     /**
-     * @brief Sets the output position for the next instructions
+     * @brief Sets the output position for the next values
      * to the one pointed by the cursor
      * @param c The cursor to follow
      */
-    virtual void seek(Cursor* c) = 0;
+    virtual void seek(Cursor c) = 0;
+
+    /**
+     * @brief Creates a new empty segment, placed after all the existing ones.
+     * The current location is not changed.
+     * @return A cursor to the beginning of the new segment
+     */
+    virtual Cursor newSegment() = 0;
 };
 
 template<typename T>
 /**
- * @brief Implementation of the CodeGenOutput interface writing the emitted code into a linked list
+ * @brief Implementation of the CodeGenOutput interface writing each segment into
+ * its own contiguous vector. Writing before the end of a segment overwrites the
+ * values that are there, which allows to patch the code in place.
  */
-class LinkedListOutput : public CodeGenOutput<T> {
-protected:
-
-    struct Node final : public common::MemoryManageable {
-        Node(Node* n, const T& val) : next(n), value(val) {}
-        virtual ~Node() {}
-
-        Node* next;
-        T value;
-    };
-
-    class LinkedListOutputCursor final : public Cursor {
-    public:
-
-        LinkedListOutputCursor(Node* node) : pos(node) {}
-        virtual ~LinkedListOutputCursor() {}
-
-        virtual bool equivalent(Cursor* other) const override {
-            if (LinkedListOutputCursor* voc = dynamic_cast<LinkedListOutputCursor*>(other)) {
-                return pos == voc->pos;
-            } else {
-                return false;
-            }
-        }
-
-        Node* pos;
-    };
-
+class SegmentedOutput final : public CodeGenOutput<T> {
 public:
 
-    LinkedListOutput(CompCtx_Ptr& ctx) : _ctx(ctx), _here(nullptr), _end(nullptr) {}
+    SegmentedOutput() : _segments(1), _here{0, 0} {}
 
-    virtual ~LinkedListOutput() {}
+    virtual ~SegmentedOutput() {}
 
     virtual CodeGenOutput<T>& operator <<(const T& t) override {
-        if (_here) {
-            _here->next = _ctx->memoryManager().New<Node>(_here->next, t);
-            if (_end == _here) {
-                _end = _end->next;
-            }
-            _here = _here->next;
-        } else if (_end) {
-            _end->next = _ctx->memoryManager().New<Node>(_end->next, t);
-            _here = _end->next;
+        std::vector<T>& seg(_segments[_here.segment]);
+        if (_here.offset == seg.size()) {
+            seg.push_back(t);
         } else {
-            _here = _ctx->memoryManager().New<Node>(nullptr, t);
-            _here->next = _here;
-            _end = _here;
+            seg[_here.offset] = t;
         }
+        ++_here.offset;
         return *this;
     }
 
-    virtual Cursor* here() const override {
-        return _ctx->memoryManager().New<LinkedListOutputCursor>(_here);
+    /**
+     * @brief Writes the `count` values starting at `data`, as if they were written one by one
+     */
+    void write(const T* data, size_t count) {
+        std::vector<T>& seg(_segments[_here.segment]);
+        size_t overwritten = std::min(count, seg.size() - _here.offset);
+        std::copy(data, data + overwritten, seg.begin() + _here.offset);
+        seg.insert(seg.end(), data + overwritten, data + count);
+        _here.offset += count;
+    }
+
+    virtual Cursor here() const override {
+        return _here;
     }
 
-    virtual Cursor* end() const override {
-        return _ctx->memoryManager().New<LinkedListOutputCursor>(_end);
+    virtual Cursor end() const override {
+        return Cursor{_segments.size() - 1, _segments.back().size()};
     }
 
-    virtual void seek(Cursor* c) override {
-        if (LinkedListOutputCursor* voc = dynamic_cast<LinkedListOutputCursor*>(c)) {
-            _here = voc->pos;
-        } else {
-            throw common::CompilationFatalError("Failed to seek to cursor: Wrong cursor type");
+    virtual void seek(Cursor c) override {
+        if (c.segment >= _segments.size() || c.offset > _segments[c.segment].size()) {
+            throw common::CompilationFatalError("Failed to seek to cursor: out of bounds");
         }
+        _here = c;
+    }
+
+    virtual Cursor newSegment() override {
+        _segments.push_back(std::vector<T>());
+        return Cursor{_segments.size() - 1, 0};
+    }
+
+    /**
+     * @return The value at the location pointed by the cursor
+     */
+    T& at(Cursor c) {
+        return _segments[c.segment][c.offset];
     }
 
-    std::vector<T> toVector() const {
-        std::vector<T> toRet;
-        if (_end) {
-            for (Node* cur = _end->next; cur != _end; cur = cur->next) {
-                toRet.push_back(cur->value);
-            }
-            toRet.push_back(_end->value);
+    size_t getSegmentCount() const {
+        return _segments.size();
+    }
+
+    /**
+     * @return The offset at which each segment starts in the concatenated output,
+     * followed by the total size of the output
+     */
+    std::vector<size_t> segmentOffsets() const {
+        std::vector<size_t> offsets(_segments.size() + 1, 0);
+        for (size_t i = 0; i < _segments.size(); ++i) {
+            offsets[i + 1] = offsets[i] + _segments[i].size();
         }
-        return toRet;
+        return offsets;
     }
 
-protected:
+    /**
+     * @return The concatenation of all the segments
+     */
+    std::vector<T> assemble() const {
+        std::vector<T> res;
+        res.reserve(segmentOffsets().back());
+        for (const std::vector<T>& seg : _segments) {
+            res.insert(res.end(), seg.begin(), seg.end());
+        }
+        return res;
+    }
 
-    CompCtx_Ptr& _ctx;
+private:
 
-    Node* _here;
-    Node* _end;
+    std::vector<std::vector<T>> _segments;
+    Cursor _here;
 };
 
 }
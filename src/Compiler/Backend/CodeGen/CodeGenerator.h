@@ -11,32 +11,33 @@
 
 #include <iostream>
 #include <set>
-#include "../../Frontend/AST/Visitors/ASTImplicitVisitor.h"
-#include "../../Frontend/Symbols/SymbolResolver.h"
+#include "../BAST/Visitors/BASTImplicitVisitor.h"
 #include "CodeGenOutput.h"
 
 namespace sfsl {
 
 namespace out {
 
-using namespace ast;
+using namespace bast;
 
-template<typename T>
+template<typename Output>
 /**
- * @brief Base class for visitors that generate code from the AST
+ * @brief Base class for visitors that generate code from the backend AST.
+ * `Output` is the type of the destination of the generated code.
  */
-class CodeGenerator : public ASTImplicitVisitor {
+class CodeGenerator : public BASTImplicitVisitor {
 public:
 
-    CodeGenerator(CompCtx_Ptr& ctx, CodeGenOutput<T>& out) : ASTImplicitVisitor(ctx), _mngr(ctx->memoryManager()), _out(out) {}
+    CodeGenerator(CompCtx_Ptr& ctx, Output& out) : _ctx(ctx), _mngr(ctx->memoryManager()), _out(out) {}
     virtual ~CodeGenerator() {}
 
-    virtual void visit(ASTNode*) override = 0;
+    virtual void visit(BASTNode*) override = 0;
 
 protected:
 
+    CompCtx_Ptr _ctx;
     common::AbstractMemoryManager& _mngr;
-    CodeGenOutput<T>& _out;
+    Output& _out;
 };
 
 }
@@ -7,12 +7,32 @@
 //
 
 #include "CompilationContext.h"
+#include "../Frontend/Types/Environment.h"
 #include <memory>
 
 namespace sfsl {
 
 namespace common {
 
+/**
+ * @brief Writes the string as a JSON string literal, escaping quotes, backslashes and control characters
+ */
+static void writeJSONString(std::ostream& o, const std::string& str) {
+    static const char hexDigits[] = "0123456789abcdef";
+
+    o << '"';
+    for (char c : str) {
+        if (c == '"' || c == '\\') {
+            o << '\\' << c;
+        } else if ((unsigned char)c < 0x20) {
+            o << "\\u00" << hexDigits[(c >> 4) & 0xF] << hexDigits[c & 0xF];
+        } else {
+            o << c;
+        }
+    }
+    o << '"';
+}
+
 CompilationContext::CompilationContext(std::unique_ptr<AbstractMemoryManager> manager, std::unique_ptr<AbstractReporter> reporter)
     : _mngr(std::move(manager)), _rprt(std::move(reporter)) {
 
@@ -30,19 +50,81 @@ AbstractReporter& CompilationContext::reporter() const {
     return *_rprt;
 }
 
-std::shared_ptr<CompilationContext> CompilationContext::DefaultCompilationContext(size_t chunksize) {
+NameTable& CompilationContext::names() const {
+    return _names;
+}
+
+SourceTable& CompilationContext::sources() const {
+    return _sources;
+}
+
+MemoryStats CompilationContext::memoryStats() const {
+    MemoryStats stats(_mngr->getStats());
+    stats.environmentCopies = type::Environment::getCopyStats();
+    return stats;
+}
+
+void CompilationContext::recordPhaseMemory(const std::string& phaseName, const MemoryStats& stats) {
+    _phaseMemoryStats.push_back(std::make_pair(phaseName, stats));
+}
+
+const std::vector<std::pair<std::string, MemoryStats>>& CompilationContext::getPhaseMemoryStats() const {
+    return _phaseMemoryStats;
+}
+
+void CompilationContext::recordPhaseResolutions(const std::string& phaseName, const ResolutionStats& stats) {
+    _phaseResolutionStats.push_back(std::make_pair(phaseName, stats));
+}
+
+const std::vector<std::pair<std::string, ResolutionStats>>& CompilationContext::getPhaseResolutionStats() const {
+    return _phaseResolutionStats;
+}
+
+void CompilationContext::writeMemoryStatsJSON(std::ostream& o) const {
+    o << "{\"total\": ";
+    memoryStats().writeJSON(o);
+    o << ", \"phases\": [";
+
+    for (size_t i = 0; i < _phaseMemoryStats.size(); ++i) {
+        o << (i == 0 ? "" : ", ") << "{\"phase\": ";
+        writeJSONString(o, _phaseMemoryStats[i].first);
+        o << ", \"stats\": ";
+        _phaseMemoryStats[i].second.writeJSON(o);
+        o << "}";
+    }
+
+    ResolutionStats totalResolutions;
+    for (const std::pair<std::string, ResolutionStats>& phase : _phaseResolutionStats) {
+        totalResolutions = totalResolutions + phase.second;
+    }
+
+    o << "], \"resolutions\": {\"total\": ";
+    totalResolutions.writeJSON(o);
+    o << ", \"phases\": [";
+
+    for (size_t i = 0; i < _phaseResolutionStats.size(); ++i) {
+        o << (i == 0 ? "" : ", ") << "{\"phase\": ";
+        writeJSONString(o, _phaseResolutionStats[i].first);
+        o << ", \"stats\": ";
+        _phaseResolutionStats[i].second.writeJSON(o);
+        o << "}";
+    }
+
+    o << "]}}";
+}
+
+std::shared_ptr<CompilationContext> CompilationContext::DefaultCompilationContext(const ChunkPolicy& policy) {
     return std::shared_ptr<CompilationContext>(
-                new CompilationContext(std::move(std::unique_ptr<ChunkedMemoryManager>(new ChunkedMemoryManager(chunksize))),
+                new CompilationContext(std::move(std::unique_ptr<ConcurrentMemoryManager>(new ConcurrentMemoryManager(policy))),
                                        std::move(std::unique_ptr<StandartErrReporter>(new StandartErrReporter()))));
 }
 
-std::shared_ptr<CompilationContext> CompilationContext::CustomReporterCompilationContext(size_t chunksize, std::unique_ptr<AbstractReporter> rep) {
+std::shared_ptr<CompilationContext> CompilationContext::CustomReporterCompilationContext(const ChunkPolicy& policy, std::unique_ptr<AbstractReporter> rep) {
     return std::shared_ptr<CompilationContext>(
-                new CompilationContext(std::move(std::unique_ptr<ChunkedMemoryManager>(new ChunkedMemoryManager(chunksize))),
+                new CompilationContext(std::move(std::unique_ptr<ConcurrentMemoryManager>(new ConcurrentMemoryManager(policy))),
                                        std::move(rep)));
 }
 
-
 }
 
 }
@@ -11,10 +11,14 @@
 
 #include <iostream>
 #include <map>
+#include <vector>
 #include <memory>
 
 #include "MemoryManager.h"
 #include "Reporter.h"
+#include "Name.h"
+#include "SourceTable.h"
+#include "ResolutionStats.h"
 
 namespace sfsl {
 
@@ -25,6 +29,8 @@ namespace common {
  * during the compilation to :
  *  - allocate memory
  *  - report errors
+ *  - intern names
+ *  - keep track of the sources
  *
  * Instances of this class can be created via the static methods
  */
@@ -44,6 +50,52 @@ public:
      */
     AbstractReporter& reporter() const;
 
+    /**
+     * @return The table in which the identifiers and other names are interned
+     */
+    NameTable& names() const;
+
+    /**
+     * @return The table holding the name and the line index of each source
+     */
+    SourceTable& sources() const;
+
+    /**
+     * @return The memory allocated so far through the memory manager, by category,
+     * along with the copies of type environments
+     */
+    MemoryStats memoryStats() const;
+
+    /**
+     * @brief Records the memory that was allocated during a phase of the compilation
+     * @param phaseName The name of the phase
+     * @param stats The difference between the memory stats at the end and at the beginning of the phase
+     */
+    void recordPhaseMemory(const std::string& phaseName, const MemoryStats& stats);
+
+    /**
+     * @return The memory allocated by each phase, in the order in which they were recorded
+     */
+    const std::vector<std::pair<std::string, MemoryStats>>& getPhaseMemoryStats() const;
+
+    /**
+     * @brief Records the symbol lookups that were done during a phase of the compilation
+     * @param phaseName The name of the phase
+     * @param stats The difference between the resolution stats at the end and at the beginning of the phase
+     */
+    void recordPhaseResolutions(const std::string& phaseName, const ResolutionStats& stats);
+
+    /**
+     * @return The symbol lookups done by each phase, in the order in which they were recorded
+     */
+    const std::vector<std::pair<std::string, ResolutionStats>>& getPhaseResolutionStats() const;
+
+    /**
+     * @brief Writes the current memory stats and the ones of each phase as a JSON object,
+     * along with the symbol lookups of each phase
+     */
+    void writeMemoryStatsJSON(std::ostream& o) const;
+
     template<typename T>
     /**
      * @brief Used to retrieve user data element of a given them from this compilation context.
@@ -57,16 +109,16 @@ public:
 
     /**
      * @return Creates the default CompilationContext, which uses :
-     *  - ChunkedMemoryManager as the memory manager.
+     *  - ConcurrentMemoryManager as the memory manager, so that phases can allocate from several threads.
      *  - StandartErrReporter as the error reporter.
      */
-    static std::shared_ptr<CompilationContext> DefaultCompilationContext(size_t chunksize);
+    static std::shared_ptr<CompilationContext> DefaultCompilationContext(const ChunkPolicy& policy);
 
     /**
      * @return Creates a CompilationContext the default memory manager
      * and a custom reporter.
      */
-    static std::shared_ptr<CompilationContext> CustomReporterCompilationContext(size_t chunksize, std::unique_ptr<AbstractReporter> rep);
+    static std::shared_ptr<CompilationContext> CustomReporterCompilationContext(const ChunkPolicy& policy, std::unique_ptr<AbstractReporter> rep);
 
 private:
 
@@ -75,7 +127,13 @@ private:
     std::unique_ptr<AbstractMemoryManager> _mngr;
     std::unique_ptr<AbstractReporter> _rprt;
 
+    mutable NameTable _names;
+    mutable SourceTable _sources;
+
     std::map<std::string, MemoryManageable*> _ctxUserData;
+
+    std::vector<std::pair<std::string, MemoryStats>> _phaseMemoryStats;
+    std::vector<std::pair<std::string, ResolutionStats>> _phaseResolutionStats;
 };
 
 template<typename T>
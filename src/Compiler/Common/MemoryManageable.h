@@ -10,6 +10,8 @@
 #define __SFSL__MemoryManageable__
 
 #include <stddef.h>
+#include <type_traits>
+#include "MemoryStats.h"
 
 namespace sfsl {
 
@@ -24,6 +26,11 @@ public:
 
     friend class AbstractMemoryManager;
 
+    /**
+     * @brief The category in which the instances are accounted, redefined by subclasses
+     */
+    static const MEMORY_CATEGORY MemoryCategory = MEM_OTHER;
+
     /**
      * @brief The destructor
      */
@@ -42,8 +49,27 @@ private:
     void* operator new   (size_t, void*);
 };
 
+template<typename T>
+/**
+ * @brief Tells whether instances of T can be freed without calling their destructor,
+ * in which case memory managers don't need to keep track of them. #sfsl::common::MemoryManageable
+ * objects always have a non trivial destructor, so types opt in by exact type using
+ * #SFSL_TRIVIALLY_MANAGEABLE once it is checked that none of their members needs to be destroyed.
+ */
+struct IsTriviallyManageable : std::is_trivially_destructible<T> {};
+
 }
 
 }
 
+/**
+ * @brief Marks the type (which must be fully qualified and used outside of any namespace)
+ * as trivially manageable (see #sfsl::common::IsTriviallyManageable).
+ * Subclasses are not affected.
+ */
+#define SFSL_TRIVIALLY_MANAGEABLE(T) \
+    namespace sfsl { namespace common { \
+    template<> struct IsTriviallyManageable<T> : std::true_type {}; \
+    } }
+
 #endif
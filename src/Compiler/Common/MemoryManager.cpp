@@ -6,6 +6,8 @@
 //  Copyright (c) 2014 Romain Beguet. All rights reserved.
 //
 
+#include <atomic>
+#include <algorithm>
 #include "MemoryManager.h"
 #include "Reporter.h"
 #include "../../Utils/Utils.h"
@@ -24,6 +26,22 @@ std::string AbstractMemoryManager::getInfos() const {
     return "<no info available for this Memory Manager>";
 }
 
+MemoryStats AbstractMemoryManager::getStats() const {
+    return MemoryStats();
+}
+
+void* AbstractMemoryManager::allocUntracked(size_t size, size_t alignment, MEMORY_CATEGORY category) {
+    return alloc(size, alignment, category);
+}
+
+// CHUNK POLICY
+
+ChunkPolicy::ChunkPolicy(size_t initialChunkSize, size_t maxChunkSize, size_t growthFactor, size_t largeObjectSize)
+    : initialChunkSize(initialChunkSize), maxChunkSize(maxChunkSize),
+      growthFactor(growthFactor), largeObjectSize(largeObjectSize) {
+
+}
+
 // MEMORY CHUNK
 
 MemoryChunk::MemoryChunk(size_t size, MemoryChunk* parent) : _chunk(new char[size]), _chunkSize(size), _offset(0), _parent(parent) {
@@ -31,22 +49,34 @@ MemoryChunk::MemoryChunk(size_t size, MemoryChunk* parent) : _chunk(new char[siz
 }
 
 MemoryChunk::~MemoryChunk() {
-    delete _chunk;
+    delete[] _chunk;
 
-    if (_parent) {
-        delete _parent;
+    // the chain can be long, so the parents are not destroyed recursively
+    MemoryChunk* parent = _parent;
+    while (parent) {
+        MemoryChunk* next = parent->_parent;
+        parent->_parent = nullptr;
+        delete parent;
+        parent = next;
     }
 }
 
-void* MemoryChunk::alloc(MemoryChunk*& chunk, size_t size) {
-    if (size > chunk->_chunkSize - chunk->_offset) {
-        chunk = new MemoryChunk(chunk->_chunkSize * 2, chunk);
-        return alloc(chunk, size);
-    } else {
-        char* toRet = chunk->_chunk + chunk->_offset;
-        chunk->_offset += size;
-        return static_cast<void*>(toRet);
+void* MemoryChunk::alloc(MemoryChunk*& chunk, size_t size, size_t alignment, const ChunkPolicy& policy) {
+    if (void* ptr = chunk->tryAlloc(size, alignment)) {
+        return ptr;
+    }
+
+    // enough to hold the object whatever the alignment of the chunk's memory
+    size_t required = size + alignment - 1;
+
+    if (size > policy.largeObjectSize || required > policy.maxChunkSize) {
+        chunk->_parent = new MemoryChunk(required, chunk->_parent);
+        return chunk->_parent->tryAlloc(size, alignment);
     }
+
+    size_t newSize = std::min(chunk->_chunkSize * policy.growthFactor, policy.maxChunkSize);
+    chunk = new MemoryChunk(std::max(newSize, required), chunk);
+    return chunk->tryAlloc(size, alignment);
 }
 
 const MemoryChunk* MemoryChunk::getParent() const {
@@ -61,9 +91,50 @@ size_t MemoryChunk::getUsedChunkSize() const {
     return _offset;
 }
 
+void* MemoryChunk::tryAlloc(size_t size, size_t alignment) {
+    size_t misalignment = reinterpret_cast<uintptr_t>(_chunk + _offset) & (alignment - 1);
+    size_t padding = misalignment ? alignment - misalignment : 0;
+
+    if (padding > _chunkSize - _offset || size > _chunkSize - _offset - padding) {
+        return nullptr;
+    }
+
+    char* toRet = _chunk + _offset + padding;
+    _offset += padding + size;
+    return static_cast<void*>(toRet);
+}
+
 // CHUNKED MEMORY MANAGER
 
-ChunkedMemoryManager::ChunkedMemoryManager(size_t chunksSize) : _lastChunk(new MemoryChunk(chunksSize, nullptr)) {
+namespace {
+
+struct ChunkTotals final {
+    size_t count;
+    size_t used;
+    size_t reserved;
+};
+
+void addChunkTotals(const MemoryChunk* chain, ChunkTotals& totals) {
+    for (const MemoryChunk* cur = chain; cur != nullptr; cur = cur->getParent()) {
+        ++totals.count;
+        totals.used += cur->getUsedChunkSize();
+        totals.reserved += cur->getChunkSize();
+    }
+}
+
+inline void account(MemoryStats& stats, MEMORY_CATEGORY category, size_t size) {
+    stats.categories[category].bytes += size;
+    ++stats.categories[category].objects;
+}
+
+}
+
+ChunkedMemoryManager::ChunkedMemoryManager(size_t chunksSize) : ChunkedMemoryManager(ChunkPolicy(chunksSize)) {
+
+}
+
+ChunkedMemoryManager::ChunkedMemoryManager(const ChunkPolicy& policy)
+    : _policy(policy), _lastChunk(new MemoryChunk(policy.initialChunkSize, nullptr)) {
 
 }
 
@@ -77,27 +148,193 @@ ChunkedMemoryManager::~ChunkedMemoryManager() {
 std::string ChunkedMemoryManager::getInfos() const {
     std::string toRet = "ChunkedMemoryManager{";
 
-    size_t chunkCount = 0, totalUsedSize = 0, totalChunkSize = 0;
-    for (const MemoryChunk* cur = _lastChunk; cur != nullptr; cur = cur->getParent()) {
-        ++chunkCount;
-        totalUsedSize += cur->getUsedChunkSize();
-        totalChunkSize += cur->getChunkSize();
-    }
+    ChunkTotals totals{0, 0, 0};
+    addChunkTotals(_lastChunk, totals);
 
-    toRet += utils::T_toString(chunkCount) + " chunks; ";
-    toRet += utils::T_toString(_allocated.size()) + " objects; ";
-    toRet += utils::T_toString(totalUsedSize) + "/";
-    toRet += utils::T_toString(totalChunkSize) + " bytes}";
+    toRet += utils::T_toString(totals.count) + " chunks; ";
+    toRet += utils::T_toString(_stats.total().objects) + " objects; ";
+    toRet += utils::T_toString(totals.used) + "/";
+    toRet += utils::T_toString(totals.reserved) + " bytes}";
     return toRet;
 }
 
-MemoryManageable* ChunkedMemoryManager::alloc(size_t size) {
-    MemoryManageable* ptr = reinterpret_cast<MemoryManageable*>(MemoryChunk::alloc(_lastChunk, size));
+MemoryStats ChunkedMemoryManager::getStats() const {
+    ChunkTotals totals{0, 0, 0};
+    addChunkTotals(_lastChunk, totals);
+
+    MemoryStats stats(_stats);
+    stats.reservedBytes = totals.reserved;
+    return stats;
+}
+
+MemoryManageable* ChunkedMemoryManager::alloc(size_t size, size_t alignment, MEMORY_CATEGORY category) {
+    MemoryManageable* ptr = reinterpret_cast<MemoryManageable*>(MemoryChunk::alloc(_lastChunk, size, alignment, _policy));
     _allocated.push_back(ptr);
+    account(_stats, category, size);
+    return ptr;
+}
+
+void* ChunkedMemoryManager::allocUntracked(size_t size, size_t alignment, MEMORY_CATEGORY category) {
+    account(_stats, category, size);
+    return MemoryChunk::alloc(_lastChunk, size, alignment, _policy);
+}
+
+// CONCURRENT MEMORY MANAGER
+
+/**
+ * Generations identify a state of the arenas of a given manager: a thread can keep using
+ * its cached arena as long as the generation of the manager has not changed.
+ * They are unique across all the managers so that a new manager created at the address
+ * of a destroyed one is never mistaken for it.
+ */
+static std::atomic<uint64_t> nextGeneration(1);
+
+thread_local ConcurrentMemoryManager::ArenaCache ConcurrentMemoryManager::_threadCache = {0, nullptr};
+
+struct ConcurrentMemoryManager::Arena final {
+    Arena(size_t chunksSize) : lastChunk(new MemoryChunk(chunksSize, nullptr)) {}
+
+    ~Arena() {
+        delete lastChunk;
+        for (MemoryChunk* chunk : adoptedChunks) {
+            delete chunk;
+        }
+    }
+
+    void destroyObjects() {
+        for (auto ptr : allocated) {
+            ptr->~MemoryManageable();
+        }
+        allocated.clear();
+    }
+
+    void addChunkTotals(ChunkTotals& totals) const {
+        sfsl::common::addChunkTotals(lastChunk, totals);
+        for (const MemoryChunk* chain : adoptedChunks) {
+            sfsl::common::addChunkTotals(chain, totals);
+        }
+    }
+
+    MemoryChunk* lastChunk;
+    std::vector<MemoryChunk*> adoptedChunks;
+    std::vector<MemoryManageable*> allocated;
+    MemoryStats stats;
+};
+
+ConcurrentMemoryManager::ConcurrentMemoryManager(size_t chunksSize) : ConcurrentMemoryManager(ChunkPolicy(chunksSize)) {
+
+}
+
+ConcurrentMemoryManager::ConcurrentMemoryManager(const ChunkPolicy& policy)
+    : _policy(policy), _generation(nextGeneration++) {
+
+}
+
+ConcurrentMemoryManager::~ConcurrentMemoryManager() {
+    // objects may still refer to objects of other arenas, so every destructor runs before any chunk is freed
+    for (auto& arena : _arenas) {
+        arena.second->destroyObjects();
+    }
+}
+
+std::string ConcurrentMemoryManager::getInfos() const {
+    std::lock_guard<std::mutex> lock(_arenasMutex);
+
+    std::string toRet = "ConcurrentMemoryManager{";
+
+    ChunkTotals totals{0, 0, 0};
+    size_t objectCount = 0;
+
+    for (const auto& entry : _arenas) {
+        entry.second->addChunkTotals(totals);
+        objectCount += entry.second->stats.total().objects;
+    }
+
+    toRet += utils::T_toString(_arenas.size()) + " arenas; ";
+    toRet += utils::T_toString(totals.count) + " chunks; ";
+    toRet += utils::T_toString(objectCount) + " objects; ";
+    toRet += utils::T_toString(totals.used) + "/";
+    toRet += utils::T_toString(totals.reserved) + " bytes}";
+    return toRet;
+}
+
+MemoryStats ConcurrentMemoryManager::getStats() const {
+    std::lock_guard<std::mutex> lock(_arenasMutex);
+
+    ChunkTotals totals{0, 0, 0};
+    MemoryStats stats;
+
+    for (const auto& entry : _arenas) {
+        entry.second->addChunkTotals(totals);
+        stats = stats + entry.second->stats;
+    }
+
+    stats.reservedBytes = totals.reserved;
+    return stats;
+}
+
+void ConcurrentMemoryManager::mergeThreadArenas() {
+    std::lock_guard<std::mutex> lock(_arenasMutex);
+
+    std::unique_ptr<Arena>& own(_arenas[std::this_thread::get_id()]);
+    if (!own) {
+        own.reset(new Arena(_policy.initialChunkSize));
+    }
+
+    for (auto it = _arenas.begin(); it != _arenas.end();) {
+        if (it->second == own) {
+            ++it;
+            continue;
+        }
+
+        Arena& other(*it->second);
+
+        own->adoptedChunks.push_back(other.lastChunk);
+        own->adoptedChunks.insert(own->adoptedChunks.end(), other.adoptedChunks.begin(), other.adoptedChunks.end());
+        own->allocated.insert(own->allocated.end(), other.allocated.begin(), other.allocated.end());
+        own->stats = own->stats + other.stats;
+
+        other.lastChunk = nullptr;
+        other.adoptedChunks.clear();
+        other.allocated.clear();
+
+        it = _arenas.erase(it);
+    }
+
+    // invalidates the arenas cached by the threads
+    _generation = nextGeneration++;
+}
+
+inline ConcurrentMemoryManager::Arena* ConcurrentMemoryManager::threadArena() {
+    return _threadCache.generation == _generation ? _threadCache.arena : lookupThreadArena();
+}
+
+MemoryManageable* ConcurrentMemoryManager::alloc(size_t size, size_t alignment, MEMORY_CATEGORY category) {
+    Arena* arena = threadArena();
+    MemoryManageable* ptr = reinterpret_cast<MemoryManageable*>(MemoryChunk::alloc(arena->lastChunk, size, alignment, _policy));
+    arena->allocated.push_back(ptr);
+    account(arena->stats, category, size);
     return ptr;
 }
 
+void* ConcurrentMemoryManager::allocUntracked(size_t size, size_t alignment, MEMORY_CATEGORY category) {
+    Arena* arena = threadArena();
+    account(arena->stats, category, size);
+    return MemoryChunk::alloc(arena->lastChunk, size, alignment, _policy);
+}
+
+ConcurrentMemoryManager::Arena* ConcurrentMemoryManager::lookupThreadArena() {
+    std::lock_guard<std::mutex> lock(_arenasMutex);
 
+    std::unique_ptr<Arena>& arena(_arenas[std::this_thread::get_id()]);
+    if (!arena) {
+        arena.reset(new Arena(_policy.initialChunkSize));
+    }
+
+    _threadCache.generation = _generation;
+    _threadCache.arena = arena.get();
+    return arena.get();
+}
 
 }
 
@@ -11,6 +11,11 @@
 
 #include <iostream>
 #include <vector>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <cstdint>
 #include "MemoryManageable.h"
 
 namespace sfsl {
@@ -37,7 +42,10 @@ public:
      * @return A pointer to the instance
      */
     T* New(Args... args) {
-        return new(alloc(sizeof(T))) T(std::forward<Args>(args)...);
+        void* ptr = IsTriviallyManageable<T>::value
+                ? allocUntracked(sizeof(T), alignof(T), T::MemoryCategory)
+                : alloc(sizeof(T), alignof(T), T::MemoryCategory);
+        return new(ptr) T(std::forward<Args>(args)...);
     }
 
     /**
@@ -47,14 +55,36 @@ public:
      */
     virtual std::string getInfos() const;
 
+    /**
+     * @brief Returns the memory allocated so far, by category of objects.
+     * Implementations which don't account for it return empty stats.
+     * Must not be called while other threads are allocating through this manager.
+     * @return The memory stats
+     */
+    virtual MemoryStats getStats() const;
+
 protected:
 
     /**
      * @brief Allocates a space of size given in parameter by the desired way
      * @param size The size to allocate
+     * @param alignment The alignment required by the object, a power of two
+     * @param category The category of the object, for accounting purposes
+     * @return A pointer to the free space
+     */
+    virtual MemoryManageable* alloc(size_t size, size_t alignment, MEMORY_CATEGORY category) = 0;
+
+    /**
+     * @brief Allocates space for an object whose destructor doesn't need to be called,
+     * so that it can be freed along with the rest of the memory without being tracked.
+     * Falls back to #alloc by default.
+     *
+     * @param size The size to allocate
+     * @param alignment The alignment required by the object, a power of two
+     * @param category The category of the object, for accounting purposes
      * @return A pointer to the free space
      */
-    virtual MemoryManageable* alloc(size_t size) = 0;
+    virtual void* allocUntracked(size_t size, size_t alignment, MEMORY_CATEGORY category);
 
 };
 
@@ -79,7 +109,8 @@ public:
 
 private:
 
-    virtual MemoryManageable* alloc(size_t size) override {
+    // new[] returns storage suitably aligned for any fundamental type
+    virtual MemoryManageable* alloc(size_t size, size_t, MEMORY_CATEGORY) override {
         MemoryManageable* ptr = reinterpret_cast<MemoryManageable*>(new char[size]);
         _allocated.push_back(ptr);
         return ptr;
@@ -94,6 +125,23 @@ private:
     Collection_t<MemoryManageable*, Allocator> _allocated;
 };
 
+/**
+ * @brief Describes how the memory chunks of a chunked memory manager are sized.
+ * The first chunk has the initial size, and each new chunk is `growthFactor` times
+ * larger than the previous one, up to `maxChunkSize`. Objects larger than `largeObjectSize`
+ * get a chunk of their own, so that they neither force the growth of the chunks nor
+ * waste the end of the current one.
+ */
+struct ChunkPolicy final {
+    ChunkPolicy(size_t initialChunkSize = 2048, size_t maxChunkSize = 1 << 20,
+                size_t growthFactor = 2, size_t largeObjectSize = 1024);
+
+    size_t initialChunkSize;
+    size_t maxChunkSize;
+    size_t growthFactor;
+    size_t largeObjectSize;
+};
+
 /**
  * @brief Represents a block of memory. It contains a pointer to its parent
  * so that they are destroyed in chain when the last one is destroyed.
@@ -111,14 +159,17 @@ public:
 
     /**
      * @brief Allocates the desired memory in the chunk given in parameter if it contains enough space,
-     * otherwise creates an new chunk (and modifies the reference given so that it refers to the new one)
-     * and allocates space in this one.
+     * otherwise creates an new chunk as described by the policy (and modifies the reference given
+     * so that it refers to the new one) and allocates space in this one. Large objects are allocated
+     * in a dedicated chunk which is inserted behind the given one, which stays the current chunk.
      *
      * @param chunk The MemoryChunk from which to allocate memory
      * @param size The size of the object to be allocated
+     * @param alignment The alignment of the object to be allocated, a power of two
+     * @param policy The policy used to size new chunks
      * @return A pointer to the allocated space
      */
-    static void* alloc(MemoryChunk*& chunk, size_t size);
+    static void* alloc(MemoryChunk*& chunk, size_t size, size_t alignment, const ChunkPolicy& policy);
 
     /**
      * @return The parent of this memory chunk
@@ -137,6 +188,11 @@ public:
 
 private:
 
+    /**
+     * @return The allocated space if it fits in the remaining space of this chunk, nullptr otherwise
+     */
+    void* tryAlloc(size_t size, size_t alignment);
+
     char* _chunk;
     size_t _chunkSize;
     size_t _offset;
@@ -152,20 +208,87 @@ public:
 
     /**
      * @brief Creates a ChunkedMemoryManager
-     * @param chunksSize The size that will have each chunk of memory
+     * @param chunksSize The size that will have the first chunk of memory
      */
     ChunkedMemoryManager(size_t chunksSize);
 
+    /**
+     * @brief Creates a ChunkedMemoryManager
+     * @param policy The policy used to size the chunks of memory
+     */
+    ChunkedMemoryManager(const ChunkPolicy& policy);
+
     virtual ~ChunkedMemoryManager();
 
     virtual std::string getInfos() const override;
+    virtual MemoryStats getStats() const override;
 
 private:
 
-    virtual MemoryManageable* alloc(size_t size) override;
+    virtual MemoryManageable* alloc(size_t size, size_t alignment, MEMORY_CATEGORY category) override;
+    virtual void* allocUntracked(size_t size, size_t alignment, MEMORY_CATEGORY category) override;
 
+    const ChunkPolicy _policy;
     MemoryChunk* _lastChunk;
     std::vector<MemoryManageable*> _allocated;
+    MemoryStats _stats;
+};
+
+/**
+ * @brief Represents a concrete MemoryManager object which can be used by several threads at once.
+ * Each thread allocates in its own arena of memory chunks, so that no lock is taken except
+ * the first time a thread allocates. The objects of all the arenas are freed when the
+ * manager is destroyed.
+ */
+class ConcurrentMemoryManager : public AbstractMemoryManager {
+public:
+
+    /**
+     * @brief Creates a ConcurrentMemoryManager
+     * @param chunksSize The size that will have the first chunk of memory of each thread
+     */
+    ConcurrentMemoryManager(size_t chunksSize);
+
+    /**
+     * @brief Creates a ConcurrentMemoryManager
+     * @param policy The policy used to size the chunks of memory of each thread
+     */
+    ConcurrentMemoryManager(const ChunkPolicy& policy);
+
+    virtual ~ConcurrentMemoryManager();
+
+    virtual std::string getInfos() const override;
+    virtual MemoryStats getStats() const override;
+
+    /**
+     * @brief Transfers the ownership of everything that was allocated by the other threads
+     * to the arena of the calling thread, so that their arenas are not kept around
+     * and the thread ids can be reused. Must only be called once these threads are joined.
+     */
+    void mergeThreadArenas();
+
+private:
+
+    struct Arena;
+
+    struct ArenaCache final {
+        uint64_t generation;
+        Arena* arena;
+    };
+
+    virtual MemoryManageable* alloc(size_t size, size_t alignment, MEMORY_CATEGORY category) override;
+    virtual void* allocUntracked(size_t size, size_t alignment, MEMORY_CATEGORY category) override;
+
+    Arena* threadArena();
+    Arena* lookupThreadArena();
+
+    const ChunkPolicy _policy;
+    uint64_t _generation;
+
+    mutable std::mutex _arenasMutex;
+    std::map<std::thread::id, std::unique_ptr<Arena>> _arenas;
+
+    static thread_local ArenaCache _threadCache;
 };
 
 }
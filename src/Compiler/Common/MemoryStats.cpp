@@ -0,0 +1,85 @@
+//
+//  MemoryStats.cpp
+//  SFSL
+//
+//  Created by Romain Beguet on 19.10.16.
+//  Copyright (c) 2016 Romain Beguet. All rights reserved.
+//
+
+#include "MemoryStats.h"
+
+namespace sfsl {
+
+namespace common {
+
+static void writeUsage(std::ostream& o, const MemoryUsage& usage) {
+    o << "{\"bytes\": " << usage.bytes << ", \"objects\": " << usage.objects << "}";
+}
+
+MemoryStats::MemoryStats() : categories(), environmentCopies{0, 0}, reservedBytes(0) {
+
+}
+
+MemoryUsage MemoryStats::total() const {
+    MemoryUsage res{0, 0};
+    for (const MemoryUsage& usage : categories) {
+        res.bytes += usage.bytes;
+        res.objects += usage.objects;
+    }
+    return res;
+}
+
+MemoryStats MemoryStats::operator+(const MemoryStats& other) const {
+    MemoryStats res;
+    for (size_t i = 0; i < MEM_CATEGORY_COUNT; ++i) {
+        res.categories[i].bytes = categories[i].bytes + other.categories[i].bytes;
+        res.categories[i].objects = categories[i].objects + other.categories[i].objects;
+    }
+    res.environmentCopies.bytes = environmentCopies.bytes + other.environmentCopies.bytes;
+    res.environmentCopies.objects = environmentCopies.objects + other.environmentCopies.objects;
+    res.reservedBytes = reservedBytes + other.reservedBytes;
+    return res;
+}
+
+MemoryStats MemoryStats::operator-(const MemoryStats& other) const {
+    MemoryStats res;
+    for (size_t i = 0; i < MEM_CATEGORY_COUNT; ++i) {
+        res.categories[i].bytes = categories[i].bytes - other.categories[i].bytes;
+        res.categories[i].objects = categories[i].objects - other.categories[i].objects;
+    }
+    res.environmentCopies.bytes = environmentCopies.bytes - other.environmentCopies.bytes;
+    res.environmentCopies.objects = environmentCopies.objects - other.environmentCopies.objects;
+    res.reservedBytes = reservedBytes - other.reservedBytes;
+    return res;
+}
+
+void MemoryStats::writeJSON(std::ostream& o) const {
+    o << "{\"reservedBytes\": " << reservedBytes << ", \"total\": ";
+    writeUsage(o, total());
+    o << ", \"categories\": {";
+
+    for (size_t i = 0; i < MEM_CATEGORY_COUNT; ++i) {
+        o << (i == 0 ? "" : ", ") << "\"" << categoryName((MEMORY_CATEGORY)i) << "\": ";
+        writeUsage(o, categories[i]);
+    }
+
+    o << "}, \"environmentCopies\": ";
+    writeUsage(o, environmentCopies);
+    o << "}";
+}
+
+std::string MemoryStats::categoryName(MEMORY_CATEGORY category) {
+    switch (category) {
+    case MEM_AST:       return "ast";
+    case MEM_SYMBOL:    return "symbols";
+    case MEM_TYPE:      return "types";
+    case MEM_KIND:      return "kinds";
+    case MEM_BAST:      return "bast";
+    case MEM_BYTECODE:  return "bytecode";
+    default:            return "other";
+    }
+}
+
+}
+
+}
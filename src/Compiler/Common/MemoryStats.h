@@ -0,0 +1,83 @@
+//
+//  MemoryStats.h
+//  SFSL
+//
+//  Created by Romain Beguet on 19.10.16.
+//  Copyright (c) 2016 Romain Beguet. All rights reserved.
+//
+
+#ifndef __SFSL__MemoryStats__
+#define __SFSL__MemoryStats__
+
+#include <iostream>
+#include <string>
+
+namespace sfsl {
+
+namespace common {
+
+/**
+ * @brief The categories in which the objects allocated through a memory manager are accounted.
+ * The category of a #sfsl::common::MemoryManageable type is given by its static `MemoryCategory`
+ * member, which the base classes of the different families of objects redefine.
+ */
+enum MEMORY_CATEGORY {
+    MEM_AST, MEM_SYMBOL, MEM_TYPE, MEM_KIND, MEM_BAST, MEM_BYTECODE, MEM_OTHER,
+    MEM_CATEGORY_COUNT
+};
+
+/**
+ * @brief An amount of memory, and the number of objects it is made of
+ */
+struct MemoryUsage final {
+    size_t bytes;
+    size_t objects;
+};
+
+/**
+ * @brief A snapshot of the memory used during the compilation.
+ * The difference of two snapshots gives the memory allocated in between.
+ */
+struct MemoryStats final {
+    MemoryStats();
+
+    /**
+     * @return The sum of all the categories
+     */
+    MemoryUsage total() const;
+
+    MemoryStats operator+(const MemoryStats& other) const;
+    MemoryStats operator-(const MemoryStats& other) const;
+
+    /**
+     * @brief Writes the stats as a JSON object
+     */
+    void writeJSON(std::ostream& o) const;
+
+    /**
+     * @return The name of the category, as used in the JSON output
+     */
+    static std::string categoryName(MEMORY_CATEGORY category);
+
+    /**
+     * @brief The memory used by the objects of each category
+     */
+    MemoryUsage categories[MEM_CATEGORY_COUNT];
+
+    /**
+     * @brief The heap memory used by the copies of type environments, which
+     * are not allocated through the memory manager. Accounted process wide.
+     */
+    MemoryUsage environmentCopies;
+
+    /**
+     * @brief The size of the chunks reserved by the memory manager, including the unused space
+     */
+    size_t reservedBytes;
+};
+
+}
+
+}
+
+#endif
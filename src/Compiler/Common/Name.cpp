@@ -0,0 +1,156 @@
+//
+//  Name.cpp
+//  SFSL
+//
+//  Created by Romain Beguet on 21.10.16.
+//  Copyright (c) 2016 Romain Beguet. All rights reserved.
+//
+
+#include <cstring>
+#include <cstdint>
+#include "Name.h"
+
+#define NAME_TABLE_INITIAL_SLOTS 256
+
+namespace sfsl {
+
+namespace common {
+
+// NAME
+
+const Name::Entry Name::EMPTY = {"", 0};
+
+Name::Name() : _entry(&EMPTY) {
+
+}
+
+Name::Name(const Entry* entry) : _entry(entry) {
+
+}
+
+const std::string& Name::str() const {
+    return _entry->str;
+}
+
+size_t Name::hash() const {
+    return _entry->hash;
+}
+
+Name::operator const std::string&() const {
+    return _entry->str;
+}
+
+bool Name::operator==(const Name& other) const {
+    return _entry == other._entry;
+}
+
+bool Name::operator!=(const Name& other) const {
+    return _entry != other._entry;
+}
+
+bool Name::operator<(const Name& other) const {
+    if (_entry == other._entry) {
+        return false;
+    } else if (_entry->hash != other._entry->hash) {
+        return _entry->hash < other._entry->hash;
+    } else {
+        return _entry->str < other._entry->str;
+    }
+}
+
+std::ostream& operator<<(std::ostream& o, const Name& name) {
+    return o << name.str();
+}
+
+std::string operator+(const std::string& lhs, const Name& rhs) {
+    return lhs + rhs.str();
+}
+
+std::string operator+(const char* lhs, const Name& rhs) {
+    return lhs + rhs.str();
+}
+
+std::string operator+(const Name& lhs, const std::string& rhs) {
+    return lhs.str() + rhs;
+}
+
+std::string operator+(const Name& lhs, const char* rhs) {
+    return lhs.str() + rhs;
+}
+
+// NAME TABLE
+
+NameTable::NameTable() : _slots(NAME_TABLE_INITIAL_SLOTS, nullptr) {
+
+}
+
+NameTable::~NameTable() {
+
+}
+
+Name NameTable::intern(const char* str, size_t size) {
+    if (size == 0) {
+        return Name();
+    }
+
+    size_t hash = hashString(str, size);
+
+    std::lock_guard<std::mutex> lock(_mutex);
+
+    size_t mask = _slots.size() - 1;
+
+    for (size_t i = hash & mask;; i = (i + 1) & mask) {
+        const Name::Entry* entry = _slots[i];
+
+        if (!entry) {
+            _entries.push_back(Name::Entry{std::string(str, size), hash});
+            _slots[i] = entry = &_entries.back();
+
+            // keep the load factor under 1/2
+            if (_entries.size() * 2 > _slots.size()) {
+                grow();
+            }
+
+            return Name(entry);
+        } else if (entry->hash == hash && entry->str.size() == size && std::memcmp(entry->str.data(), str, size) == 0) {
+            return Name(entry);
+        }
+    }
+}
+
+Name NameTable::intern(const std::string& str) {
+    return intern(str.data(), str.size());
+}
+
+size_t NameTable::size() const {
+    std::lock_guard<std::mutex> lock(_mutex);
+    return _entries.size();
+}
+
+size_t NameTable::hashString(const char* str, size_t size) {
+    // FNV-1a
+    uint64_t hash = 14695981039346656037ull;
+    for (size_t i = 0; i < size; ++i) {
+        hash = (hash ^ (unsigned char)str[i]) * 1099511628211ull;
+    }
+    return (size_t)(hash ^ (hash >> 32));
+}
+
+void NameTable::grow() {
+    std::vector<const Name::Entry*> slots(_slots.size() * 2, nullptr);
+    size_t mask = slots.size() - 1;
+
+    for (const Name::Entry& entry : _entries) {
+        size_t i = entry.hash & mask;
+        while (slots[i]) {
+            i = (i + 1) & mask;
+        }
+        slots[i] = &entry;
+    }
+
+    _slots.swap(slots);
+}
+
+}
+
+}
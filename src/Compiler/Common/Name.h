@@ -0,0 +1,135 @@
+//
+//  Name.h
+//  SFSL
+//
+//  Created by Romain Beguet on 21.10.16.
+//  Copyright (c) 2016 Romain Beguet. All rights reserved.
+//
+
+#ifndef __SFSL__Name__
+#define __SFSL__Name__
+
+#include <iostream>
+#include <string>
+#include <vector>
+#include <deque>
+#include <mutex>
+#include <functional>
+
+namespace sfsl {
+
+namespace common {
+
+/**
+ * @brief A string interned in a #sfsl::common::NameTable. Two names from the same
+ * table are equal if and only if they point to the same entry, so comparing and
+ * hashing them never looks at their characters.
+ */
+class Name final {
+public:
+
+    /**
+     * @brief Creates the empty name, which is shared by all the tables
+     */
+    Name();
+
+    /**
+     * @return The characters of the name
+     */
+    const std::string& str() const;
+
+    /**
+     * @return The hash of the characters of the name, computed when it was interned
+     */
+    size_t hash() const;
+
+    operator const std::string&() const;
+
+    bool operator==(const Name& other) const;
+    bool operator!=(const Name& other) const;
+
+    /**
+     * @brief Orders names by hash, and by their characters when the hashes are equal.
+     * The order is stable from a compilation to another but is not the alphabetical order.
+     */
+    bool operator<(const Name& other) const;
+
+private:
+
+    friend class NameTable;
+
+    struct Entry final {
+        std::string str;
+        size_t hash;
+    };
+
+    Name(const Entry* entry);
+
+    static const Entry EMPTY;
+
+    const Entry* _entry;
+};
+
+std::ostream& operator<<(std::ostream& o, const Name& name);
+
+std::string operator+(const std::string& lhs, const Name& rhs);
+std::string operator+(const char* lhs, const Name& rhs);
+std::string operator+(const Name& lhs, const std::string& rhs);
+std::string operator+(const Name& lhs, const char* rhs);
+
+/**
+ * @brief The table in which the names of a compilation are interned.
+ * Interning is thread safe.
+ */
+class NameTable final {
+public:
+
+    NameTable();
+    NameTable(const NameTable& other) = delete;
+    ~NameTable();
+
+    /**
+     * @param str The first character of the string to intern
+     * @param size The number of characters of the string
+     * @return The name of the string, created the first time the string is interned
+     */
+    Name intern(const char* str, size_t size);
+
+    /**
+     * @param str The string to intern
+     * @return The name of the string, created the first time the string is interned
+     */
+    Name intern(const std::string& str);
+
+    /**
+     * @return The number of distinct names in the table
+     */
+    size_t size() const;
+
+private:
+
+    static size_t hashString(const char* str, size_t size);
+
+    void grow();
+
+    mutable std::mutex _mutex;
+    std::deque<Name::Entry> _entries;
+    std::vector<const Name::Entry*> _slots;
+};
+
+}
+
+}
+
+namespace std {
+
+template<>
+struct hash<sfsl::common::Name> {
+    size_t operator()(const sfsl::common::Name& name) const {
+        return name.hash();
+    }
+};
+
+}
+
+#endif
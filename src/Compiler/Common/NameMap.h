@@ -0,0 +1,132 @@
+//
+//  NameMap.h
+//  SFSL
+//
+//  Created by Romain Beguet on 24.10.16.
+//  Copyright (c) 2016 Romain Beguet. All rights reserved.
+//
+
+#ifndef __SFSL__NameMap__
+#define __SFSL__NameMap__
+
+#include <vector>
+#include "Name.h"
+
+namespace sfsl {
+
+namespace common {
+
+template<typename V>
+/**
+ * @brief A hash map from names to values using open addressing with linear probing.
+ * Since names are interned, finding a key costs one probe in most cases and never
+ * compares any characters. Entries cannot be removed one by one.
+ */
+class NameMap final {
+public:
+
+    NameMap() : _size(0) {
+
+    }
+
+    /**
+     * @param name The name to look for
+     * @return The value associated to the name, or nullptr if there is none
+     */
+    V* find(Name name) {
+        if (_slots.empty()) {
+            return nullptr;
+        }
+        Slot& slot = _slots[indexOf(name)];
+        return slot.used ? &slot.value : nullptr;
+    }
+
+    /**
+     * @param name The name to look for
+     * @return The value associated to the name, or nullptr if there is none
+     */
+    const V* find(Name name) const {
+        return const_cast<NameMap*>(this)->find(name);
+    }
+
+    /**
+     * @param name The name to look for
+     * @return The value associated to the name, which is default constructed
+     * if the name was not in the map yet
+     */
+    V& operator[](Name name) {
+        // keep the load factor under 1/2
+        if ((_size + 1) * 2 > _slots.size()) {
+            grow();
+        }
+
+        Slot& slot = _slots[indexOf(name)];
+
+        if (!slot.used) {
+            slot.key = name;
+            slot.used = true;
+            ++_size;
+        }
+
+        return slot.value;
+    }
+
+    /**
+     * @return The number of names in the map
+     */
+    size_t size() const {
+        return _size;
+    }
+
+    /**
+     * @brief Removes all the entries of the map and releases its memory
+     */
+    void clear() {
+        std::vector<Slot>().swap(_slots);
+        _size = 0;
+    }
+
+private:
+
+    struct Slot final {
+        Slot() : value(), used(false) { }
+
+        Name key;
+        V value;
+        bool used;
+    };
+
+    size_t indexOf(Name name) const {
+        size_t mask = _slots.size() - 1;
+        size_t i = name.hash() & mask;
+
+        while (_slots[i].used && _slots[i].key != name) {
+            i = (i + 1) & mask;
+        }
+
+        return i;
+    }
+
+    void grow() {
+        std::vector<Slot> slots(_slots.empty() ? 8 : _slots.size() * 2);
+        slots.swap(_slots);
+
+        for (Slot& slot : slots) {
+            if (slot.used) {
+                Slot& target = _slots[indexOf(slot.key)];
+                target.key = slot.key;
+                target.value = std::move(slot.value);
+                target.used = true;
+            }
+        }
+    }
+
+    std::vector<Slot> _slots;
+    size_t _size;
+};
+
+}
+
+}
+
+#endif
@@ -26,8 +26,8 @@ Positionnable::~Positionnable() {
 }
 
 void Positionnable::setPos(size_t startPos, size_t endPos, src::InputSourceName source) {
-    _startPos = startPos;
-    _endPos = endPos;
+    _startPos = static_cast<uint32_t>(startPos);
+    _endPos = static_cast<uint32_t>(endPos);
     _source = source;
 }
 
@@ -36,11 +36,11 @@ void Positionnable::setPos(const Positionnable& other) {
 }
 
 void Positionnable::setStartPos(size_t startPos) {
-    _startPos = startPos;
+    _startPos = static_cast<uint32_t>(startPos);
 }
 
 void Positionnable::setEndPos(size_t endPos) {
-    _endPos = endPos;
+    _endPos = static_cast<uint32_t>(endPos);
 }
 
 size_t Positionnable::getStartPosition() const{
@@ -56,6 +56,12 @@ src::InputSourceName Positionnable::getSourceName() const {
 }
 
 std::string Positionnable::positionStr() const {
+    size_t line, column;
+
+    if (_source.getInfo().lineAndColumn(_startPos, line, column)) {
+        return _source.getName() + ":" + utils::T_toString(line) + ":" + utils::T_toString(column);
+    }
+
     return _source.getName() + ":" + utils::T_toString(_startPos) + ":" + utils::T_toString(_endPos);
 }
 
@@ -10,6 +10,7 @@
 #define __SFSL__Positionnable__
 
 #include <iostream>
+#include <cstdint>
 #include "../Frontend/Lexer/InputSourceName.h"
 
 namespace sfsl {
@@ -18,7 +19,8 @@ namespace common {
 
 /**
  * @brief An interface that represents an object that is bound
- * to a position (a position in its source and the name of this source)
+ * to a position (a position in its source and the name of this source).
+ * Positions are stored on 32 bits, so sources are limited to 4GB.
  */
 class Positionnable {
 public:
@@ -78,14 +80,15 @@ public:
     src::InputSourceName getSourceName() const;
 
     /**
-     * @return A readable representation of the position
+     * @return A readable representation of the position, with the line and the column
+     * of its start if the line index of its source is known, or its offsets otherwise
      */
     std::string positionStr() const;
 
 private:
 
-    size_t _startPos;
-    size_t _endPos;
+    uint32_t _startPos;
+    uint32_t _endPos;
     src::InputSourceName _source;
 };
 
@@ -56,6 +56,60 @@ void StandartErrReporter::reportMessage(const std::string& prefix, const Positio
     std::cerr << pos.positionStr() << ":" << prefix << ":" << msg << std::endl;
 }
 
+struct BufferedReporter::Message final {
+    MESSAGE_KIND kind;
+    Positionnable pos;
+    std::string msg;
+};
+
+BufferedReporter::BufferedReporter() {
+    _errorCount = 0;
+}
+
+BufferedReporter::~BufferedReporter() {
+
+}
+
+void BufferedReporter::info(const Positionnable& pos, const std::string& msg) {
+    bufferMessage(MSG_INFO, pos, msg);
+}
+
+void BufferedReporter::warning(const Positionnable& pos, const std::string& msg) {
+    bufferMessage(MSG_WARNING, pos, msg);
+}
+
+void BufferedReporter::error(const Positionnable& pos, const std::string& msg) {
+    bufferMessage(MSG_ERROR, pos, msg);
+    ++_errorCount;
+}
+
+void BufferedReporter::fatal(const Positionnable& pos, const std::string& msg) {
+    bufferMessage(MSG_FATAL, pos, msg);
+    ++_errorCount;
+    AbstractReporter::fatal(pos, msg);
+}
+
+void BufferedReporter::replayTo(AbstractReporter& target) const {
+    for (const std::unique_ptr<Message>& message : _messages) {
+        switch (message->kind) {
+        case MSG_INFO:      target.info(message->pos, message->msg); break;
+        case MSG_WARNING:   target.warning(message->pos, message->msg); break;
+        case MSG_ERROR:     target.error(message->pos, message->msg); break;
+        case MSG_FATAL:
+            try {
+                target.fatal(message->pos, message->msg);
+            } catch (const CompilationFatalError&) {
+                // the caller decides what to do with the fatal error
+            }
+            break;
+        }
+    }
+}
+
+void BufferedReporter::bufferMessage(MESSAGE_KIND kind, const Positionnable& pos, const std::string& msg) {
+    _messages.emplace_back(new Message{kind, pos, msg});
+}
+
 }
 
 }
@@ -11,6 +11,8 @@
 
 #include <iostream>
 #include <stdexcept>
+#include <vector>
+#include <memory>
 
 namespace sfsl {
 
@@ -94,6 +96,48 @@ private:
 
 };
 
+/**
+ * @brief An implementation of AbstractReporter that keeps the reported messages until
+ * they are replayed to another reporter. It allows a part of the compilation to run in
+ * its own thread while its messages are reported in a deterministic order.
+ * #BufferedReporter.fatal throws an exception of type #CompilationFatalError.
+ */
+class BufferedReporter : public AbstractReporter {
+public:
+
+    /**
+     * @brief Creates a BufferedReporter
+     */
+    BufferedReporter();
+    virtual ~BufferedReporter();
+
+    virtual void info(const Positionnable& pos, const std::string& msg) override;
+
+    virtual void warning(const Positionnable& pos, const std::string& msg) override;
+
+    virtual void error(const Positionnable& pos, const std::string& msg) override;
+
+    virtual void fatal(const Positionnable& pos, const std::string& msg) override;
+
+    /**
+     * @brief Reports all the buffered messages to the given reporter, in the order in which
+     * they were reported. A fatal message is reported without letting the exception
+     * of the target reporter escape.
+     * @param target The reporter to which the messages are reported
+     */
+    void replayTo(AbstractReporter& target) const;
+
+private:
+
+    enum MESSAGE_KIND { MSG_INFO, MSG_WARNING, MSG_ERROR, MSG_FATAL };
+
+    struct Message;
+
+    void bufferMessage(MESSAGE_KIND kind, const Positionnable& pos, const std::string& msg);
+
+    std::vector<std::unique_ptr<Message>> _messages;
+};
+
 /**
  * @brief Is thrown when an error happens during the compilation such that
  * the compilation process cannot continue
@@ -0,0 +1,43 @@
+//
+//  ResolutionStats.cpp
+//  SFSL
+//
+//  Created by Romain Beguet on 25.10.16.
+//  Copyright (c) 2016 Romain Beguet. All rights reserved.
+//
+
+#include "ResolutionStats.h"
+
+namespace sfsl {
+
+namespace common {
+
+ResolutionStats::ResolutionStats() : lookups(0), hits(0) {
+
+}
+
+double ResolutionStats::hitRate() const {
+    return lookups == 0 ? 0 : hits / (double)lookups;
+}
+
+ResolutionStats ResolutionStats::operator+(const ResolutionStats& other) const {
+    ResolutionStats res;
+    res.lookups = lookups + other.lookups;
+    res.hits = hits + other.hits;
+    return res;
+}
+
+ResolutionStats ResolutionStats::operator-(const ResolutionStats& other) const {
+    ResolutionStats res;
+    res.lookups = lookups - other.lookups;
+    res.hits = hits - other.hits;
+    return res;
+}
+
+void ResolutionStats::writeJSON(std::ostream& o) const {
+    o << "{\"lookups\": " << lookups << ", \"hits\": " << hits << ", \"hitRate\": " << hitRate() << "}";
+}
+
+}
+
+}
@@ -0,0 +1,54 @@
+//
+//  ResolutionStats.h
+//  SFSL
+//
+//  Created by Romain Beguet on 25.10.16.
+//  Copyright (c) 2016 Romain Beguet. All rights reserved.
+//
+
+#ifndef __SFSL__ResolutionStats__
+#define __SFSL__ResolutionStats__
+
+#include <iostream>
+
+namespace sfsl {
+
+namespace common {
+
+/**
+ * @brief Counts the symbol lookups done during the compilation, and how many
+ * of them were answered by the resolution cache.
+ * The difference of two snapshots gives the lookups done in between.
+ */
+struct ResolutionStats final {
+    ResolutionStats();
+
+    /**
+     * @return The proportion of lookups answered by the cache, or 0 if there were none
+     */
+    double hitRate() const;
+
+    ResolutionStats operator+(const ResolutionStats& other) const;
+    ResolutionStats operator-(const ResolutionStats& other) const;
+
+    /**
+     * @brief Writes the stats as a JSON object
+     */
+    void writeJSON(std::ostream& o) const;
+
+    /**
+     * @brief The number of lookups that went through the cache
+     */
+    size_t lookups;
+
+    /**
+     * @brief The number of lookups whose result was found in the cache
+     */
+    size_t hits;
+};
+
+}
+
+}
+
+#endif
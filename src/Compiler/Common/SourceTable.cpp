@@ -0,0 +1,65 @@
+//
+//  SourceTable.cpp
+//  SFSL
+//
+//  Created by Romain Beguet on 23.10.16.
+//  Copyright (c) 2016 Romain Beguet. All rights reserved.
+//
+
+#include "SourceTable.h"
+
+#include <algorithm>
+
+namespace sfsl {
+
+namespace common {
+
+SourceInfo::SourceInfo(const std::string& name) : _name(name) {
+
+}
+
+SourceInfo::~SourceInfo() {
+
+}
+
+const std::string& SourceInfo::getName() const {
+    return _name;
+}
+
+void SourceInfo::setLineStarts(std::vector<uint32_t>&& lineStarts) const {
+    std::lock_guard<std::mutex> lock(_mutex);
+    _lineStarts = std::move(lineStarts);
+}
+
+bool SourceInfo::lineAndColumn(uint32_t pos, size_t& line, size_t& column) const {
+    std::lock_guard<std::mutex> lock(_mutex);
+
+    if (_lineStarts.empty() || pos < _lineStarts.front()) {
+        return false;
+    }
+
+    // the last line start which is not after the position
+    auto it = std::upper_bound(_lineStarts.begin(), _lineStarts.end(), pos) - 1;
+
+    line = (it - _lineStarts.begin()) + 1;
+    column = (pos - *it) + 1;
+    return true;
+}
+
+SourceTable::SourceTable() {
+
+}
+
+SourceTable::~SourceTable() {
+
+}
+
+const SourceInfo& SourceTable::add(const std::string& name) {
+    std::lock_guard<std::mutex> lock(_mutex);
+    _sources.emplace_back(name);
+    return _sources.back();
+}
+
+}
+
+}
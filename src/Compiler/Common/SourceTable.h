@@ -0,0 +1,89 @@
+//
+//  SourceTable.h
+//  SFSL
+//
+//  Created by Romain Beguet on 23.10.16.
+//  Copyright (c) 2016 Romain Beguet. All rights reserved.
+//
+
+#ifndef __SFSL__SourceTable__
+#define __SFSL__SourceTable__
+
+#include <string>
+#include <vector>
+#include <deque>
+#include <mutex>
+#include <cstdint>
+
+namespace sfsl {
+
+namespace common {
+
+/**
+ * @brief Describes a source known to a compilation: its name, and the positions
+ * at which its lines start once it has been lexed, so that positions can be
+ * converted to lines and columns when they are reported
+ */
+class SourceInfo final {
+public:
+
+    SourceInfo(const std::string& name);
+    ~SourceInfo();
+
+    /**
+     * @return The name of the source
+     */
+    const std::string& getName() const;
+
+    /**
+     * @brief Replaces the line index of the source
+     * @param lineStarts The position of the first character of each line, in increasing order
+     */
+    void setLineStarts(std::vector<uint32_t>&& lineStarts) const;
+
+    /**
+     * @brief Finds the line and the column of a position, both starting at 1
+     * @param pos The position to locate
+     * @param line Set to the line of the position
+     * @param column Set to the column of the position
+     * @return False if the source has no line index yet, in which case line and column are untouched
+     */
+    bool lineAndColumn(uint32_t pos, size_t& line, size_t& column) const;
+
+private:
+
+    const std::string _name;
+
+    mutable std::mutex _mutex;
+    mutable std::vector<uint32_t> _lineStarts;
+};
+
+/**
+ * @brief Holds the #sfsl::common::SourceInfo of every source of a compilation.
+ * Each source gets its own info even if another source has the same name, and
+ * the info is never moved nor destroyed before the table, so it can be referenced by address.
+ */
+class SourceTable final {
+public:
+
+    SourceTable();
+    SourceTable(const SourceTable& other) = delete;
+    ~SourceTable();
+
+    /**
+     * @param name The name of the source
+     * @return The info of a new source of the given name
+     */
+    const SourceInfo& add(const std::string& name);
+
+private:
+
+    std::mutex _mutex;
+    std::deque<SourceInfo> _sources;
+};
+
+}
+
+}
+
+#endif
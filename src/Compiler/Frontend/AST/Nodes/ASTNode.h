@@ -30,6 +30,8 @@ class ASTVisitor;
 class ASTNode : public common::Positionnable, public common::MemoryManageable {
 public:
 
+    static const common::MEMORY_CATEGORY MemoryCategory = common::MEM_AST;
+
     /**
      * @brief Destroys the ASTNode
      */
@@ -317,7 +317,7 @@ TypeExpression* Instantiation::getInstantiatedExpression() const {
 
 // IDENTIFIER
 
-Identifier::Identifier(const std::string& name) : _name(name) {
+Identifier::Identifier(common::Name name) : _name(name) {
 
 }
 
@@ -327,7 +327,7 @@ Identifier::~Identifier() {
 
 SFSL_AST_ON_VISIT_CPP(Identifier)
 
-const std::string& Identifier::getValue() const {
+common::Name Identifier::getValue() const {
     return _name;
 }
 
@@ -471,7 +471,7 @@ private:
 class Identifier : public Expression, public sym::Symbolic<sym::Symbol> {
 public:
 
-    Identifier(const std::string& name);
+    Identifier(common::Name name);
     virtual ~Identifier();
 
     SFSL_AST_ON_VISIT_H
@@ -479,11 +479,11 @@ public:
     /**
      * @return The name of the identifier
      */
-    const std::string& getValue() const;
+    common::Name getValue() const;
 
 private:
 
-    std::string _name;
+    common::Name _name;
 };
 
 /**
@@ -588,4 +588,15 @@ struct enable_bitmask_operators<ast::DefFlags> {
 
 }
 
+SFSL_TRIVIALLY_MANAGEABLE(sfsl::ast::ExpressionStatement)
+SFSL_TRIVIALLY_MANAGEABLE(sfsl::ast::AssignmentExpression)
+SFSL_TRIVIALLY_MANAGEABLE(sfsl::ast::TypeSpecifier)
+SFSL_TRIVIALLY_MANAGEABLE(sfsl::ast::IfExpression)
+SFSL_TRIVIALLY_MANAGEABLE(sfsl::ast::FunctionCall)
+SFSL_TRIVIALLY_MANAGEABLE(sfsl::ast::Instantiation)
+SFSL_TRIVIALLY_MANAGEABLE(sfsl::ast::This)
+SFSL_TRIVIALLY_MANAGEABLE(sfsl::ast::BoolLiteral)
+SFSL_TRIVIALLY_MANAGEABLE(sfsl::ast::IntLiteral)
+SFSL_TRIVIALLY_MANAGEABLE(sfsl::ast::RealLiteral)
+
 #endif
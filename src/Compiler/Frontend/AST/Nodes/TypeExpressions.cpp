@@ -99,11 +99,11 @@ TypeExpression* makeCallee(std::vector<std::string> path, CompCtx_Ptr ctx) {
     if (path.size() == 0) {
         return nullptr;
     } else if (path.size() == 1) {
-        return ctx->memoryManager().New<TypeIdentifier>(path.back());
+        return ctx->memoryManager().New<TypeIdentifier>(ctx->names().intern(path.back()));
     } else {
         std::string id = path.back();
         path.pop_back();
-        return ctx->memoryManager().New<TypeMemberAccess>(makeCallee(path, ctx), ctx->memoryManager().New<TypeIdentifier>(id));
+        return ctx->memoryManager().New<TypeMemberAccess>(makeCallee(path, ctx), ctx->memoryManager().New<TypeIdentifier>(ctx->names().intern(id)));
     }
 }
 
@@ -207,7 +207,7 @@ TypeTuple* TypeConstructorCall::getArgsTuple() const {
 
 // TYPE IDENTIFIER
 
-TypeIdentifier::TypeIdentifier(const std::string &name) : _name(name) {
+TypeIdentifier::TypeIdentifier(common::Name name) : _name(name) {
 
 }
 
@@ -217,7 +217,7 @@ TypeIdentifier::~TypeIdentifier() {
 
 SFSL_AST_ON_VISIT_CPP(TypeIdentifier)
 
-const std::string& TypeIdentifier::getValue() const {
+common::Name TypeIdentifier::getValue() const {
     return _name;
 }
 
@@ -258,6 +258,18 @@ KindSpecifyingExpression* TypeParameter::getKindNode() const {
     return _kind;
 }
 
+// ERROR EXPRESSION
+
+ErrorExpression::ErrorExpression() {
+
+}
+
+ErrorExpression::~ErrorExpression() {
+
+}
+
+SFSL_AST_ON_VISIT_CPP(ErrorExpression)
+
 }
 
 }
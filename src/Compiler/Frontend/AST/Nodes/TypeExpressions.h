@@ -284,7 +284,7 @@ private:
  */
 class TypeIdentifier : public TypeExpression, public sym::Symbolic<sym::Symbol> {
 public:
-    TypeIdentifier(const std::string& name);
+    TypeIdentifier(common::Name name);
     virtual ~TypeIdentifier();
 
     SFSL_AST_ON_VISIT_H
@@ -292,11 +292,11 @@ public:
     /**
      * @return The name of the identifier
      */
-    const std::string& getValue() const;
+    common::Name getValue() const;
 
 private:
 
-    std::string _name;
+    common::Name _name;
 };
 
 /**
@@ -344,6 +344,20 @@ private:
     KindSpecifyingExpression* _kind;
 };
 
+/**
+ * @brief Represents an expression or a type expression that could not be parsed.
+ * The parser creates it in place of the erroneous part of the input,
+ * once the corresponding syntax error has been reported.
+ */
+class ErrorExpression : public TypeExpression {
+public:
+
+    ErrorExpression();
+    virtual ~ErrorExpression();
+
+    SFSL_AST_ON_VISIT_H
+};
+
 }
 
 }
@@ -24,6 +24,8 @@ namespace ast {
 class Annotation : public common::MemoryManageable, public common::Positionnable {
 public:
 
+    static const common::MEMORY_CATEGORY MemoryCategory = common::MEM_AST;
+
     struct ArgumentValue final {
         ArgumentValue();
         ArgumentValue(sfsl_bool_t b);
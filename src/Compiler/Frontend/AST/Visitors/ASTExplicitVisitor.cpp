@@ -148,6 +148,10 @@ void ASTExplicitVisitor::visit(StringLiteral*) {
 
 }
 
+void ASTExplicitVisitor::visit(ErrorExpression*) {
+
+}
+
 }
 
 }
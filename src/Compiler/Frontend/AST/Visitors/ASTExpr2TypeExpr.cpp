@@ -64,6 +64,7 @@ IDENTITY_FOR_NODE(TypeConstructorCall)
 IDENTITY_FOR_NODE(TypeIdentifier)
 IDENTITY_FOR_NODE(TypeToBeInferred)
 IDENTITY_FOR_NODE(TypeParameter)
+IDENTITY_FOR_NODE(ErrorExpression)
 
 void ASTExpr2TypeExpr::visit(MemberAccess* dot) {
     if (TypeExpression* accessed = transform<TypeExpression>(dot->getAccessed())) {
@@ -224,6 +224,10 @@ void ASTImplicitVisitor::visit(StringLiteral*) {
 
 }
 
+void ASTImplicitVisitor::visit(ErrorExpression*) {
+
+}
+
 
 
 }
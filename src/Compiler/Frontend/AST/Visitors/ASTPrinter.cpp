@@ -366,6 +366,10 @@ void ASTPrinter::visit(StringLiteral* strlit) {
     _ostream << "\"" << strlit->getValue() << "\"";
 }
 
+void ASTPrinter::visit(ErrorExpression*) {
+    _ostream << "<error>";
+}
+
 void ASTPrinter::printIndents() {
     for (size_t i = 0; i < _indentCount; ++i) {
         _ostream << "    ";
@@ -64,6 +64,7 @@ public:
     virtual void visit(IntLiteral* intlit) override;
     virtual void visit(RealLiteral* reallit) override;
     virtual void visit(StringLiteral* strlit) override;
+    virtual void visit(ErrorExpression* err) override;
 
 private :
 
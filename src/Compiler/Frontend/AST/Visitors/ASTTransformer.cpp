@@ -202,6 +202,10 @@ void ASTTransformer::visit(StringLiteral* stringlit) {
     set(stringlit);
 }
 
+void ASTTransformer::visit(ErrorExpression* err) {
+    set(err);
+}
+
 }
 
 }
@@ -34,7 +34,7 @@ void ASTTypeCreator::visit(ASTNode*) {
 }
 
 void ASTTypeCreator::visit(ClassDecl* clss) {
-    _created = _mngr.New<type::ProperType>(clss, buildEnvironmentFromTypeParametrizable(clss));
+    _created = type::ProperType::create(clss, buildEnvironmentFromTypeParametrizable(clss), _ctx);
 }
 
 void ASTTypeCreator::visit(FunctionTypeDecl* ftdecl) {
@@ -59,11 +59,11 @@ void ASTTypeCreator::visit(FunctionTypeDecl* ftdecl) {
         }
     }
 
-    _created = _mngr.New<type::FunctionType>(ftdecl->getTypeArgs(), argTypes, retType, functionClass, env);
+    _created = type::FunctionType::create(ftdecl->getTypeArgs(), argTypes, retType, functionClass, env, _ctx);
 }
 
 void ASTTypeCreator::visit(TypeConstructorCreation* typeconstructor) {
-    _created = _mngr.New<type::TypeConstructorType>(typeconstructor, buildEnvironmentFromTypeParametrizable(typeconstructor));
+    _created = type::TypeConstructorType::create(typeconstructor, buildEnvironmentFromTypeParametrizable(typeconstructor), _ctx);
 }
 
 void ASTTypeCreator::visit(TypeConstructorCall* tcall) {
@@ -78,7 +78,7 @@ void ASTTypeCreator::visit(TypeConstructorCall* tcall) {
             }
         }
 
-        _created = _mngr.New<type::ConstructorApplyType>(ctr, args);
+        _created = type::ConstructorApplyType::create(ctr, args, _ctx);
     }
 }
 
@@ -228,6 +228,13 @@ public:
         setIfSame<ASTNode>();
     }
 
+    virtual void visit(ErrorExpression*) override {
+        setIfSame<ErrorExpression>();
+        setIfSame<TypeExpression>();
+        setIfSame<Expression>();
+        setIfSame<ASTNode>();
+    }
+
     /**
      * @return True if the node is well of type T
      */
@@ -82,6 +82,7 @@ public:
     virtual void visit(IntLiteral* intlit) = 0;
     virtual void visit(RealLiteral* reallit) = 0;
     virtual void visit(StringLiteral* strlit) = 0;
+    virtual void visit(ErrorExpression* err) = 0;
 
 protected:
 
@@ -15,6 +15,8 @@
 #include "../AST/Visitors/ASTKindCreator.h"
 #include "../AST/Visitors/ASTExpr2TypeExpr.h"
 
+#include <limits>
+
 #define SAVE_SCOPE(expr)  \
     sym::Scope* __last_scope__ = _curScope; \
     _curScope = (expr)->getScope();
@@ -28,7 +30,7 @@ namespace ast {
 
 const size_t size_t_max = std::numeric_limits<size_t>::max();
 ProperTypeKindSpecifier defaultPtks(nullptr, nullptr);
-sym::Scope emptyScope(nullptr);
+sym::Scope emptyScope(static_cast<sym::ResolutionCache*>(nullptr)); // shared by all the compilations, so it must not cache lookups
 
 // SCOPE GENERATION
 
@@ -65,7 +67,7 @@ void ScopeGeneration::visit(ModuleDecl* module) {
     } else {
         createSymbol<sym::ModuleSymbol>(module);
 
-        pushScope(module->getSymbol());
+        pushScope(module->getSymbol(), false, true);
         pushPathPart(module->getName()->getValue(), false);
 
         ASTImplicitVisitor::visit(module);
@@ -89,7 +91,7 @@ void ScopeGeneration::visit(TypeDecl* tdecl) {
 }
 
 void ScopeGeneration::visit(ClassDecl* clss) {
-    pushScope(clss, _currentThis != nullptr);
+    pushScope(clss, _currentThis != nullptr, true);
     pushPathPart(clss->getName(), false);
 
     SAVE_MEMBER_AND_SET(_currentThis, clss)
@@ -294,7 +296,7 @@ void ScopeGeneration::visit(TypeSpecifier* tps) {
 }
 
 void ScopeGeneration::createVar(Identifier* id) {
-    std::string symName = id->getValue();
+    common::Name symName = id->getValue();
     sym::VariableSymbol* arg = _mngr.New<sym::VariableSymbol>(symName, symName);
     initCreated(id, arg);
 }
@@ -306,9 +308,10 @@ void ScopeGeneration::createProperType(TypeIdentifier* id, TypeDecl* defaultType
 TypeDecl* ScopeGeneration::makeTypeDecl(const std::string& name, TypeExpression* expr) {
     type::Type* t = ASTTypeCreator::createType(expr, _ctx);
 
-    TypeDecl* tdecl = _mngr.New<TypeDecl>(_mngr.New<TypeIdentifier>(name), expr, false);
+    common::Name symName = _ctx->names().intern(name);
+    TypeDecl* tdecl = _mngr.New<TypeDecl>(_mngr.New<TypeIdentifier>(symName), expr, false);
 
-    sym::TypeSymbol* ts = _mngr.New<sym::TypeSymbol>(name, name, tdecl);
+    sym::TypeSymbol* ts = _mngr.New<sym::TypeSymbol>(symName, name, tdecl);
 
     tdecl->setType(t);
     ts->setType(t);
@@ -319,8 +322,9 @@ TypeDecl* ScopeGeneration::makeTypeDecl(const std::string& name, TypeExpression*
     return tdecl;
 }
 
-void ScopeGeneration::pushScope(sym::Scoped* scoped, bool isDefScope) {
-    _curScope = _mngr.New<sym::Scope>(_curScope, isDefScope);
+void ScopeGeneration::pushScope(sym::Scoped* scoped, bool isDefScope, bool cachesLookups) {
+    _curScope = _curScope ? _mngr.New<sym::Scope>(_curScope, isDefScope, cachesLookups)
+                          : _mngr.New<sym::Scope>(sym::ResolutionCache::get(_ctx));
     if (scoped != nullptr) {
         scoped->setScope(_curScope);
     }
@@ -351,21 +355,21 @@ void ScopeGeneration::generateTypeParametersSymbols(const std::vector<TypeExpres
 
 template<typename T, typename U>
 T* ScopeGeneration::createSymbol(U* node) {
-    std::string symName = node->getName()->getValue();
+    common::Name symName = node->getName()->getValue();
     T* sym = _mngr.New<T>(symName, absoluteName(symName));
     initCreated(node, sym);
     return sym;
 }
 
 sym::DefinitionSymbol* ScopeGeneration::createSymbol(DefineDecl* node, TypeExpression* currentThis) {
-    std::string symName = node->getName()->getValue();
+    common::Name symName = node->getName()->getValue();
     sym::DefinitionSymbol* sym = _mngr.New<sym::DefinitionSymbol>(symName, absoluteName(symName), node, currentThis);
     initCreated(node, sym);
     return sym;
 }
 
 sym::TypeSymbol* ScopeGeneration::createSymbol(TypeDecl* node) {
-    std::string symName = node->getName()->getValue();
+    common::Name symName = node->getName()->getValue();
     sym::TypeSymbol* sym = _mngr.New<sym::TypeSymbol>(symName, absoluteName(symName), node);
     initCreated(node, sym);
     return sym;
@@ -776,7 +780,7 @@ void SymbolAssignation::assignMemberAccess(T* mac) {
 template<typename T>
 void SymbolAssignation::assignFromStaticScope(T* mac, sym::Scoped* scoped, const std::string& typeName) {
     sym::Scope* scope = scoped->getScope();
-    const std::string& id = mac->getMember()->getValue();
+    common::Name id = mac->getMember()->getValue();
 
     if (!scope->assignSymbolic<sym::Symbol>(*mac, id)) {
         _ctx->reporter().error(
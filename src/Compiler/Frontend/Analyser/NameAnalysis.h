@@ -51,7 +51,7 @@ private:
     void createProperType(TypeIdentifier* id, TypeDecl* defaultType);
     TypeDecl* makeTypeDecl(const std::string& name, TypeExpression* expr);
 
-    void pushScope(sym::Scoped* scoped = nullptr, bool isDefScope = false);
+    void pushScope(sym::Scoped* scoped = nullptr, bool isDefScope = false, bool cachesLookups = false);
     void popScope();
 
     void generateTypeParametersSymbols(const std::vector<TypeExpression*>& typeParams, bool allowVarianceAnnotations);
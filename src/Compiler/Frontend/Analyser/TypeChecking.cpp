@@ -121,7 +121,7 @@ void TopLevelTypeChecking::visit(FunctionCreation* func) {
         if (func->getTypeArgs()) {
             typeArgs = func->getTypeArgs()->getExpressions();
         }
-        func->setType(_mngr.New<type::FunctionType>(typeArgs, argTypes, type::Type::NotYetDefined(), nullptr, type::Environment::Empty));
+        func->setType(type::FunctionType::create(typeArgs, argTypes, type::Type::NotYetDefined(), nullptr, type::Environment::Empty, _ctx));
     }
 
     ASTImplicitVisitor::visit(func);
@@ -165,15 +165,15 @@ void TypeChecking::visit(ClassDecl* clss) {
 
     int abstractOverRedef = 0;
 
-    for (const std::pair<std::string, sym::SymbolData>& pair : clss->getScope()->getAllSymbols()) {
-        if (sym::DefinitionSymbol* defsym = sym::getIfSymbolOfType<sym::DefinitionSymbol>(pair.second.symbol)) {
+    clss->getScope()->getAllSymbols().forEachSymbol([&abstractOverRedef](common::Name, sym::Symbol* s) {
+        if (sym::DefinitionSymbol* defsym = sym::getIfSymbolOfType<sym::DefinitionSymbol>(s)) {
             if (defsym->getDef()->isAbstract()) {
                 ++abstractOverRedef;
             } else if (defsym->getDef()->isRedef()) {
                 --abstractOverRedef;
             }
         }
-    }
+    });
 
     if (abstractOverRedef > 0) {
         _rep.error(*clss, "Non abstract class must redefine every one of its abstract members");
@@ -519,9 +519,9 @@ void TypeChecking::visit(FunctionCreation* func) {
         // func is a method
 
         if (ClassDecl* clss = getIfNodeOfType<ClassDecl>(_currentThis, _ctx)) {
-            func->setType(_mngr.New<type::MethodType>(clss,
-                                                      func->getTypeArgs() ? func->getTypeArgs()->getExpressions() : std::vector<TypeExpression*>(),
-                                                      argTypes, retType, ASTTypeCreator::buildEnvironmentFromTypeParametrizable(func)));
+            func->setType(type::MethodType::create(clss,
+                                                   func->getTypeArgs() ? func->getTypeArgs()->getExpressions() : std::vector<TypeExpression*>(),
+                                                   argTypes, retType, ASTTypeCreator::buildEnvironmentFromTypeParametrizable(func), _ctx));
         } else {
             _rep.fatal(*func, "Unknown type of `this`");
         }
@@ -573,7 +573,7 @@ void TypeChecking::visit(FunctionCall* call) {
         _expectedInfo.node = inst;
 
         if (type::ProperType* pt = type::getIf<type::ProperType>(calleeT)) {
-            if (!transformIntoCallToMember(call, inst, pt, "new", callTypeArgs, &argTypes, expectedArgTypes, retType)) {
+            if (!transformIntoCallToMember(call, inst, pt, _ctx->names().intern("new"), callTypeArgs, &argTypes, expectedArgTypes, retType)) {
                 call->setType(inst->type());
                 return;
             }
@@ -589,7 +589,7 @@ void TypeChecking::visit(FunctionCall* call) {
         expectedArgTypes = &mt->getArgTypes();
         retType = mt->getRetType();
     } else if (type::ProperType* pt = type::getIf<type::ProperType>(calleeT)) {
-        if (!transformIntoCallToMember(call, call->getCallee(), pt, "()", callTypeArgs, &argTypes, expectedArgTypes, retType)) {
+        if (!transformIntoCallToMember(call, call->getCallee(), pt, _ctx->names().intern("()"), callTypeArgs, &argTypes, expectedArgTypes, retType)) {
             return;
         }
     } else {
@@ -660,7 +660,7 @@ void TypeChecking::visit(StringLiteral* strlit) {
     strlit->setType(_res.String());
 }
 
-TypeChecking::FieldInfo TypeChecking::tryGetFieldInfo(ASTNode* triggerer, ClassDecl* clss, const std::string& id, const type::Environment& env) {
+TypeChecking::FieldInfo TypeChecking::tryGetFieldInfo(ASTNode* triggerer, ClassDecl* clss, common::Name id, const type::Environment& env) {
     const auto& it = clss->getScope()->getAllSymbols().equal_range(id);
 
     if (it.first == it.second) {
@@ -699,7 +699,7 @@ type::Type* TypeChecking::tryGetTypeOfSymbol(sym::Symbol* sym) {
     return nullptr;
 }
 
-bool TypeChecking::transformIntoCallToMember(FunctionCall* call, Expression* newCallee, type::ProperType* pt, const std::string& member,
+bool TypeChecking::transformIntoCallToMember(FunctionCall* call, Expression* newCallee, type::ProperType* pt, common::Name member,
                                              const std::vector<TypeExpression*>& typeArgs, ArgTypeEvaluator* callArgTypes,
                                              const std::vector<type::Type*>*& expectedArgTypes, type::Type*& retType) {
     ClassDecl* clss = pt->getClass();
@@ -802,32 +802,32 @@ void TypeChecking::assignFunctionType(FunctionCreation* func,
 
     if (func->getTypeArgs()) {
         typeArgs = func->getTypeArgs()->getExpressions();
-        funcDecl   = _mngr.New<DefineDecl>(_mngr.New<Identifier>("()"), nullptr, meth, DefFlags::NONE);
+        funcDecl   = _mngr.New<DefineDecl>(_mngr.New<Identifier>(_ctx->names().intern("()")), nullptr, meth, DefFlags::NONE);
         funcClass   = _mngr.New<ClassDecl>(func->getName(), nullptr, std::vector<TypeDecl*>(),
                                                           std::vector<TypeSpecifier*>(), std::vector<DefineDecl*>{funcDecl}, false);
 
-        funcType = _mngr.New<type::FunctionType>(typeArgs, argTypes, retType, funcClass, env);
+        funcType = type::FunctionType::create(typeArgs, argTypes, retType, funcClass, env, _ctx);
     } else {
         std::vector<type::Type*> parentTypeArgs = argTypes;
         parentTypeArgs.push_back(retType);
 
-        type::Type* parentType = _mngr.New<type::ConstructorApplyType>(_res.Func(argTypes.size()), parentTypeArgs);
+        type::Type* parentType = type::ConstructorApplyType::create(_res.Func(argTypes.size()), parentTypeArgs, _ctx);
         sym::TypeSymbol* parentSymbol = sym::getIfSymbolOfType<sym::TypeSymbol>(_res.getSymbol(_namer.Func(argTypes.size())));
         if (!parentSymbol) {
             _ctx->reporter().fatal(*func, "Could not find Func symbol");
         }
 
         std::string parentName = "Func" + utils::T_toString(argTypes.size());
-        TypeIdentifier* parentExpr = _mngr.New<TypeIdentifier>(parentName);
+        TypeIdentifier* parentExpr = _mngr.New<TypeIdentifier>(_ctx->names().intern(parentName));
 
         parentExpr->setSymbol(parentSymbol);
         parentSymbol->setType(parentType);
 
-        funcDecl   = _mngr.New<DefineDecl>(_mngr.New<Identifier>("()"), nullptr, meth, DefFlags::REDEF);
+        funcDecl   = _mngr.New<DefineDecl>(_mngr.New<Identifier>(_ctx->names().intern("()")), nullptr, meth, DefFlags::REDEF);
         funcClass   = _mngr.New<ClassDecl>(func->getName(), parentExpr, std::vector<TypeDecl*>(),
                                                           std::vector<TypeSpecifier*>(), std::vector<DefineDecl*>{funcDecl}, false);
 
-        funcType = _mngr.New<type::FunctionType>(typeArgs, argTypes, retType, funcClass, env);
+        funcType = type::FunctionType::create(typeArgs, argTypes, retType, funcClass, env, _ctx);
 
         _redefs.push_back(funcDecl);
 
@@ -838,10 +838,10 @@ void TypeChecking::assignFunctionType(FunctionCreation* func,
         }
     }
 
-    meth->setType(_mngr.New<type::MethodType>(funcClass, typeArgs, argTypes, retType, env));
+    meth->setType(type::MethodType::create(funcClass, typeArgs, argTypes, retType, env, _ctx));
     meth->setPos(*func);
 
-    sym::DefinitionSymbol* funcSym = _mngr.New<sym::DefinitionSymbol>("()", "", funcDecl, funcClass);
+    sym::DefinitionSymbol* funcSym = _mngr.New<sym::DefinitionSymbol>(_ctx->names().intern("()"), "", funcDecl, funcClass);
 
     funcSym->setType(meth->type());
     funcSym->setPos(*func);
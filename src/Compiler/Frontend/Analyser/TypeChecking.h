@@ -111,14 +111,14 @@ private:
         ASTNode* node;
     };
 
-    FieldInfo tryGetFieldInfo(ASTNode* triggerer, ClassDecl* clss, const std::string& id, const type::Environment& env);
+    FieldInfo tryGetFieldInfo(ASTNode* triggerer, ClassDecl* clss, common::Name id, const type::Environment& env);
 
     type::Type* tryGetTypeOfSymbol(sym::Symbol* sym);
 
     template<typename T>
     void tryAssigningTypeToSymbolic(T* symbolic);
 
-    bool transformIntoCallToMember(FunctionCall* call, Expression* newCallee, type::ProperType* pt, const std::string& member,
+    bool transformIntoCallToMember(FunctionCall* call, Expression* newCallee, type::ProperType* pt, common::Name member,
                                    const std::vector<TypeExpression*>& typeArgs, ArgTypeEvaluator* callArgTypes,
                                    const std::vector<type::Type*>*& expectedArgTypes, type::Type*& retType);
 
@@ -24,6 +24,8 @@ enum KIND_GENRE {KIND_NYD, KIND_PROPER, KIND_TYPE_CONSTRUCTOR};
 
 class Kind : public common::MemoryManageable {
 public:
+    static const common::MEMORY_CATEGORY MemoryCategory = common::MEM_KIND;
+
     virtual ~Kind();
 
     virtual KIND_GENRE getKindGenre() const = 0;
@@ -0,0 +1,143 @@
+//
+//  CharScanning.cpp
+//  SFSL
+//
+//  Created by Romain Beguet on 22.10.16.
+//  Copyright (c) 2016 Romain Beguet. All rights reserved.
+//
+
+#include "CharScanning.h"
+
+#include <cstddef>
+#include <cstdint>
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+#include "../../../Utils/Utils.h"
+
+namespace sfsl {
+
+namespace lex {
+
+namespace scan {
+
+namespace {
+
+/*
+ * Each matcher describes the bytes to find in two ways: byte per byte, and as a
+ * bit mask over 16 bytes (bit i is set if the byte at p + i matches).
+ * LOOKAHEAD is the number of bytes past the block that the masks may read.
+ */
+
+struct WhiteSpaceSkipper final {
+    static const ptrdiff_t LOOKAHEAD = 0;
+
+    static bool matches(const char* p, const char*) {
+        return !chrutils::isWhiteSpace(*p);
+    }
+
+#if defined(__SSE2__)
+    static uint32_t mask16(const char* p) {
+        __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(p));
+        __m128i spaces = _mm_or_si128(
+                    _mm_or_si128(_mm_cmpeq_epi8(v, _mm_set1_epi8(' ')), _mm_cmpeq_epi8(v, _mm_set1_epi8('\t'))),
+                    _mm_or_si128(_mm_cmpeq_epi8(v, _mm_set1_epi8('\n')), _mm_cmpeq_epi8(v, _mm_set1_epi8('\r'))));
+        return static_cast<uint32_t>(_mm_movemask_epi8(spaces)) ^ 0xFFFF;
+    }
+#endif
+};
+
+struct NewLineFinder final {
+    static const ptrdiff_t LOOKAHEAD = 0;
+
+    static bool matches(const char* p, const char*) {
+        return chrutils::isNewLine(*p);
+    }
+
+#if defined(__SSE2__)
+    static uint32_t mask16(const char* p) {
+        __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(p));
+        return static_cast<uint32_t>(_mm_movemask_epi8(_mm_or_si128(
+                    _mm_cmpeq_epi8(v, _mm_set1_epi8('\n')), _mm_cmpeq_epi8(v, _mm_set1_epi8('\r')))));
+    }
+#endif
+};
+
+struct CommentEndFinder final {
+    static const ptrdiff_t LOOKAHEAD = 1;
+
+    static bool matches(const char* p, const char* end) {
+        return p[0] == '*' && p + 1 < end && p[1] == '/';
+    }
+
+#if defined(__SSE2__)
+    static uint32_t mask16(const char* p) {
+        __m128i stars = _mm_cmpeq_epi8(_mm_loadu_si128(reinterpret_cast<const __m128i*>(p)), _mm_set1_epi8('*'));
+        __m128i slashes = _mm_cmpeq_epi8(_mm_loadu_si128(reinterpret_cast<const __m128i*>(p + 1)), _mm_set1_epi8('/'));
+        return static_cast<uint32_t>(_mm_movemask_epi8(_mm_and_si128(stars, slashes)));
+    }
+#endif
+};
+
+struct StringLiteralStopFinder final {
+    static const ptrdiff_t LOOKAHEAD = 0;
+
+    static bool matches(const char* p, const char*) {
+        return *p == '\"' || *p == '\\' || chrutils::isNewLine(*p);
+    }
+
+#if defined(__SSE2__)
+    static uint32_t mask16(const char* p) {
+        __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(p));
+        __m128i stops = _mm_or_si128(
+                    _mm_or_si128(_mm_cmpeq_epi8(v, _mm_set1_epi8('\"')), _mm_cmpeq_epi8(v, _mm_set1_epi8('\\'))),
+                    _mm_or_si128(_mm_cmpeq_epi8(v, _mm_set1_epi8('\n')), _mm_cmpeq_epi8(v, _mm_set1_epi8('\r'))));
+        return static_cast<uint32_t>(_mm_movemask_epi8(stops));
+    }
+#endif
+};
+
+template<typename Matcher>
+const char* findFirst(const char* begin, const char* end) {
+#if defined(__SSE2__)
+    for (; end - begin >= 16 + Matcher::LOOKAHEAD; begin += 16) {
+        if (uint32_t mask = Matcher::mask16(begin)) {
+            return begin + __builtin_ctz(mask);
+        }
+    }
+#endif
+
+    for (; begin < end; ++begin) {
+        if (Matcher::matches(begin, end)) {
+            return begin;
+        }
+    }
+
+    return end;
+}
+
+}
+
+const char* skipWhiteSpaces(const char* begin, const char* end) {
+    return findFirst<WhiteSpaceSkipper>(begin, end);
+}
+
+const char* findNewLine(const char* begin, const char* end) {
+    return findFirst<NewLineFinder>(begin, end);
+}
+
+const char* findCommentEnd(const char* begin, const char* end) {
+    return findFirst<CommentEndFinder>(begin, end);
+}
+
+const char* findStringLiteralStop(const char* begin, const char* end) {
+    return findFirst<StringLiteralStopFinder>(begin, end);
+}
+
+}
+
+}
+
+}
@@ -0,0 +1,54 @@
+//
+//  CharScanning.h
+//  SFSL
+//
+//  Created by Romain Beguet on 22.10.16.
+//  Copyright (c) 2016 Romain Beguet. All rights reserved.
+//
+
+#ifndef __SFSL__CharScanning__
+#define __SFSL__CharScanning__
+
+namespace sfsl {
+
+namespace lex {
+
+/**
+ * @brief Routines that skip over runs of uninteresting bytes of an in-memory source.
+ * When the compiler targets SSE2, they test 16 bytes at a time and fall back to
+ * a byte-per-byte loop for the remaining tail, or on other targets.
+ *
+ * All of them take the half-open range [begin, end) and return a pointer
+ * inside it, or end if no matching byte was found.
+ */
+namespace scan {
+
+/**
+ * @return The first byte that is not a white space (see #sfsl::chrutils::isWhiteSpace)
+ */
+const char* skipWhiteSpaces(const char* begin, const char* end);
+
+/**
+ * @return The first '\n' or '\r'
+ */
+const char* findNewLine(const char* begin, const char* end);
+
+/**
+ * @return The first '*' that is directly followed by a '/', i.e. the
+ * start of the sequence closing a multiline comment
+ */
+const char* findCommentEnd(const char* begin, const char* end);
+
+/**
+ * @return The first byte that cannot be copied as is into the value of a
+ * string literal, i.e. a quote, a backslash or a new line
+ */
+const char* findStringLiteralStop(const char* begin, const char* end);
+
+}
+
+}
+
+}
+
+#endif
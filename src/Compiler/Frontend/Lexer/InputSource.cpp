@@ -6,8 +6,20 @@
 //  Copyright (c) 2014 Romain Beguet. All rights reserved.
 //
 
+#include <fstream>
+#include <algorithm>
+#include <iterator>
+#include <cstring>
 #include "InputSource.h"
 
+#ifndef _WIN32
+#include <cerrno>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
 namespace sfsl {
 
 namespace src {
@@ -34,6 +46,11 @@ common::Positionnable InputSource::currentPos() const {
     return common::Positionnable(getPosition(), getPosition() + 1, getSourceName());
 }
 
+const char* InputSource::consumeAll(size_t& size) {
+    size = 0;
+    return nullptr;
+}
+
 // INPUT STREAM SOURCE
 
 IStreamSource::IStreamSource(InputSourceName sourceName, std::istream& input) : InputSource(sourceName), _input(input) {
@@ -63,6 +80,105 @@ void IStreamSource::produceNext() {
     _hasNext = (_curChar != CHAR_EOF);
 }
 
+// SPAN SOURCE
+
+SpanSource::SpanSource(InputSourceName sourceName, const char* data, size_t size)
+    : InputSource(sourceName), _data(data), _size(size) {
+
+}
+
+SpanSource::~SpanSource() {
+
+}
+
+size_t SpanSource::getNexts(char* buffer, size_t maxBufferSize) {
+    size_t count = std::min(maxBufferSize, _size - _position);
+    if (count > 0) {
+        std::memcpy(buffer, _data + _position, count);
+    }
+    _position += count;
+    return count;
+}
+
+const char* SpanSource::consumeAll(size_t& size) {
+    const char* rest = _data + _position;
+    size = _size - _position;
+    _position = _size;
+    return rest;
+}
+
+const char* SpanSource::data() const {
+    return _data;
+}
+
+size_t SpanSource::size() const {
+    return _size;
+}
+
+// MAPPED FILE SOURCE
+
+MappedFileSource::MappedFileSource(InputSourceName sourceName, const std::string& path)
+    : SpanSource(sourceName, nullptr, 0), _mapped(false) {
+#ifdef _WIN32
+    std::ifstream f(path, std::ios::binary);
+    if (!f) {
+        throw common::CompilationFatalError("Could not open source file '" + path + "'");
+    }
+    _content.assign(std::istreambuf_iterator<char>(f), std::istreambuf_iterator<char>());
+#else
+    int fd = open(path.c_str(), O_RDONLY);
+    if (fd < 0) {
+        throw common::CompilationFatalError("Could not open source file '" + path + "'");
+    }
+
+    struct stat st;
+    if (fstat(fd, &st) != 0) {
+        close(fd);
+        throw common::CompilationFatalError("Could not read source file '" + path + "'");
+    }
+
+    // pipes, terminals and the like report a size of 0 and cannot be mapped
+    if (S_ISREG(st.st_mode) && st.st_size > 0) {
+        void* addr = mmap(nullptr, (size_t)st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+        close(fd);
+
+        if (addr == MAP_FAILED) {
+            throw common::CompilationFatalError("Could not map source file '" + path + "'");
+        }
+
+        _data = static_cast<const char*>(addr);
+        _size = (size_t)st.st_size;
+        _mapped = true;
+        return;
+    }
+
+    char buffer[4096];
+    for (;;) {
+        ssize_t count = read(fd, buffer, sizeof(buffer));
+        if (count > 0) {
+            _content.append(buffer, (size_t)count);
+        } else if (count == 0) {
+            break;
+        } else if (errno != EINTR) {
+            close(fd);
+            throw common::CompilationFatalError("Could not read source file '" + path + "'");
+        }
+    }
+
+    close(fd);
+#endif
+    _data = _content.data();
+    _size = _content.size();
+}
+
+MappedFileSource::~MappedFileSource() {
+#ifndef _WIN32
+    if (_mapped) {
+        munmap(const_cast<char*>(_data), _size);
+    }
+#endif
+}
+
 // INPUT STRING SOURCE
 
 StringSource::StringSource(InputSourceName sourceName, const std::string &source)
@@ -75,13 +191,17 @@ StringSource::~StringSource() {
 }
 
 size_t StringSource::getNexts(char* buffer, size_t maxBufferSize) {
-    size_t i = 0;
-
-    while (_position < _size && i < maxBufferSize) {
-        buffer[i++] = _input[_position++];
-    }
+    size_t count = std::min(maxBufferSize, _size - _position);
+    std::memcpy(buffer, _input.data() + _position, count);
+    _position += count;
+    return count;
+}
 
-    return i;
+const char* StringSource::consumeAll(size_t& size) {
+    const char* rest = _input.data() + _position;
+    size = _size - _position;
+    _position = _size;
+    return rest;
 }
 
 }
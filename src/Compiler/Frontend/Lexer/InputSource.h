@@ -38,6 +38,16 @@ public:
      */
     virtual size_t getNexts(char* buffer, size_t maxBufferSize) = 0;
 
+    /**
+     * @brief Gives direct access to the rest of the input if it already lives in memory,
+     * in which case the position is moved to the end of the input. Sources which cannot
+     * do that return nullptr, and must be read with #getNexts.
+     *
+     * @param size Filled with the number of characters that can be read from the returned pointer
+     * @return A pointer to the next character, or nullptr
+     */
+    virtual const char* consumeAll(size_t& size);
+
     /**
      * @return The current position in the source
      */
@@ -89,6 +99,69 @@ private:
 
 };
 
+/**
+ * @brief An InputSource over characters owned by the caller, which are never copied.
+ * They must outlive the source and every lexer reading from it.
+ */
+class SpanSource : public InputSource {
+public:
+
+    /**
+     * @brief Creates a SpanSource
+     * @param sourceName the name of the source
+     * @param data the first character of the source
+     * @param size the number of characters of the source
+     */
+    SpanSource(InputSourceName sourceName, const char* data, size_t size);
+
+    virtual ~SpanSource();
+
+    virtual size_t getNexts(char* buffer, size_t maxBufferSize) override;
+
+    virtual const char* consumeAll(size_t& size) override;
+
+    /**
+     * @return The first character of the source
+     */
+    const char* data() const;
+
+    /**
+     * @return The number of characters of the source
+     */
+    size_t size() const;
+
+protected:
+
+    const char* _data;
+    size_t _size;
+};
+
+/**
+ * @brief A SpanSource over the content of a file mapped in memory, unmapped on destruction.
+ * Falls back to reading the whole file where mmap is not available.
+ */
+class MappedFileSource final : public SpanSource {
+public:
+
+    /**
+     * @brief Maps the file, or reads it if it is not a regular file (e.g. a pipe).
+     * Throws a #sfsl::common::CompilationFatalError if it cannot be read
+     * @param sourceName the name of the source
+     * @param path the path of the file to map
+     */
+    MappedFileSource(InputSourceName sourceName, const std::string& path);
+
+    virtual ~MappedFileSource();
+
+private:
+
+    MappedFileSource(const MappedFileSource& other) = delete;
+    MappedFileSource& operator=(const MappedFileSource& other) = delete;
+
+    std::string _content;
+    bool _mapped;
+};
+
 /**
  * @brief A StringSource that uses a string as input for the source code
  */
@@ -106,6 +179,8 @@ public:
 
     virtual size_t getNexts(char* buffer, size_t maxBufferSize) override;
 
+    virtual const char* consumeAll(size_t& size) override;
+
 private:
 
     const std::string _input;
@@ -7,29 +7,32 @@
 //
 
 #include "InputSourceName.h"
-#include "../../Common/ManageableWrapper.h"
 
 namespace sfsl {
 
 namespace src {
 
-InputSourceName::InputSourceName() : _name(&unknown) {
+InputSourceName::InputSourceName() : _info(&unknown) {
 
 }
 
-InputSourceName::InputSourceName(const std::string* name) : _name(name) {
+InputSourceName::InputSourceName(const common::SourceInfo* info) : _info(info) {
 
 }
 
 InputSourceName InputSourceName::make(const CompCtx_Ptr& compilationContext, const std::string& name) {
-    return InputSourceName(compilationContext.get()->memoryManager().New<common::ManageableWrapper<std::string>>(name)->getConstPtr());
+    return InputSourceName(&compilationContext->sources().add(name));
 }
 
 const std::string& InputSourceName::getName() const {
-    return *_name;
+    return _info->getName();
 }
 
-const std::string InputSourceName::unknown = "<unknown>";
+const common::SourceInfo& InputSourceName::getInfo() const {
+    return *_info;
+}
+
+const common::SourceInfo InputSourceName::unknown("<unknown>");
 
 }
 
@@ -17,7 +17,8 @@ namespace sfsl {
 namespace src {
 
 /**
- * @brief Simple class containing the name of an InputSource, which can be automatically managed
+ * @brief Simple class referring to the #sfsl::common::SourceInfo of an InputSource,
+ * which is held by the compilation context
  */
 class InputSourceName final {
 public:
@@ -25,7 +26,8 @@ public:
     InputSourceName();
 
     /**
-     * @brief Creates a new InputSourceName object and make it managed automatically
+     * @brief Creates a new InputSourceName object whose info is held by the compilation context.
+     * The info is never shared with another call, even if it is given the same name
      * @param compilationContext The Compilation context from which to instantiate the object
      * @param name The name to the source file
      * @return The newly created InputSourceName
@@ -34,13 +36,18 @@ public:
 
     const std::string& getName() const;
 
+    /**
+     * @return The info of the source, through which its line index can be set and queried
+     */
+    const common::SourceInfo& getInfo() const;
+
 private:
 
-    InputSourceName(const std::string* name);
+    InputSourceName(const common::SourceInfo* info);
 
-    static const std::string unknown;
+    static const common::SourceInfo unknown;
 
-    const std::string* _name;
+    const common::SourceInfo* _info;
 };
 
 }
@@ -9,7 +9,10 @@
 #include "Lexer.h"
 
 #include "Tokens.h"
+#include "CharScanning.h"
 #include "../../../Utils/Utils.h"
+#include <limits>
+#include <stdexcept>
 
 namespace sfsl {
 
@@ -17,225 +20,346 @@ using namespace tok;
 
 namespace lex {
 
-Lexer::Lexer(common::AbstractMemoryManager& mngr, common::AbstractReporter& rep, src::InputSource& source, size_t sourceBufferSize) :
-    _mngr(mngr), _rep(rep), _source(source, sourceBufferSize) {
+const std::array<Lexer::CHR_KIND, 256> Lexer::CHAR_KINDS = Lexer::createCharKindsTable();
+const std::vector<Lexer::OperatorNode> Lexer::OPERATOR_TRIE = Lexer::createOperatorTrie();
+const Lexer::ReservedWordsTable Lexer::RESERVED_WORDS = Lexer::createReservedWordsTable();
 
-    _lastChar.kind = CHR_EMPTY;
-    produceNext();
-}
+Lexer::Lexer(common::AbstractReporter& rep, common::NameTable& names, src::InputSource& source, size_t sourceBufferSize) :
+    _rep(rep), _names(names), _sourceName(source.getSourceName()), _startPos(source.getPosition()), _windowStart(0) {
+
+    size_t size;
+    const char* data = source.consumeAll(size);
+
+    if (!data) {
+        std::vector<char> buffer(sourceBufferSize > 0 ? sourceBufferSize : 1);
+        while (size_t count = source.getNexts(buffer.data(), buffer.size())) {
+            _ownedInput.append(buffer.data(), count);
+        }
+        data = _ownedInput.data();
+        size = _ownedInput.size();
+    }
+
+    if (size > UINT32_MAX - _startPos) {
+        _rep.fatal(source.currentPos(), "Source is too large: positions are limited to 32 bits");
+    }
+
+    _begin = _cur = data;
+    _end = data + size;
 
-bool Lexer::hasNext() const {
-    return _curToken->getTokenType() != TOK_EOF;
+    indexLines();
 }
 
-Token* Lexer::getNext() {
-    Token* current = _curToken;
-    produceNext();
-    return current;
+bool Lexer::hasNext() {
+    return peek().type != TOK_EOF;
 }
 
-void Lexer::produceNext() {
+Token Lexer::getNext() {
+    if (_windowStart == _window.size()) {
+        // every token looked ahead was consumed: reuse the storage of the window
+        _window.clear();
+        _windowStart = 0;
+        produceNext();
+    }
 
-    while (_lastChar.kind == CHR_EMPTY || _lastChar.kind == CHR_SPACE) {
-        if (!_source.hasNext()) {
-            _curToken = _mngr.New<EOFToken>();
-            _curToken->setPos(_source.currentPos());
-            return;
-        }
+    return _window[_windowStart++];
+}
 
-        _lastChar = readCharInfo();
+const Token& Lexer::peek(size_t n) {
+    while (_window.size() - _windowStart <= n) {
+        produceNext();
     }
 
-    size_t initPos = _lastChar.pos;
+    return _window[_windowStart + n];
+}
 
-    std::string soFar;
-    soFar += _lastChar.chr;
+const src::InputSourceName& Lexer::getSourceName() const {
+    return _sourceName;
+}
 
-    STR_KIND strKind = strKindFromCharKind(_lastChar.kind);
+void Lexer::produceNext() {
+    skipSpacesAndComments();
 
-    while (_source.hasNext()) {
+    const char* begin = _cur;
+    Token token = Token();
 
-        _lastChar = readCharInfo();
+    if (_cur == _end) {
+        token.type = TOK_EOF;
+        token.startPos = static_cast<uint32_t>(positionOf(_end));
+        token.endPos = token.startPos + 1;
+        _window.push_back(token);
+        return;
+    }
 
-        if (isStillValid(strKind, soFar, _lastChar.kind, _lastChar.chr)) {
-            soFar += _lastChar.chr;
-        }
-        else if (strKind == STR_INT_LIT && _lastChar.chr == '.') {
-            strKind = STR_REAL_LIT;
-            soFar += _lastChar.chr;
-        }
-        else if (tryHandleComments(soFar, _lastChar.chr)){
-            _lastChar.kind = CHR_EMPTY;
-            produceNext();
-            return;
-        }
-        else if (strKind == STR_UNKNOWN) {
-            _rep.error(common::Positionnable(initPos, initPos + soFar.size(), _source.getSourceName()), "Unknown symbol '" + soFar + "'");
-            _curToken = _mngr.New<BadToken>(soFar);
-            _curToken->setPos(initPos, initPos + soFar.size(), _source.getSourceName());
+    switch (charKindFromChar(*_cur)) {
+    case CHR_CHARACTER: lexWord(token); break;
+    case CHR_DIGIT:     lexNumber(token); break;
+    case CHR_SYMBOL:    lexOperator(token); break;
+    case CHR_QUOTE:     lexStringLiteral(token); break;
+    default:            lexUnknown(token); break;
+    }
+
+    token.startPos = static_cast<uint32_t>(positionOf(begin));
+    token.endPos = static_cast<uint32_t>(positionOf(_cur));
+    _window.push_back(token);
+}
+
+void Lexer::skipSpacesAndComments() {
+    for (;;) {
+        _cur = scan::skipWhiteSpaces(_cur, _end);
+
+        if (_end - _cur < 2 || _cur[0] != '/') {
             return;
         }
-        else {
-            if (strKind == STR_STRING_LIT) {
-                handleStringLiteral(soFar);
-                _lastChar.kind = CHR_EMPTY;
+
+        if (_cur[1] == '/') {
+            _cur = scan::findNewLine(_cur + 2, _end);
+            if (_cur != _end) {
+                ++_cur;
+            }
+        } else if (_cur[1] == '*') {
+            const char* commentEnd = scan::findCommentEnd(_cur + 2, _end);
+
+            if (commentEnd == _end) {
+                _cur = _end;
+                _rep.error(posOf(_end, _end + 1), "Unfinished multiline comment");
+                return;
             }
 
-            _curToken = buildToken(strKind, soFar);
-            _curToken->setPos(initPos, initPos + soFar.size(), _source.getSourceName());
+            _cur = commentEnd + 2;
+        } else {
             return;
         }
+    }
+}
+
+void Lexer::lexWord(Token& token) {
+    const char* begin = _cur;
+
+    while (++_cur != _end && (charKindFromChar(*_cur) == CHR_CHARACTER || charKindFromChar(*_cur) == CHR_DIGIT));
+
+    size_t size = _cur - begin;
 
+    if (const ReservedWord* word = findReservedWord(begin, size)) {
+        // keywords, operators and booleans all keep their value in `kind`
+        token.type = word->tokType;
+        token.kind = word->value;
+        return;
     }
 
-    _lastChar.kind = CHR_EMPTY;
-    _curToken = buildToken(strKind, soFar);
-    _curToken->setPos(initPos, initPos + soFar.size(), _source.getSourceName());
+    token.type = TOK_ID;
+    token.name = _names.intern(begin, size);
 }
 
-Lexer::CharInfo Lexer::readCharInfo() {
-    size_t pos = _source.getPosition();
-    char chr = _source.getNext();
-    CHR_KIND kind = charKindFromChar(chr);
+void Lexer::lexNumber(Token& token) {
+    const char* begin = _cur;
 
-    return CharInfo{
-        .chr = chr,
-        .pos = pos,
-        .kind = kind
-    };
-}
+    while (++_cur != _end && charKindFromChar(*_cur) == CHR_DIGIT);
 
-Token* Lexer::buildToken(STR_KIND kind, const std::string& soFar) const {
-    switch (kind) {
-    case STR_SYMBOL:        return _mngr.New<Operator>(Operator::OperTypeFromString(soFar));
-    case STR_ID:            return getRightTokenFromIdentifier(soFar);
-    case STR_INT_LIT:       return _mngr.New<IntLiteral>(utils::String_toT<sfsl_int_t>(soFar));
-    case STR_REAL_LIT:      return _mngr.New<RealLiteral>(utils::String_toT<sfsl_real_t>(soFar));
-    case STR_STRING_LIT:    return _mngr.New<StringLiteral>(soFar);
-    default:                return _mngr.New<BadToken>(soFar);
+    if (_cur != _end && *_cur == '.') {
+        while (++_cur != _end && charKindFromChar(*_cur) == CHR_DIGIT);
+        token.type = TOK_REAL_LIT;
+        if (!utils::parseReal(begin, _cur, token.realValue)) {
+            _rep.error(posOf(begin, _cur), "Real literal is too large");
+            token.realValue = 0;
+        }
+        return;
     }
-}
 
-Token* Lexer::getRightTokenFromIdentifier(const std::string& str) const{
-    if (isValidKeyword(str)) {
-        return _mngr.New<Keyword>(Keyword::KeywordTypeFromString(str));
-    } else if (Operator::OperTypeFromIdentifierString(str) != OPER_UNKNOWN) {
-        return _mngr.New<Operator>(Operator::OperTypeFromString(str));
-    } else if (str == "true") {
-        return _mngr.New<BoolLiteral>(true);
-    } else if (str == "false") {
-        return _mngr.New<BoolLiteral>(false);
-    } else {
-        return _mngr.New<Identifier>(str);
+    token.type = TOK_INT_LIT;
+    if (!utils::parseInteger(begin, _cur, token.intValue)) {
+        _rep.error(posOf(begin, _cur), "Integer literal is too large (the maximum is " +
+                   utils::T_toString(std::numeric_limits<sfsl_int_t>::max()) + ")");
+        token.intValue = 0;
     }
 }
 
-void Lexer::handleStringLiteral(std::string& soFar) {
-    soFar = "";
-    if (_lastChar.chr == '\"')
-        return;
+void Lexer::lexOperator(Token& token) {
+    size_t node = 0;
+
+    // longest match, where every prefix of the operator must be an operator itself
+    while (_cur != _end && (unsigned char)*_cur < 128) {
+        size_t next = OPERATOR_TRIE[node].next[(unsigned char)*_cur];
+        if (next == 0 || OPERATOR_TRIE[next].type == OPER_UNKNOWN) {
+            break;
+        }
+        node = next;
+        ++_cur;
+    }
+
+    if (node == 0) {
+        // a symbol which does not start any operator, e.g. '?'
+        ++_cur;
+    }
 
-    soFar += _lastChar.chr;
+    token.type = TOK_OPER;
+    token.kind = OPERATOR_TRIE[node].type;
+}
+
+void Lexer::lexStringLiteral(Token& token) {
+    std::string value;
 
-    bool escaping = false;
+    for (++_cur;;) {
+        const char* stop = scan::findStringLiteralStop(_cur, _end);
+        value.append(_cur, stop);
+        _cur = stop;
 
-    for(;;) {
-        if (!_source.hasNext()) {
-            _rep.fatal(_source.currentPos(), "Unfinished string Literal");
+        if (_cur == _end) {
+            _rep.error(posOf(_end, _end + 1), "Unfinished string Literal");
+            break;
         }
 
-        char c = _source.getNext();
+        char c = *_cur++;
+
+        if (c == '\"') {
+            break;
+        } else if (c == '\\') {
+            if (_cur == _end) {
+                continue;
+            }
+
+            c = *_cur++;
 
-        if (escaping) {
-            escaping = false;
             if (chrutils::escapedChar(c)) {
-                soFar += c;
+                value += c;
             } else {
-                _rep.error(_source.currentPos(), std::string("Unknown escape sequence '\\") + c + "'");
+                _rep.error(posOf(_cur - 2, _cur), std::string("Unknown escape sequence '\\") + c + "'");
             }
-            continue;
         }
+    }
 
-        if (c == '\"') {
-            return;
-        } else if (c == '\\') {
-            escaping = true;
-        } else if (!chrutils::isNewLine(c)) {
-            soFar += c;
+    token.type = TOK_STR_LIT;
+    token.name = _names.intern(value);
+}
+
+void Lexer::lexUnknown(Token& token) {
+    std::string symbol(1, *_cur++);
+    _rep.error(posOf(_cur - 1, _cur), "Unknown symbol '" + symbol + "'");
+    token.type = TOK_BAD;
+    token.name = _names.intern(symbol);
+}
+
+void Lexer::indexLines() const {
+    std::vector<uint32_t> lineStarts(1, static_cast<uint32_t>(_startPos));
+
+    for (const char* c = scan::findNewLine(_begin, _end); c != _end; c = scan::findNewLine(c, _end)) {
+        if (*c++ == '\r' && c != _end && *c == '\n') {
+            ++c;
         }
+        lineStarts.push_back(static_cast<uint32_t>(positionOf(c)));
     }
+
+    _sourceName.getInfo().setLineStarts(std::move(lineStarts));
 }
 
-bool Lexer::tryHandleComments(const std::string& soFar, char next) {
-    if (soFar.size() >= 1) {
-        if (soFar.back() == '/') {
-            switch (next) {
-            case '*':   handleMultiLineComment(); return true;
-            case '/':   handleSingleLineComment(); return true;
-            default:    return false;
-            }
-        }
+size_t Lexer::positionOf(const char* chr) const {
+    return _startPos + (chr - _begin);
+}
+
+common::Positionnable Lexer::posOf(const char* start, const char* end) const {
+    return common::Positionnable(positionOf(start), positionOf(end), _sourceName);
+}
+
+std::array<Lexer::CHR_KIND, 256> Lexer::createCharKindsTable() {
+    std::array<CHR_KIND, 256> table;
+
+    for (size_t i = 0; i < table.size(); ++i) {
+        char c = (char)i;
+
+        if (chrutils::isSymbol(c))          table[i] = CHR_SYMBOL;
+        else if (chrutils::isCharacter(c))  table[i] = CHR_CHARACTER;
+        else if (chrutils::isNumeric(c))    table[i] = CHR_DIGIT;
+        else if (chrutils::isWhiteSpace(c)) table[i] = CHR_SPACE;
+        else if (chrutils::isQuote(c))      table[i] = CHR_QUOTE;
+        else                                table[i] = CHR_UNKNOWN;
     }
-    return false;
+
+    return table;
 }
 
-void Lexer::handleMultiLineComment() {
-    char oldChr = 0;
-    char chr = 0;
+std::vector<Lexer::OperatorNode> Lexer::createOperatorTrie() {
+    std::vector<OperatorNode> trie(1, OperatorNode{OPER_UNKNOWN, {0}});
 
-    while (oldChr != '*' || chr != '/') {
-        if (!_source.hasNext()) {
-            _rep.fatal(_source.currentPos(), "Unfinished multiline comment");
+    for (size_t op = 0; op < OPER_UNKNOWN; ++op) {
+        std::string str(OPERATOR_TABLE[op].symbol);
+        size_t node = 0;
+
+        for (char c : str) {
+            uint8_t next = trie[node].next[(unsigned char)c];
+            if (next == 0) {
+                if (trie.size() > std::numeric_limits<uint8_t>::max()) {
+                    throw std::logic_error("The operator trie does not fit in 8 bit node indices");
+                }
+
+                // the node must be updated before growing the trie, which moves its storage
+                next = (uint8_t)trie.size();
+                trie[node].next[(unsigned char)c] = next;
+                trie.push_back(OperatorNode{OPER_UNKNOWN, {0}});
+            }
+            node = next;
         }
 
-        oldChr = chr;
-        chr = _source.getNext();
+        trie[node].type = (OPER_TYPE)op;
     }
+
+    return trie;
 }
 
-void Lexer::handleSingleLineComment() {
-    char chr = 0;
-    while (_source.hasNext() && !chrutils::isNewLine(chr)) {
-        chr = _source.getNext();
+Lexer::ReservedWordsTable Lexer::createReservedWordsTable() {
+    std::vector<ReservedWord> words;
+
+    for (size_t kw = 0; kw < KW_UNKNOWN; ++kw) {
+        words.push_back(ReservedWord{KeywordTypeToString((KW_TYPE)kw), TOK_KW, (int)kw});
     }
-}
 
-bool Lexer::isStillValid(STR_KIND strKind, const std::string& soFar, CHR_KIND chrKind, char nextChar) {
-    switch (strKind) {
-    case STR_SYMBOL:    return chrKind == CHR_SYMBOL && isValidSymbol(soFar + nextChar);
-    case STR_ID:        return chrKind == CHR_CHARACTER || chrKind == CHR_DIGIT;
-    case STR_INT_LIT:   return chrKind == CHR_DIGIT;
-    case STR_REAL_LIT:  return chrKind == CHR_DIGIT;
-    case STR_STRING_LIT:return false;
-    default:            return false;
+    for (const OperatorInfo& info : OPERATOR_TABLE) {
+        if (info.word) {
+            words.push_back(ReservedWord{info.word, TOK_OPER, info.type});
+        }
+    }
+
+    words.push_back(ReservedWord{"true", TOK_BOOL_LIT, 1});
+    words.push_back(ReservedWord{"false", TOK_BOOL_LIT, 0});
+
+    // look for a seed under which no two words collide
+    for (ReservedWordsTable table{0, {}};; ++table.seed) {
+        table.slots.fill(ReservedWord{"", TOK_BAD, 0});
+        bool collision = false;
+
+        for (const ReservedWord& word : words) {
+            ReservedWord& slot(table.slots[hashWord(word.text.data(), word.text.size(), table.seed) % ReservedWordsTable::SIZE]);
+            if (!slot.text.empty()) {
+                collision = true;
+                break;
+            }
+            slot = word;
+        }
+
+        if (!collision) {
+            return table;
+        }
     }
 }
 
-bool Lexer::isValidSymbol(const std::string& str) {
-    return Operator::OperTypeFromString(str) != OPER_UNKNOWN;
+uint32_t Lexer::hashWord(const char* word, size_t size, uint32_t seed) {
+    uint32_t hash = 2166136261u ^ seed;
+    for (size_t i = 0; i < size; ++i) {
+        hash = (hash ^ (unsigned char)word[i]) * 16777619u;
+    }
+    return hash ^ (hash >> 16);
 }
 
-bool Lexer::isValidKeyword(const std::string& str) {
-    return Keyword::KeywordTypeFromString(str) != KW_UNKNOWN;
+const Lexer::ReservedWord* Lexer::findReservedWord(const char* word, size_t size) {
+    const ReservedWord& slot(RESERVED_WORDS.slots[hashWord(word, size, RESERVED_WORDS.seed) % ReservedWordsTable::SIZE]);
+
+    if (slot.text.size() == size && slot.text.compare(0, size, word, size) == 0) {
+        return &slot;
+    }
+
+    return nullptr;
 }
 
 Lexer::CHR_KIND Lexer::charKindFromChar(char c) {
-    if (chrutils::isSymbol(c))          return CHR_SYMBOL;
-    else if (chrutils::isCharacter(c))  return CHR_CHARACTER;
-    else if (chrutils::isNumeric(c))    return CHR_DIGIT;
-    else if (chrutils::isWhiteSpace(c)) return CHR_SPACE;
-    else if (chrutils::isQuote(c))      return CHR_QUOTE;
-    else                                return CHR_UNKNOWN;
-}
-
-Lexer::STR_KIND Lexer::strKindFromCharKind(Lexer::CHR_KIND c) {
-    switch (c) {
-    case CHR_SYMBOL:    return STR_SYMBOL;
-    case CHR_CHARACTER: return STR_ID;
-    case CHR_DIGIT:     return STR_INT_LIT;
-    case CHR_QUOTE:     return STR_STRING_LIT;
-    default:            return STR_UNKNOWN;
-    }
+    return CHAR_KINDS[(unsigned char)c];
 }
 
 }
@@ -10,7 +10,9 @@
 #define __SFSL__Lexer__
 
 #include <iostream>
-#include "BufferedInputSource.h"
+#include <array>
+#include <vector>
+#include "InputSource.h"
 #include "Tokens.h"
 #include "../../Common/CompilationContext.h"
 
@@ -20,66 +22,129 @@ namespace lex {
 
 /**
  * @brief Transforms an SFSL source file given as an inputstream into a sequence of #sfsl::tok::Token
- * that are accessible with Lexer#getNext().
+ * that are accessible with Lexer#getNext(), and that can be looked ahead with Lexer#peek().
+ *
+ * The lexer works in a single pass over the characters of the source, which it reads in place
+ * when they already live in memory. Characters are classified with a lookup table, operators are
+ * recognized by walking a trie and reserved words are found with a perfect hash. The names of the
+ * identifiers are interned as soon as they are read. Before producing the first token, the lexer
+ * records where the lines of the source start so that positions can later be reported as lines
+ * and columns.
+ *
+ * Tokens are produced on demand into a window holding the tokens that were looked ahead but not
+ * consumed yet. Since tokens are plain records, the window is a vector whose storage is reused
+ * once all of them are consumed, so lexing does not allocate memory per token.
  */
 class Lexer final {
 public:
 
     /**
      * @brief Creates a Lexer object
-     * @param mngr The memory manager used throughout the tokenization process
+     * @param rep The reporter to which lexical errors are reported
+     * @param names The table in which the identifiers are interned
      * @param source The input source
-     * @param sourceBufferSize The size of the buffer used by the source reader
+     * @param sourceBufferSize The size of the chunks in which the source is read,
+     * if it does not already live in memory
      */
-    Lexer(common::AbstractMemoryManager& mngr, common::AbstractReporter& rep, src::InputSource& source, size_t sourceBufferSize = 128);
+    Lexer(common::AbstractReporter& rep, common::NameTable& names, src::InputSource& source, size_t sourceBufferSize = 128);
 
     /**
-     * @return True if there are more tokens to come, otherwise false
+     * @return True if there are more tokens to come before the end of file token, otherwise false
      */
-    bool hasNext() const;
+    bool hasNext();
 
     /**
-     * @return The next produced #sfsl::tok::Token
+     * @return The next #sfsl::tok::Token, which is consumed. Once the end of
+     * the source is reached, end of file tokens are returned indefinitely.
      */
-    tok::Token* getNext();
+    tok::Token getNext();
+
+    /**
+     * @param n The number of tokens to skip
+     * @return The token that the (n + 1)th call to Lexer#getNext() would return,
+     * without consuming any token. The reference is only valid until the next
+     * call to a non-const method of the lexer.
+     */
+    const tok::Token& peek(size_t n = 0);
+
+    /**
+     * @return The name of the source being lexed
+     */
+    const src::InputSourceName& getSourceName() const;
 
 private:
 
-    enum CHR_KIND { CHR_SYMBOL, CHR_CHARACTER, CHR_DIGIT, CHR_SPACE, CHR_QUOTE, CHR_EMPTY, CHR_UNKNOWN };
-    enum STR_KIND { STR_SYMBOL, STR_ID, STR_STRING_LIT, STR_INT_LIT, STR_REAL_LIT, STR_UNKNOWN };
+    enum CHR_KIND { CHR_SYMBOL, CHR_CHARACTER, CHR_DIGIT, CHR_SPACE, CHR_QUOTE, CHR_UNKNOWN };
 
-    struct CharInfo {
-        char chr;
-        size_t pos;
-        CHR_KIND kind;
+    /**
+     * @brief A node of the trie recognizing the operators made of symbols.
+     * `next` maps an ascii character to the index of the child node, or to 0 if there is none.
+     */
+    struct OperatorNode final {
+        tok::OPER_TYPE type;
+        uint8_t next[128];
     };
 
-    static bool isStillValid(STR_KIND strKind, const std::string& soFar, CHR_KIND chrKind, char nextChar);
-    static bool isValidSymbol(const std::string& str);
-    static bool isValidKeyword(const std::string& str);
+    /**
+     * @brief A word which does not produce an identifier: a keyword,
+     * a boolean literal or an operator written in letters (e.g. "and")
+     */
+    struct ReservedWord final {
+        std::string text;
+        tok::TOK_TYPE tokType;
+        int value;
+    };
 
-    static CHR_KIND charKindFromChar(char c);
-    static STR_KIND strKindFromCharKind(CHR_KIND c);
+    /**
+     * @brief Table of the reserved words, in which each word has a slot
+     * of its own when hashed with `seed`.
+     */
+    struct ReservedWordsTable final {
+        static const size_t SIZE = 64;
+
+        uint32_t seed;
+        std::array<ReservedWord, SIZE> slots;
+    };
 
-    CharInfo readCharInfo();
+    static std::array<CHR_KIND, 256> createCharKindsTable();
+    static std::vector<OperatorNode> createOperatorTrie();
+    static ReservedWordsTable createReservedWordsTable();
+
+    static uint32_t hashWord(const char* word, size_t size, uint32_t seed);
+    static const ReservedWord* findReservedWord(const char* word, size_t size);
+
+    static CHR_KIND charKindFromChar(char c);
 
     void produceNext();
+    void skipSpacesAndComments();
+
+    void lexWord(tok::Token& token);
+    void lexNumber(tok::Token& token);
+    void lexOperator(tok::Token& token);
+    void lexStringLiteral(tok::Token& token);
+    void lexUnknown(tok::Token& token);
+
+    void indexLines() const;
 
-    tok::Token* buildToken(STR_KIND kind, const std::string& soFar) const;
-    tok::Token* getRightTokenFromIdentifier(const std::string& str) const;
+    size_t positionOf(const char* chr) const;
+    common::Positionnable posOf(const char* start, const char* end) const;
 
-    void handleStringLiteral(std::string& soFar);
-    bool tryHandleComments(const std::string& soFar, char next);
-    void handleMultiLineComment();
-    void handleSingleLineComment();
+    static const std::array<CHR_KIND, 256> CHAR_KINDS;
+    static const std::vector<OperatorNode> OPERATOR_TRIE;
+    static const ReservedWordsTable RESERVED_WORDS;
 
-    common::AbstractMemoryManager& _mngr;
     common::AbstractReporter& _rep;
-    src::BufferedInputSource _source;
+    common::NameTable& _names;
+    src::InputSourceName _sourceName;
 
-    tok::Token* _curToken;
+    std::string _ownedInput;
+    const char* _begin;
+    const char* _cur;
+    const char* _end;
+    size_t _startPos;
 
-    CharInfo _lastChar;
+    std::vector<tok::Token> _window;
+    size_t _windowStart;
 
 };
 
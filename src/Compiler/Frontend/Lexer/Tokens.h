@@ -9,10 +9,11 @@
 #ifndef __SFSL__Tokens__
 #define __SFSL__Tokens__
 
-#include <unordered_map>
+#include <string>
+#include <cstdint>
 
-#include "../../Common/MemoryManageable.h"
-#include "../../Common/Positionnable.h"
+#include "InputSourceName.h"
+#include "../../Common/Name.h"
 #include "../../../Utils/Utils.h"
 
 namespace sfsl {
@@ -24,59 +25,6 @@ namespace tok {
  */
 enum TOK_TYPE { TOK_OPER, TOK_ID, TOK_KW, TOK_BOOL_LIT, TOK_INT_LIT, TOK_REAL_LIT, TOK_STR_LIT, TOK_EOF, TOK_BAD };
 
-/**
- * @brief Represents an abstract Token
- */
-class Token : public common::MemoryManageable, public common::Positionnable {
-public:
-
-    virtual ~Token();
-
-    /**
-     * @return the type of the token
-     */
-    virtual TOK_TYPE getTokenType() const = 0;
-
-    /**
-     * @return a string representation of the token
-     */
-    virtual std::string toString() const = 0;
-
-    /**
-     * @return a string representation of the token with details
-     */
-    std::string toStringDetailed() const;
-
-    /**
-     * @param type the type to represent as a string
-     * @return the string representation of the type
-     */
-    static std::string TokenTypeToString(TOK_TYPE type);
-
-};
-
-/**
- * @brief Represents an identifier
- */
-class Identifier : public Token {
-public:
-
-    /**
-     * @brief Creates an Itentifier Token
-     * @param id the name of the identifier
-     */
-    Identifier(const std::string& id);
-    virtual ~Identifier();
-
-    virtual TOK_TYPE getTokenType() const override;
-    virtual std::string toString() const override;
-
-private:
-
-    const std::string _id;
-};
-
-
 /**
  * @brief Enumerates every possible Keyword
  */
@@ -85,151 +33,6 @@ enum KW_TYPE {
     KW_IN, KW_OUT, KW_NEW, KW_THIS,
     KW_IF, KW_ELSE, KW_WHILE, KW_FOR, KW_UNKNOWN };
 
-/**
- * @brief Represents a Keyword
- */
-class Keyword : public Token {
-public:
-
-    /**
-     * @brief Creates a Keyword Token
-     * @param kwType the type of the Keyword
-     */
-    Keyword(KW_TYPE kwType);
-    virtual ~Keyword();
-
-    virtual TOK_TYPE getTokenType() const override;
-    virtual std::string toString() const override;
-
-    /**
-     * @return the Keyword type of this particular instance
-     */
-    KW_TYPE getKwType();
-
-    /**
-     * @param type the Keyword type to convert
-     * @return the string representation of the keyword type
-     */
-    static std::string KeywordTypeToString(KW_TYPE type);
-
-    /**
-     * @param str the string representation of the keyword type
-     * @return the associated Keyword type
-     */
-    static KW_TYPE KeywordTypeFromString(const std::string& str);
-
-private:
-
-    static std::unordered_map<std::string, KW_TYPE> KEYWORDS;
-
-    const KW_TYPE _kwType;
-
-};
-
-/**
- * @brief Represents a Boolean Literal (true or false)
- */
-class BoolLiteral : public Token {
-public:
-
-    /**
-     * @brief Creates a Boolean Literal Token
-     * @param value the value of the Literal
-     */
-    BoolLiteral(sfsl_bool_t value);
-    virtual ~BoolLiteral();
-
-    virtual TOK_TYPE getTokenType() const override;
-    virtual std::string toString() const override;
-
-    sfsl_bool_t getValue() const;
-
-private:
-
-    const sfsl_bool_t _value;
-};
-
-/**
- * @brief Represents an Integer Literal (e.g. 42)
- */
-class IntLiteral : public Token {
-public:
-
-    /**
-     * @brief Creates an Integer Literal Token
-     * @param value the value of the Literal
-     */
-    IntLiteral(sfsl_int_t value);
-    virtual ~IntLiteral();
-
-    virtual TOK_TYPE getTokenType() const override;
-    virtual std::string toString() const override;
-
-    /**
-     * @return this Literal's int value
-     */
-    sfsl_int_t getValue() const;
-
-private:
-
-    const sfsl_int_t _value;
-
-};
-
-/**
- * @brief Represents a Real Literal (e.g. 3.14)
- */
-class RealLiteral : public Token {
-public:
-
-    /**
-     * @brief Creates a Real Literal Token
-     * @param value the value of the Literal
-     */
-    RealLiteral(sfsl_real_t value);
-    virtual ~RealLiteral();
-
-    virtual TOK_TYPE getTokenType() const override;
-    virtual std::string toString() const override;
-
-    /**
-     * @return this Literal's real value
-     */
-    sfsl_real_t getValue() const;
-
-private:
-
-    const sfsl_real_t _value;
-
-};
-
-/**
- * @brief Represents a String Literal (e.g. "hello world")
- */
-class StringLiteral : public Token {
-public:
-
-    /**
-     * @brief Creates a String Literal
-     * @param value the value of the Literal
-     */
-    StringLiteral(const std::string& value);
-    virtual ~StringLiteral();
-
-    virtual TOK_TYPE getTokenType() const override;
-    virtual std::string toString() const override;
-
-    /**
-     * @return this Literal's string value
-     */
-    std::string getValue() const;
-
-private:
-
-    const std::string _value;
-
-};
-
 /**
  * @brief Enumerates every possible Operator type
  */
@@ -246,113 +49,191 @@ enum OPER_TYPE {
     OPER_UNKNOWN };
 
 /**
- * @brief Represents an Operator Token (e.g. '+', '/', ';', '{')
+ * @brief Describes how an operator is written and how it binds in binary expressions
  */
-class Operator : public Token {
-public:
+struct OperatorInfo final {
+    OPER_TYPE type;
+    const char* symbol;         ///< the characters of the operator, e.g. "&&"
+    const char* word;           ///< the reserved word that can be used instead of the symbol, e.g. "and", or nullptr
+    int precedence;             ///< -1 if the operator cannot continue a binary expression
+    bool rightAssociative;
+};
 
-    /**
-     * @brief Creates an Operator Token
-     * @param opType the type of the Operator
-     */
-    Operator(OPER_TYPE opType);
-    virtual ~Operator();
+/**
+ * @brief The description of every operator, indexed by OPER_TYPE
+ * (the last entry describes OPER_UNKNOWN)
+ */
+constexpr OperatorInfo OPERATOR_TABLE[] = {
+    // BINARY OPERATORS
+    {OPER_PLUS,         "+",    nullptr,    20,     false},
+    {OPER_MINUS,        "-",    nullptr,    20,     false},
+    {OPER_TIMES,        "*",    nullptr,    40,     false},
+    {OPER_DIV,          "/",    nullptr,    40,     false},
+    {OPER_MOD,          "%",    nullptr,    40,     false},
+    {OPER_POW,          "^",    nullptr,    50,     true},
+    {OPER_AND,          "&&",   "and",      6,      false},
+    {OPER_OR,           "||",   "or",       5,      false},
+    {OPER_BIT_AND,      "&",    nullptr,    8,      false},
+    {OPER_BIT_OR,       "|",    nullptr,    7,      false},
+    {OPER_L_SHIFT,      "<<",   nullptr,    15,     false},
+    {OPER_R_SHIFT,      ">>",   nullptr,    15,     false},
+
+    // ASSIGNMENT OPERATORS
+    {OPER_EQ,           "=",    nullptr,    2,      true},
+    {OPER_PLUS_EQ,      "+=",   nullptr,    2,      true},
+    {OPER_MINUS_EQ,     "-=",   nullptr,    2,      true},
+    {OPER_TIMES_EQ,     "*=",   nullptr,    2,      true},
+    {OPER_DIV_EQ,       "/=",   nullptr,    2,      true},
+    {OPER_MOD_EQ,       "%=",   nullptr,    2,      true},
+    {OPER_POW_EQ,       "^=",   nullptr,    2,      true},
+    {OPER_B_AND_EQ,     "&=",   nullptr,    2,      true},
+    {OPER_B_OR_EQ,      "|=",   nullptr,    2,      true},
+    {OPER_L_SHIFT_EQ,   "<<=",  nullptr,    2,      true},
+    {OPER_R_SHIFT_EQ,   ">>=",  nullptr,    2,      true},
+
+    // UNARY OPERATORS
+    {OPER_BANG,         "!",    "not",      -1,     false},
+    {OPER_TILDE,        "~",    nullptr,    -1,     false},
+
+    // COMPARISON OPERATORS
+    {OPER_EQ_EQ,        "==",   nullptr,    9,      false},
+    {OPER_NOT_EQ,       "!=",   nullptr,    9,      false},
+    {OPER_LT,           "<",    nullptr,    10,     false},
+    {OPER_GT,           ">",    nullptr,    10,     false},
+    {OPER_LE,           "<=",   nullptr,    10,     false},
+    {OPER_GE,           ">=",   nullptr,    10,     false},
+
+    // BRACKETS
+    {OPER_L_PAREN,      "(",    nullptr,    100,    false},
+    {OPER_R_PAREN,      ")",    nullptr,    -1,     false},
+    {OPER_L_BRACKET,    "[",    nullptr,    100,    false},
+    {OPER_R_BRACKET,    "]",    nullptr,    -1,     false},
+    {OPER_L_BRACE,      "{",    nullptr,    -1,     false},
+    {OPER_R_BRACE,      "}",    nullptr,    -1,     false},
+
+    // SYMBOLS
+    {OPER_DOT,          ".",    nullptr,    70,     false},
+    {OPER_COLON,        ":",    nullptr,    65,     false},
+    {OPER_COMMA,        ",",    nullptr,    -1,     false},
+    {OPER_SEMICOLON,    ";",    nullptr,    -1,     false},
+
+    // OTHERS
+    {OPER_THIN_ARROW,   "->",   nullptr,    100,    false},
+    {OPER_FAT_ARROW,    "=>",   nullptr,    80,     false},
+    {OPER_DOT_DOT,      "..",   nullptr,    -1,     false},
+    {OPER_AT,           "@",    nullptr,    -1,     false},
+    {OPER_SHARP,        "#",    nullptr,    -1,     false},
+
+    {OPER_UNKNOWN,      "",     nullptr,    -1,     false}
+};
+
+/**
+ * @brief All the unary operators have the same precedence,
+ * so there is no need to store it in the operator table
+ */
+constexpr int UNARY_OPERATOR_PRECEDENCE = 60;
+
+/**
+ * @brief Represents a token as a fixed-size record, which can be copied around
+ * and stored contiguously. Which fields are meaningful depends on the type:
+ *  - TOK_OPER: `kind` holds the OPER_TYPE
+ *  - TOK_KW: `kind` holds the KW_TYPE
+ *  - TOK_BOOL_LIT: `kind` holds the value (0 or 1)
+ *  - TOK_INT_LIT / TOK_REAL_LIT: `intValue` / `realValue` hold the value
+ *  - TOK_ID / TOK_STR_LIT / TOK_BAD: `name` holds the interned name, string value or text
+ */
+struct Token final {
+    TOK_TYPE type;
+    int kind;
+    uint32_t startPos;
+    uint32_t endPos;
 
-    virtual TOK_TYPE getTokenType() const override;
-    virtual std::string toString() const override;
+    union {
+        sfsl_int_t intValue;
+        sfsl_real_t realValue;
+    };
+
+    common::Name name;
 
     /**
-     * @return The OPER_TYPE of this instance
+     * @return the OPER_TYPE of the token if it is an operator, otherwise OPER_UNKNOWN
      */
-    OPER_TYPE getOpType() const;
+    OPER_TYPE getOpType() const {
+        return type == TOK_OPER ? (OPER_TYPE)kind : OPER_UNKNOWN;
+    }
 
     /**
-     * @return The precedence of this operator
+     * @return the KW_TYPE of the token if it is a keyword, otherwise KW_UNKNOWN
      */
-    int getPrecedence() const;
+    KW_TYPE getKwType() const {
+        return type == TOK_KW ? (KW_TYPE)kind : KW_UNKNOWN;
+    }
 
     /**
-     * @return True if the operator is right associative
+     * @return the precedence of the token if it is an operator, otherwise -1
      */
-    bool isRightAssociative() const;
+    int getPrecedence() const {
+        return OPERATOR_TABLE[getOpType()].precedence;
+    }
 
     /**
-     * @brief All the unary operators have the same precedence,
-     * so there is no need to store the precedence of unary operators
-     * in the precedence table
-     *
-     * @return The precedence of any unary operator
+     * @return True if the token is a right associative operator
      */
-    static int getUnaryOperatorPrecedence();
+    bool isRightAssociative() const {
+        return OPERATOR_TABLE[getOpType()].rightAssociative;
+    }
 
     /**
-     * @brief Converts an OPER_TYPE to its string representation
-     * @param type The OPER_TYPE to convert
-     * @return The string representation of the given OPER_TYPE
+     * @return a string representation of the token
      */
-    static std::string OperTypeToString(OPER_TYPE type);
+    std::string toString() const;
 
     /**
-     * @brief Converts a string into an OPER_TYPE
-     * @param str The string to convert
-     * @return The associated OPER_TYPE
+     * @param source the name of the source the token comes from
+     * @return a string representation of the token with details
      */
-    static OPER_TYPE OperTypeFromString(const std::string& str);
+    std::string toStringDetailed(const src::InputSourceName& source) const;
 
     /**
-     * @brief Converts a string which holds an identifier kind of content
-     * into an OPER_TYPE, e.g. "and", "or", "not"
-     * @param id The string to convert
-     * @return The associated OPER_TYPE
+     * @param type the type to represent as a string
+     * @return the string representation of the type
      */
-    static OPER_TYPE OperTypeFromIdentifierString(const std::string& id);
-
-private:
-
-    static std::unordered_map<std::string, OPER_TYPE> OPERATORS;
-    static std::vector<int> PRECEDENCE;
-
-    const OPER_TYPE _opType;
-
+    static std::string TokenTypeToString(TOK_TYPE type);
 };
 
 /**
- * @brief Represents the last token of the source
+ * @param type the Keyword type to convert
+ * @return the string representation of the keyword type
  */
-class EOFToken : public Token {
-public:
-
-    /**
-     * @brief Creates an EOF Token
-     */
-    EOFToken();
-    virtual ~EOFToken();
-
-    virtual TOK_TYPE getTokenType() const override;
-    virtual std::string toString() const override;
-
-};
+std::string KeywordTypeToString(KW_TYPE type);
 
 /**
- * @brief Represents an invalid token
+ * @param str the string representation of the keyword type
+ * @return the associated Keyword type
  */
-class BadToken : public Token {
-public:
-
-    /**
-     * @brief Creates a BAD Token
-     */
-    BadToken(const std::string& str);
-
-    virtual ~BadToken();
+KW_TYPE KeywordTypeFromString(const std::string& str);
 
-    virtual TOK_TYPE getTokenType() const override;
-    virtual std::string toString() const override;
+/**
+ * @brief Converts an OPER_TYPE to its string representation
+ * @param type The OPER_TYPE to convert
+ * @return The string representation of the given OPER_TYPE
+ */
+std::string OperTypeToString(OPER_TYPE type);
 
-private:
+/**
+ * @brief Converts a string into an OPER_TYPE
+ * @param str The string to convert
+ * @return The associated OPER_TYPE
+ */
+OPER_TYPE OperTypeFromString(const std::string& str);
 
-    const std::string _str;
-};
+/**
+ * @brief Converts a string which holds an identifier kind of content
+ * into an OPER_TYPE, e.g. "and", "or", "not"
+ * @param id The string to convert
+ * @return The associated OPER_TYPE
+ */
+OPER_TYPE OperTypeFromIdentifierString(const std::string& id);
 
 }
 
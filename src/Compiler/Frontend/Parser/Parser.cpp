@@ -14,14 +14,19 @@
 #include "../AST/Visitors/ASTTypeIdentifier.h"
 #include "../AST/Visitors/ASTExpr2TypeExpr.h"
 
-#define SAVE_POS(ident) const common::Positionnable ident = *_currentToken;
+#define SAVE_POS(ident) const common::Positionnable ident = posOf(_currentToken);
 
 namespace sfsl {
 
 using namespace ast;
 
 Parser::Parser(CompCtx_Ptr& ctx, lex::Lexer& lexer, const common::AbstractPrimitiveNamer* namer)
-    : _ctx(ctx), _mngr(ctx->memoryManager()), _lex(lexer), _namer(namer), _lastTokenEndPos(0), _currentToken(nullptr) {
+    : Parser(ctx, ctx->reporter(), lexer, namer) {
+
+}
+
+Parser::Parser(CompCtx_Ptr& ctx, common::AbstractReporter& rep, lex::Lexer& lexer, const common::AbstractPrimitiveNamer* namer)
+    : _ctx(ctx), _mngr(ctx->memoryManager()), _rep(rep), _lex(lexer), _namer(namer), _lastTokenEndPos(0), _consumedTokens(0), _lastErrorToken(0) {
 
 }
 
@@ -30,6 +35,16 @@ Program* Parser::parse() {
     return parseProgram();
 }
 
+void Parser::parseModules(const std::function<void(ModuleDecl*)>& onModule) {
+    _currentToken = _lex.getNext();
+
+    while (!isType(tok::TOK_EOF)) {
+        if (ModuleDecl* module = parseTopLevelModule()) {
+            onModule(module);
+        }
+    }
+}
+
 Expression* Parser::parseSingleExpression() {
     _currentToken = _lex.getNext();
     return parseExpression();
@@ -47,7 +62,7 @@ const std::string Parser::AnonymousTypeConstructorName = "<anonymous type constr
 const std::string Parser::AnonymousFunctionName = "<anonymous function>";
 
 bool Parser::isType(tok::TOK_TYPE type) {
-    return _currentToken->getTokenType() == type;
+    return _currentToken.type == type;
 }
 
 bool Parser::accept(tok::TOK_TYPE type) {
@@ -57,35 +72,177 @@ bool Parser::accept(tok::TOK_TYPE type) {
 }
 
 bool Parser::accept(tok::OPER_TYPE type) {
-    bool toRet = isType(tok::TOK_OPER) && ((tok::Operator*)_currentToken)->getOpType() == type;
+    bool toRet = _currentToken.getOpType() == type;
     if (toRet) accept();
     return toRet;
 }
 
 bool Parser::accept(tok::KW_TYPE type) {
-    bool toRet = isType(tok::TOK_KW) && ((tok::Keyword*)_currentToken)->getKwType() == type;
+    bool toRet = _currentToken.getKwType() == type;
     if (toRet) accept();
     return toRet;
 }
 
 void Parser::accept() {
-    _lastTokenEndPos = _currentToken->getEndPosition();
+    _lastTokenEndPos = _currentToken.endPos;
     _currentToken = _lex.getNext();
+    ++_consumedTokens;
+}
+
+common::Positionnable Parser::posOf(const tok::Token& token) const {
+    return common::Positionnable(token.startPos, token.endPos, _lex.getSourceName());
+}
+
+void Parser::reportErrorAtCurrentToken(const std::string& msg) {
+    if (_lastErrorToken != _consumedTokens + 1) {
+        _rep.error(posOf(_currentToken), msg);
+        _lastErrorToken = _consumedTokens + 1;
+    }
 }
 
 void Parser::reportUnexpectedCurrentToken() {
-    _ctx->reporter().error(*_currentToken, "Unexpected token `" + _currentToken->toString() + "`");
+    reportErrorAtCurrentToken("Unexpected token `" + _currentToken.toString() + "`");
+}
+
+void Parser::synchronize(SYNC_POINT point) {
+    size_t depth = 0;
+
+    for (; !isType(tok::TOK_EOF); accept()) {
+        if (isType(tok::TOK_OPER)) {
+            switch (_currentToken.getOpType()) {
+            case tok::OPER_L_PAREN:
+            case tok::OPER_L_BRACKET:
+            case tok::OPER_L_BRACE:
+                ++depth;
+                break;
+
+            case tok::OPER_R_BRACE:
+                if (depth == 0 && point != SYNC_TOP_LEVEL) {
+                    return; // closes the enclosing body or block, which consumes it
+                }
+                // fallthrough
+            case tok::OPER_R_PAREN:
+            case tok::OPER_R_BRACKET:
+                if (depth > 0) {
+                    --depth;
+                }
+                break;
+
+            case tok::OPER_SEMICOLON:
+                if (depth == 0 && point != SYNC_TOP_LEVEL) {
+                    accept();
+                    return;
+                }
+                break;
+
+            case tok::OPER_AT:
+                if (depth == 0 && point != SYNC_STATEMENT) {
+                    return;
+                }
+                break;
+
+            default:
+                break;
+            }
+        } else if (depth == 0 && point == SYNC_MEMBER && isType(tok::TOK_ID)) {
+            if (_lex.peek().getOpType() == tok::OPER_COLON) {
+                return; // the start of a class field
+            }
+        } else if (depth == 0 && isType(tok::TOK_KW)) {
+            switch (_currentToken.getKwType()) {
+            case tok::KW_MODULE:
+                if (point != SYNC_STATEMENT) {
+                    return;
+                }
+                break;
+
+            case tok::KW_USING:
+            case tok::KW_DEF:
+            case tok::KW_TPE:
+            case tok::KW_CLASS:
+            case tok::KW_ABSTRACT:
+                if (point != SYNC_TOP_LEVEL) {
+                    return;
+                }
+                break;
+
+            case tok::KW_REDEF:
+            case tok::KW_EXTERN:
+            case tok::KW_STATIC:
+            case tok::KW_NEW:
+                if (point == SYNC_MEMBER) {
+                    return;
+                }
+                break;
+
+            default:
+                break;
+            }
+        }
+    }
+}
+
+bool Parser::isSynchronizingKeyword() {
+    if (!isType(tok::TOK_KW)) {
+        return false;
+    }
+
+    switch (_currentToken.getKwType()) {
+    case tok::KW_MODULE:
+    case tok::KW_USING:
+    case tok::KW_DEF:
+    case tok::KW_TPE:
+    case tok::KW_CLASS:
+    case tok::KW_ABSTRACT:
+    case tok::KW_REDEF:
+    case tok::KW_EXTERN:
+    case tok::KW_STATIC:
+        return true;
+    default:
+        return false;
+    }
+}
+
+bool Parser::isClosingDelimiter() {
+    if (!isType(tok::TOK_OPER)) {
+        return false;
+    }
+
+    switch (_currentToken.getOpType()) {
+    case tok::OPER_R_PAREN:
+    case tok::OPER_R_BRACKET:
+    case tok::OPER_R_BRACE:
+    case tok::OPER_SEMICOLON:
+    case tok::OPER_COMMA:
+        return true;
+    default:
+        return false;
+    }
+}
+
+ErrorExpression* Parser::makeError(const common::Positionnable& pos) {
+    ErrorExpression* err = _mngr.New<ErrorExpression>();
+    err->setPos(pos);
+    if (_lastTokenEndPos > pos.getEndPosition()) {
+        err->setEndPos(_lastTokenEndPos);
+    }
+    return err;
+}
+
+KindSpecifyingExpression* Parser::makeErrorKind(const common::Positionnable& pos) {
+    KindSpecifyingExpression* kind = _mngr.New<ProperTypeKindSpecifier>(nullptr, nullptr);
+    kind->setPos(pos);
+    kind->setEndPos(_lastTokenEndPos);
+    return kind;
 }
 
 template<typename T>
 bool Parser::expect(T type, const std::string& expected, bool fatal) {
-   tok::Token* lastTok = _currentToken;
-
    if (!accept(type)) {
        if (fatal) {
-           _ctx->reporter().fatal(*lastTok, "Expected " + expected + " but got `" + lastTok->toString() + "`");
+           _rep.fatal(posOf(_currentToken), "Expected " + expected + " but got `" + _currentToken.toString() + "`");
        } else {
-           _ctx->reporter().error(*lastTok, "Expected " + expected + " but got `" + lastTok->toString() + "`");
+           reportErrorAtCurrentToken("Expected " + expected + " but got `" + _currentToken.toString() + "`");
        }
        return false;
    }
@@ -95,26 +252,23 @@ bool Parser::expect(T type, const std::string& expected, bool fatal) {
 
 template<typename T>
 T Parser::expectSemicolonAndReturn(T expr) {
-    expect(tok::OPER_SEMICOLON, "`;`");
+    if (!expect(tok::OPER_SEMICOLON, "`;`")) {
+        synchronize(SYNC_STATEMENT);
+    }
     return expr;
 }
 
-template<typename T>
-T* Parser::as() {
-    return static_cast<T*>(_currentToken);
-}
-
 template<typename T>
 T* Parser::parseIdentifierHelper(const std::string& errMsg) {
-    std::string name;
+    common::Name name;
 
     SAVE_POS(startPos)
 
     if (isType(tok::TOK_ID)) {
-        name = as<tok::Identifier>()->toString();
+        name = _currentToken.name;
         accept();
     } else {
-        _ctx->reporter().error(*_currentToken, errMsg);
+        reportErrorAtCurrentToken(errMsg);
     }
 
     T* id = _mngr.New<T>(name);
@@ -143,13 +297,10 @@ Program* Parser::parseProgram() {
 
     SAVE_POS(startPos)
 
-    while (_lex.hasNext()) {
-        parseAnnotations();
-
-        expect(tok::KW_MODULE, "`module`", true);
-        modules.push_back(parseModule());
-
-        reportErroneousAnnotations();
+    while (!isType(tok::TOK_EOF)) {
+        if (ModuleDecl* module = parseTopLevelModule()) {
+            modules.push_back(module);
+        }
     }
 
     Program* prog = _mngr.New<Program>(modules);
@@ -158,6 +309,23 @@ Program* Parser::parseProgram() {
     return prog;
 }
 
+ModuleDecl* Parser::parseTopLevelModule() {
+    parseAnnotations();
+
+    if (!expect(tok::KW_MODULE, "`module`")) {
+        // resume at the next top level module, which the caller parses next
+        reportErroneousAnnotations();
+        synchronize(SYNC_TOP_LEVEL);
+        return nullptr;
+    }
+
+    ModuleDecl* module = parseModule();
+
+    reportErroneousAnnotations();
+
+    return module;
+}
+
 ModuleDecl* Parser::parseModule() {
     Identifier* moduleName = parseIdentifier("Expected module name");
     std::vector<ModuleDecl*> mods;
@@ -169,6 +337,9 @@ ModuleDecl* Parser::parseModule() {
     expect(tok::OPER_L_BRACE, "`{`");
 
     while (!accept(tok::OPER_R_BRACE) && !accept(tok::TOK_EOF)) {
+        size_t memberStart = _consumedTokens;
+        size_t errorCount = _rep.getErrorCount();
+
         parseAnnotations();
 
         SAVE_POS(keywordPos)
@@ -189,20 +360,26 @@ ModuleDecl* Parser::parseModule() {
             usings.push_back(parseUsing(keywordPos, false));
         } else {
             expect(tok::OPER_R_BRACE, "`}`");
-            break;
         }
 
         if (flags % DefFlags::EXTERN) {
-            _ctx->reporter().error(externElemPos, "Modules or type declarations cannot be declared extern");
+            _rep.error(externElemPos, "Modules or type declarations cannot be declared extern");
         }
         if (flags % DefFlags::ABSTRACT) {
-            _ctx->reporter().error(externElemPos, "Only classes can be declared abstract");
+            _rep.error(externElemPos, "Only classes can be declared abstract");
         }
         if (flags % DefFlags::STATIC) {
-            _ctx->reporter().error(externElemPos, "Static is not a valid flag in this context");
+            _rep.error(externElemPos, "Static is not a valid flag in this context");
         }
 
         reportErroneousAnnotations();
+
+        if (_rep.getErrorCount() != errorCount) {
+            if (_consumedTokens == memberStart) {
+                accept();
+            }
+            synchronize(SYNC_MEMBER);
+        }
     }
 
     ModuleDecl* modDecl = _mngr.New<ModuleDecl>(moduleName, mods, types, decls);
@@ -231,8 +408,8 @@ DefineDecl* Parser::parseDef(DefFlags flags, Identifier* name) {
         typeSpecifier = parseTypeExpression();
         expect(tok::OPER_EQ, "`=`");
         expr = parseExpression();
-    } else if (isType(tok::TOK_OPER) && (as<tok::Operator>()->getOpType() == tok::OPER_L_PAREN ||
-                                         as<tok::Operator>()->getOpType() == tok::OPER_L_BRACKET)) {
+    } else if (isType(tok::TOK_OPER) && (_currentToken.getOpType() == tok::OPER_L_PAREN ||
+                                         _currentToken.getOpType() == tok::OPER_L_BRACKET)) {
         expr = parseExpression();
     } else {
         expect(tok::OPER_EQ, "`=`");
@@ -250,8 +427,8 @@ ClassDecl* Parser::parseClass(bool isAbstract) {
     SAVE_POS(startPos)
 
     std::string className;
-    if (_currentToken->getTokenType() == tok::TOK_ID) {
-        className = as<tok::Identifier>()->toString();
+    if (_currentToken.type == tok::TOK_ID) {
+        className = _currentToken.toString();
         accept();
     } else {
         className = _currentTypeName.empty() ? AnonymousClassName : _currentTypeName;
@@ -286,7 +463,7 @@ Expression* Parser::parseStatement() {
     parseAnnotations();
 
     if (isType(tok::TOK_KW)) {
-        tok::KW_TYPE kw = as<tok::Keyword>()->getKwType();
+        tok::KW_TYPE kw = _currentToken.getKwType();
         accept();
 
         switch (kw) {
@@ -301,19 +478,19 @@ Expression* Parser::parseStatement() {
             if (accept(tok::KW_CLASS)) {
                 return expectSemicolonAndReturn(desugarTopLevelClassDecl(DefFlags::ABSTRACT));
             }
-            _ctx->reporter().error(startPos, "Expected `class` keyword after `abstract` flag");
-            return nullptr;
+            _rep.error(startPos, "Expected `class` keyword after `abstract` flag");
+            return makeError(startPos);
 
         case tok::KW_REDEF:
         case tok::KW_STATIC:
             reportErroneousAnnotations();
-            _ctx->reporter().error(startPos, "`" + tok::Keyword::KeywordTypeToString(kw) +
-                                   "` keyword can only be used inside a class scope");
-            return nullptr;
+            _rep.error(startPos, "`" + tok::KeywordTypeToString(kw) +
+                       "` keyword can only be used inside a class scope");
+            return makeError(startPos);
         default:
             reportErroneousAnnotations();
-            _ctx->reporter().error(startPos, "Unexpected keyword `" + tok::Keyword::KeywordTypeToString(kw) + "`");
-            return nullptr;
+            _rep.error(startPos, "Unexpected keyword `" + tok::KeywordTypeToString(kw) + "`");
+            return makeError(startPos);
         }
     } else if (accept(tok::OPER_L_BRACE)) {
         reportErroneousAnnotations();
@@ -333,14 +510,14 @@ Expression* Parser::parseExpression() {
 }
 
 Expression* Parser::parseUnary() {
-    tok::OPER_TYPE oper = as<tok::Operator>()->getOpType();
+    tok::OPER_TYPE oper = _currentToken.getOpType();
 
     if (oper == tok::OPER_MINUS || oper == tok::OPER_PLUS || oper == tok::OPER_BANG || oper == tok::OPER_TILDE) {
         SAVE_POS(pos)
-        std::string operName = as<tok::Operator>()->toString();
+        std::string operName = _currentToken.toString();
         accept();
 
-        Expression* callee = parseBinary(parsePrimary(), tok::Operator::getUnaryOperatorPrecedence());
+        Expression* callee = parseBinary(parsePrimary(), tok::UNARY_OPERATOR_PRECEDENCE);
         Expression* toRet = makeMethodCall(callee, operName, {}, *callee, *callee);
 
         toRet->setPos(pos);
@@ -354,8 +531,8 @@ Expression* Parser::parseUnary() {
 
 Expression* Parser::parseBinary(Expression* left, int precedence) {
     while (isType(tok::TOK_OPER)) {
-        tok::Operator* oper = as<tok::Operator>();
-        int newOpPrec = oper->getPrecedence();
+        tok::Token oper = _currentToken;
+        int newOpPrec = oper.getPrecedence();
 
         if (newOpPrec >= precedence) {
             if (Expression* expr = parseSpecialBinaryContinuity(left)) {
@@ -367,8 +544,8 @@ Expression* Parser::parseBinary(Expression* left, int precedence) {
                 Expression* right = parsePrimary();
 
                 while (isType(tok::TOK_OPER)) {
-                    int curOpPrec = as<tok::Operator>()->getPrecedence();
-                    if (curOpPrec > newOpPrec || (curOpPrec == newOpPrec && as<tok::Operator>()->isRightAssociative())) {
+                    int curOpPrec = _currentToken.getPrecedence();
+                    if (curOpPrec > newOpPrec || (curOpPrec == newOpPrec && _currentToken.isRightAssociative())) {
                         right = parseBinary(right, curOpPrec);
                     } else {
                         break;
@@ -394,28 +571,28 @@ Expression* Parser::parsePrimary() {
 
     parseAnnotations();
 
-    switch (_currentToken->getTokenType()) {
+    switch (_currentToken.type) {
     case tok::TOK_BOOL_LIT:
-        toRet = _mngr.New<BoolLiteral>(as<tok::BoolLiteral>()->getValue());
-        toRet->setPos(*_currentToken);
+        toRet = _mngr.New<BoolLiteral>(_currentToken.kind != 0);
+        toRet->setPos(posOf(_currentToken));
         accept();
         break;
 
     case tok::TOK_INT_LIT:
-        toRet = _mngr.New<IntLiteral>(as<tok::IntLiteral>()->getValue());
-        toRet->setPos(*_currentToken);
+        toRet = _mngr.New<IntLiteral>(_currentToken.intValue);
+        toRet->setPos(posOf(_currentToken));
         accept();
         break;
 
     case tok::TOK_REAL_LIT:
-        toRet = _mngr.New<RealLiteral>(as<tok::RealLiteral>()->getValue());
-        toRet->setPos(*_currentToken);
+        toRet = _mngr.New<RealLiteral>(_currentToken.realValue);
+        toRet->setPos(posOf(_currentToken));
         accept();
         break;
 
     case tok::TOK_STR_LIT:
-        toRet = _mngr.New<StringLiteral>(as<tok::StringLiteral>()->getValue());
-        toRet->setPos(*_currentToken);
+        toRet = _mngr.New<StringLiteral>(_currentToken.name.str());
+        toRet->setPos(posOf(_currentToken));
         accept();
         break;
 
@@ -476,7 +653,10 @@ Expression* Parser::parsePrimary() {
         }
         else if (!(toRet = parseUnary())) {
             reportUnexpectedCurrentToken();
-            accept();
+            if (!isClosingDelimiter()) {
+                accept();
+            } // otherwise it is left to the enclosing construct, which can resume from there
+            toRet = makeError(startPos);
         }
         break;
 
@@ -488,16 +668,19 @@ Expression* Parser::parsePrimary() {
         } else if (accept(tok::KW_NEW)) {
             toRet = parseNew(startPos);
         } else {
-            _ctx->reporter().error(*_currentToken, "Unexpected keyword `" + _currentToken->toString() + "`");
-            accept();
+            reportErrorAtCurrentToken("Unexpected keyword `" + _currentToken.toString() + "`");
+            if (!isSynchronizingKeyword()) {
+                accept();
+            } // otherwise the enclosing construct resumes from the definition it starts
+            toRet = makeError(startPos);
         }
         break;
 
     default:
-        _ctx->reporter().error(*_currentToken,
-                               "Expected int Literal | real Literal | string Literal "
-                               "| identifier | keyword; got " + _currentToken->toString());
+        reportErrorAtCurrentToken("Expected int Literal | real Literal | string Literal "
+                                  "| identifier | keyword; got " + _currentToken.toString());
         accept();
+        toRet = makeError(startPos);
     }
 
     if (shouldReportAnnotations) {
@@ -510,9 +693,9 @@ Expression* Parser::parsePrimary() {
 TypeSpecifier* Parser::parseTypeSpecifier(Identifier* id) {
     TypeExpression* expr;
 
-    if (_currentToken->getTokenType() == tok::TOK_OPER && as<tok::Operator>()->getOpType() == tok::OPER_EQ) {
+    if (_currentToken.type == tok::TOK_OPER && _currentToken.getOpType() == tok::OPER_EQ) {
         expr = _mngr.New<TypeToBeInferred>();
-        expr->setPos(*_currentToken);
+        expr->setPos(posOf(_currentToken));
     } else {
         expr = parseTypeExpression();
     }
@@ -585,7 +768,7 @@ Expression* Parser::parseSpecialBinaryContinuity(Expression* left) {
         if (accept(tok::OPER_L_PAREN)) {
             res = _mngr.New<FunctionCall>(left, typeArgs, parseTuple());
         } else if (TypeExpression* typeLeft = ast::ASTExpr2TypeExpr::convert(left, _ctx)) {
-            res = parseTypeBinary(_mngr.New<TypeConstructorCall>(typeLeft, typeArgs), tok::Operator(tok::OPER_L_BRACKET).getPrecedence(), true);
+            res = parseTypeBinary(_mngr.New<TypeConstructorCall>(typeLeft, typeArgs), tok::OPERATOR_TABLE[tok::OPER_L_BRACKET].precedence, true);
         } else {
             reportUnexpectedCurrentToken();
         }
@@ -636,14 +819,14 @@ TypeExpression* Parser::parseTypeBinary(TypeExpression* left, int precedence, bo
     }
 
     while (isType(tok::TOK_OPER)) {
-        tok::Operator* op = as<tok::Operator>();
-        int newOpPrec = op->getPrecedence();
+        tok::Token op = _currentToken;
+        int newOpPrec = op.getPrecedence();
 
-        if (newOpPrec >= precedence && op->getOpType() != tok::OPER_EQ && op->getOpType() != tok::OPER_LT) {
+        if (newOpPrec >= precedence && op.getOpType() != tok::OPER_EQ && op.getOpType() != tok::OPER_LT) {
 
             TypeExpression* expr;
 
-            switch (op->getOpType()) {
+            switch (op.getOpType()) {
             case tok::OPER_L_BRACKET:
                 accept();
                 expr = _mngr.New<TypeConstructorCall>(left, parseTypeTuple());
@@ -664,7 +847,7 @@ TypeExpression* Parser::parseTypeBinary(TypeExpression* left, int precedence, bo
                 break;
             default:
                 accept();
-                _ctx->reporter().error(*op, "Unexpected operator `" + op->toString() + "`");
+                _rep.error(posOf(op), "Unexpected operator `" + op.toString() + "`");
                 continue;
             }
 
@@ -724,7 +907,7 @@ TypeTuple* Parser::parseTypeParameters() {
                 TypeExpression* ub = accept(tok::OPER_LT) ? parseTypeExpression(false) : nullptr;
 
                 kindExpr = _mngr.New<ProperTypeKindSpecifier>(lb, ub);
-                kindExpr->setPos(*_currentToken);
+                kindExpr->setPos(posOf(_currentToken));
             }
 
             TypeParameter* typeParam = _mngr.New<TypeParameter>(vt, ident, kindExpr);
@@ -735,7 +918,7 @@ TypeTuple* Parser::parseTypeParameters() {
 
         } while (accept(tok::OPER_COMMA) && !accept(tok::TOK_EOF));
 
-        expect(tok::OPER_R_BRACKET, "`" + tok::Operator::OperTypeToString(tok::OPER_R_BRACKET) + "`");
+        expect(tok::OPER_R_BRACKET, "`" + tok::OperTypeToString(tok::OPER_R_BRACKET) + "`");
     }
 
     TypeTuple* typeParamsTuple = _mngr.New<TypeTuple>(typeParameters);
@@ -751,7 +934,7 @@ TypeExpression* Parser::parseTypePrimary(bool allowTypeConstructor) {
 
     parseAnnotations();
 
-    switch (_currentToken->getTokenType()) {
+    switch (_currentToken.type) {
     case tok::TOK_ID:
         exprs.push_back(parseTypeIdentifier());
         break;
@@ -775,7 +958,7 @@ TypeExpression* Parser::parseTypePrimary(bool allowTypeConstructor) {
             exprs.push_back(createFunctionTypeDecl(nullptr, {}, parseTypeExpression(allowTypeConstructor)));
         } else {
             reportUnexpectedCurrentToken();
-            return nullptr;
+            return makeError(startPos);
         }
         break;
 
@@ -785,16 +968,17 @@ TypeExpression* Parser::parseTypePrimary(bool allowTypeConstructor) {
         if (accept(tok::KW_CLASS)) {
             return parseClass(isAbstract);
         } else {
-            _ctx->reporter().error(*_currentToken, "Unexpected keyword `" + _currentToken->toString() + "`");
-            accept();
+            reportErrorAtCurrentToken("Unexpected keyword `" + _currentToken.toString() + "`");
+            if (!isSynchronizingKeyword()) {
+                accept();
+            }
+            return makeError(startPos);
         }
-        break;
     }
 
     default:
-        _ctx->reporter().error(*_currentToken,
-                               "Expected identifier | type tuple | class "
-                               "; got " + _currentToken->toString());
+        reportErrorAtCurrentToken("Expected identifier | type tuple | class "
+                                  "; got " + _currentToken.toString());
         accept();
     }
 
@@ -813,11 +997,13 @@ TypeExpression* Parser::parseTypePrimary(bool allowTypeConstructor) {
         toRet = createFunctionTypeDecl(nullptr, exprs, parseTypeExpression(allowTypeConstructor));
     }
 
-    if (toRet) {
-        toRet->setPos(startPos);
-        toRet->setEndPos(_lastTokenEndPos);
+    if (!toRet) {
+        return makeError(startPos);
     }
 
+    toRet->setPos(startPos);
+    toRet->setEndPos(_lastTokenEndPos);
+
     return toRet;
 }
 
@@ -832,8 +1018,8 @@ KindSpecifyingExpression* Parser::parseKindSpecifyingExpression() {
     TypeExpression* upperBound = nullptr;
 
     if (!isType(tok::TOK_OPER) ||
-            (as<tok::Operator>()->getOpType() != tok::OPER_TIMES &&
-             as<tok::Operator>()->getOpType() != tok::OPER_L_BRACKET)) {
+            (_currentToken.getOpType() != tok::OPER_TIMES &&
+             _currentToken.getOpType() != tok::OPER_L_BRACKET)) {
         lowerBound = parseTypeExpression(false);
         expect(tok::OPER_LT, "`<`");
     }
@@ -852,15 +1038,15 @@ KindSpecifyingExpression* Parser::parseKindSpecifyingExpression() {
         arrowNecessary = true;
     }
     else {
-        _ctx->reporter().error(*_currentToken, "Expected proper type or type constructor kind specifier; got `"+ _currentToken->toString() +"`");
+        reportErrorAtCurrentToken("Expected proper type or type constructor kind specifier; got `"+ _currentToken.toString() +"`");
         accept();
-        return toRet;
+        return makeErrorKind(startPos);
     }
 
     if ((arrowNecessary && expect(tok::OPER_THIN_ARROW, "`->`")) || accept(tok::OPER_THIN_ARROW)) {
         toRet = _mngr.New<TypeConstructorKindSpecifier>(exprs, parseKindSpecifyingExpression());
     } else if (arrowNecessary) {
-        return toRet;
+        return makeErrorKind(startPos);
     }
 
     toRet->setPos(startPos);
@@ -895,30 +1081,29 @@ void Parser::parseAnnotations() {
     std::vector<Annotation::ArgumentValue> args;
 
     if (isType(tok::TOK_ID)) {
-        name = as<tok::Identifier>()->toString();
+        name = _currentToken.toString();
         accept();
     } else if (isType(tok::TOK_KW)) {
-        name = as<tok::Keyword>()->toString();
+        name = _currentToken.toString();
         accept();
     } else {
-        _ctx->reporter().error(*_currentToken, "Expected identifier; got " + _currentToken->toString());
+        reportErrorAtCurrentToken("Expected identifier; got " + _currentToken.toString());
         return;
     }
 
-    if (_currentToken->getStartPosition() == _lastTokenEndPos && accept(tok::OPER_L_PAREN)) {
+    if (_currentToken.startPos == _lastTokenEndPos && accept(tok::OPER_L_PAREN)) {
         while (true) {
             if (isType(tok::TOK_BOOL_LIT)) {
-                args.push_back(Annotation::ArgumentValue(as<tok::BoolLiteral>()->getValue()));
+                args.push_back(Annotation::ArgumentValue(_currentToken.kind != 0));
             } else if (isType(tok::TOK_INT_LIT)) {
-                args.push_back(Annotation::ArgumentValue(as<tok::IntLiteral>()->getValue()));
+                args.push_back(Annotation::ArgumentValue(_currentToken.intValue));
             } else if (isType(tok::TOK_REAL_LIT)) {
-                args.push_back(Annotation::ArgumentValue(as<tok::RealLiteral>()->getValue()));
+                args.push_back(Annotation::ArgumentValue(_currentToken.realValue));
             } else if (isType(tok::TOK_STR_LIT)) {
-                args.push_back(Annotation::ArgumentValue(as<tok::StringLiteral>()->getValue()));
+                args.push_back(Annotation::ArgumentValue(_currentToken.name.str()));
             } else {
-                _ctx->reporter().error(*_currentToken,
-                                       "Expected bool | int | real | string Literal"
-                                       "; got " + _currentToken->toString());
+                reportErrorAtCurrentToken("Expected bool | int | real | string Literal"
+                                          "; got " + _currentToken.toString());
                 break;
             }
 
@@ -929,8 +1114,7 @@ void Parser::parseAnnotations() {
             } else if (accept(tok::OPER_R_PAREN)) {
                 break;
             } else {
-                _ctx->reporter().error(*_currentToken,
-                                       "Expected `,` or `)`; got " + _currentToken->toString());
+                reportErrorAtCurrentToken("Expected `,` or `)`; got " + _currentToken.toString());
                 break;
             }
         }
@@ -966,7 +1150,7 @@ common::Positionnable Parser::annotationsPos() const {
 
 void Parser::reportErroneousAnnotations() {
     if (!annotationsConsumed()) {
-        _ctx->reporter().error(annotationsPos(), "Illegal annotation placement");
+        _rep.error(annotationsPos(), "Illegal annotation placement");
     }
     _parsedAnnotations.clear();
 }
@@ -976,11 +1160,10 @@ CanUseModules::ModulePath Parser::parseUsing(const common::Positionnable& usingp
 
     do {
         if (isType(tok::TOK_ID)) {
-            tok::Identifier* id = as<tok::Identifier>();
-            mpath.push_back(id->toString());
+            mpath.push_back(_currentToken.toString());
             accept();
         } else {
-            _ctx->reporter().error(*_currentToken, "Expected identifier in module path, but got `" + _currentToken->toString()+ "`");
+            reportErrorAtCurrentToken("Expected identifier in module path, but got `" + _currentToken.toString()+ "`");
             break;
         }
     } while (accept(tok::OPER_DOT));
@@ -1001,7 +1184,7 @@ DefFlags Parser::parseDefFlags() {
     while (isType(tok::TOK_KW)){
         DefFlags flag;
 
-        switch (as<tok::Keyword>()->getKwType()) {
+        switch (_currentToken.getKwType()) {
         case tok::KW_EXTERN:    flag = DefFlags::EXTERN; break;
         case tok::KW_ABSTRACT:  flag = DefFlags::ABSTRACT; break;
         case tok::KW_STATIC:    flag = DefFlags::STATIC; break;
@@ -1027,7 +1210,7 @@ RETURN_TYPE* Parser::parseTuple(std::vector<ELEMENT_TYPE>& exprs, const PARSING_
             }
         } while (accept(tok::OPER_COMMA) && !accept(tok::TOK_EOF));
 
-        expect(R_DELIM, "`" + tok::Operator::OperTypeToString(R_DELIM) + "`");
+        expect(R_DELIM, "`" + tok::OperTypeToString(R_DELIM) + "`");
     }
 
     RETURN_TYPE* tuple = _mngr.New<RETURN_TYPE>(exprs);
@@ -1046,7 +1229,7 @@ DefineDecl* Parser::makeFunctionDef(const std::string& name, const std::vector<E
                               const common::Positionnable& pos, DefFlags flags) {
 
     FunctionCreation* func = _mngr.New<FunctionCreation>(name, nullptr, _mngr.New<Tuple>(params), _mngr.New<Block>(body), nullptr);
-    Identifier* defName = _mngr.New<Identifier>(name);
+    Identifier* defName = _mngr.New<Identifier>(_ctx->names().intern(name));
     DefineDecl* defDecl = _mngr.New<DefineDecl>(defName, nullptr, func, flags);
 
     func->setPos(pos);
@@ -1058,7 +1241,7 @@ DefineDecl* Parser::makeFunctionDef(const std::string& name, const std::vector<E
 
 Expression* Parser::makeMethodCall(Expression* callee, const std::string& memberName, const std::vector<Expression*>& argExprs,
                                   const common::Positionnable& memberPos, const common::Positionnable& argsPos, TypeTuple* typeArgs) {
-    Identifier* id = _mngr.New<Identifier>(memberName);
+    Identifier* id = _mngr.New<Identifier>(_ctx->names().intern(memberName));
     Tuple* args = _mngr.New<Tuple>(argExprs);
     id->setPos(memberPos);
     args->setPos(argsPos);
@@ -1070,10 +1253,10 @@ Expression* Parser::makeMethodCall(Expression* callee, const std::string& member
     return _mngr.New<FunctionCall>(mac, typeArgs, args);
 }
 
-Expression* Parser::makeBinary(Expression* left, Expression* right, tok::Operator* oper) {
+Expression* Parser::makeBinary(Expression* left, Expression* right, const tok::Token& oper) {
     Expression* res;
 
-    switch (oper->getOpType()) {
+    switch (oper.getOpType()) {
     case tok::OPER_EQ:
     case tok::OPER_PLUS_EQ:
     case tok::OPER_MINUS_EQ:
@@ -1090,12 +1273,12 @@ Expression* Parser::makeBinary(Expression* left, Expression* right, tok::Operato
             std::vector<Expression*> newArgsExprs(call->getArgs());
             newArgsExprs.push_back(right);
 
-            res = makeMethodCall(call->getCallee(), std::string("(") + oper->toString() + ")",
-                                 newArgsExprs, *oper, *call->getArgsTuple(), call->getTypeArgsTuple());
+            res = makeMethodCall(call->getCallee(), std::string("(") + oper.toString() + ")",
+                                 newArgsExprs, posOf(oper), *call->getArgsTuple(), call->getTypeArgsTuple());
         } else {
             std::string baseOper = "";
 
-            switch (oper->getOpType()) {
+            switch (oper.getOpType()) {
             case tok::OPER_PLUS_EQ:     baseOper = "+"; break;
             case tok::OPER_MINUS_EQ:    baseOper = "-"; break;
             case tok::OPER_TIMES_EQ:    baseOper = "*"; break;
@@ -1113,7 +1296,7 @@ Expression* Parser::makeBinary(Expression* left, Expression* right, tok::Operato
                 common::Positionnable pos = *left;
                 pos.setEndPos(right->getEndPosition());
 
-                right = makeMethodCall(left, baseOper, {right}, *oper, pos);
+                right = makeMethodCall(left, baseOper, {right}, posOf(oper), pos);
                 right->setPos(pos);
             }
 
@@ -1133,7 +1316,7 @@ Expression* Parser::makeBinary(Expression* left, Expression* right, tok::Operato
         break;
     }
     default:
-        res = makeMethodCall(left, oper->toString(), {right}, *oper, *right);
+        res = makeMethodCall(left, oper.toString(), {right}, posOf(oper), *right);
         break;
     }
 
@@ -1146,15 +1329,15 @@ Identifier* Parser::parseOperatorsAsIdentifer() {
     std::string name;
     SAVE_POS(startPos)
 
-    tok::OPER_TYPE op = as<tok::Operator>()->getOpType();
+    tok::OPER_TYPE op = _currentToken.getOpType();
 
     if (accept(tok::OPER_L_PAREN)) {
         name = "(";
         if (isType(tok::TOK_OPER)) {
-            tok::OPER_TYPE inOp = as<tok::Operator>()->getOpType();
+            tok::OPER_TYPE inOp = _currentToken.getOpType();
 
             if (inOp >= tok::OPER_EQ && inOp <= tok::OPER_R_SHIFT_EQ) {
-                name += as<tok::Operator>()->toString();
+                name += _currentToken.toString();
                 accept();
             } else if (inOp != tok::OPER_R_PAREN) {
                 reportUnexpectedCurrentToken();
@@ -1173,16 +1356,15 @@ Identifier* Parser::parseOperatorsAsIdentifer() {
                op == tok::OPER_EQ_EQ   || op == tok::OPER_LT      ||
                op == tok::OPER_GT      || op == tok::OPER_LE      ||
                op == tok::OPER_GE) {
-        name = as<tok::Operator>()->toString();
+        name = _currentToken.toString();
         accept();
     } else {
-        _ctx->reporter().error(*_currentToken,
-                               "Expected operator "
-                               "; got " + _currentToken->toString());
+        reportErrorAtCurrentToken("Expected operator "
+                                  "; got " + _currentToken.toString());
         accept();
     }
 
-    Identifier* id = _mngr.New<Identifier>(name);
+    Identifier* id = _mngr.New<Identifier>(_ctx->names().intern(name));
     id->setPos(startPos);
     id->setEndPos(_lastTokenEndPos);
     return id;
@@ -1201,10 +1383,10 @@ ClassDecl* Parser::parseClassBody(bool isAbstract, const std::string& className,
     if (forAnonymousInstantiation) {
         defs.push_back(makeFunctionDef("new", {}, {}, startPos, DefFlags::CONSTRUCTOR));
 
-        if (!isType(tok::TOK_OPER) || as<tok::Operator>()->getOpType() != tok::OPER_L_BRACE) {
+        if (!isType(tok::TOK_OPER) || _currentToken.getOpType() != tok::OPER_L_BRACE) {
             parent = parseTypeExpression();
         }
-        if (!isType(tok::TOK_OPER) || as<tok::Operator>()->getOpType() != tok::OPER_L_BRACE) {
+        if (!isType(tok::TOK_OPER) || _currentToken.getOpType() != tok::OPER_L_BRACE) {
             expect(tok::OPER_L_BRACE, "`{`");
         }
     } else {
@@ -1221,6 +1403,9 @@ ClassDecl* Parser::parseClassBody(bool isAbstract, const std::string& className,
 
     if (accept(tok::OPER_L_BRACE)) {
         while (!accept(tok::OPER_R_BRACE) && !accept(tok::TOK_EOF)) {
+            size_t memberStart = _consumedTokens;
+            size_t errorCount = _rep.getErrorCount();
+
             parseAnnotations();
 
             DefFlags flags = parseDefFlags();
@@ -1228,10 +1413,10 @@ ClassDecl* Parser::parseClassBody(bool isAbstract, const std::string& className,
             SAVE_POS(externElemPos);
 
             if (flags % DefFlags::EXTERN && flags % DefFlags::ABSTRACT) {
-                _ctx->reporter().error(externElemPos, "`extern` and `abstract` flags are exclusive");
+                _rep.error(externElemPos, "`extern` and `abstract` flags are exclusive");
             }
             if (flags % DefFlags::STATIC && flags % DefFlags::ABSTRACT) {
-                _ctx->reporter().error(externElemPos, "`static` and `abstract` flags are exclusive");
+                _rep.error(externElemPos, "`static` and `abstract` flags are exclusive");
             }
 
             if (accept(tok::KW_TPE)) {
@@ -1239,7 +1424,7 @@ ClassDecl* Parser::parseClassBody(bool isAbstract, const std::string& className,
             } else if (accept(tok::KW_CLASS)) {
                 tdecls.push_back(desugarTopLevelClassDecl(consumeDefFlags(flags, DefFlags::EXTERN | DefFlags::ABSTRACT)));
             } else if (accept(tok::KW_NEW)) {
-                Identifier* id = _mngr.New<Identifier>("new");
+                Identifier* id = _mngr.New<Identifier>(_ctx->names().intern("new"));
                 id->setPos(externElemPos);
                 defs.push_back(parseDef(DefFlags::CONSTRUCTOR | consumeDefFlags(flags, DefFlags::EXTERN), id));
             } else if (accept(tok::KW_DEF)) {
@@ -1248,8 +1433,10 @@ ClassDecl* Parser::parseClassBody(bool isAbstract, const std::string& className,
             } else if (accept(tok::KW_REDEF)) {
                 Identifier* id = isType(tok::TOK_OPER) ? parseOperatorsAsIdentifer() : nullptr;
                 defs.push_back(parseDef(DefFlags::REDEF | consumeDefFlags(flags, DefFlags::EXTERN | DefFlags::ABSTRACT), id));
+            } else if (!isType(tok::TOK_ID)) {
+                reportErrorAtCurrentToken("Expected field name | def");
             } else {
-                Identifier* fieldName = parseIdentifier("Expected field name | def");
+                Identifier* fieldName = parseIdentifier();
                 expect(tok::OPER_COLON, "`:`");
                 TypeExpression* type = parseTypeExpression();
 
@@ -1270,16 +1457,23 @@ ClassDecl* Parser::parseClassBody(bool isAbstract, const std::string& className,
             }
 
             if (flags % DefFlags::EXTERN) {
-                _ctx->reporter().error(externElemPos, "Class fields or inner type declarations cannot be declared extern");
+                _rep.error(externElemPos, "Class fields or inner type declarations cannot be declared extern");
             }
             if (flags % DefFlags::ABSTRACT) {
-                _ctx->reporter().error(externElemPos, "Class fields or inner type declarations cannot be declared abstract");
+                _rep.error(externElemPos, "Class fields or inner type declarations cannot be declared abstract");
             }
             if (flags % DefFlags::STATIC) {
-                _ctx->reporter().error(externElemPos, "Class fields, inner type declarations or abstract members cannot be declared static");
+                _rep.error(externElemPos, "Class fields, inner type declarations or abstract members cannot be declared static");
             }
 
             reportErroneousAnnotations();
+
+            if (_rep.getErrorCount() != errorCount) {
+                if (_consumedTokens == memberStart) {
+                    accept();
+                }
+                synchronize(SYNC_MEMBER);
+            }
         }
     }
 
@@ -1288,7 +1482,7 @@ ClassDecl* Parser::parseClassBody(bool isAbstract, const std::string& className,
     for (DefineDecl* def : defs) {
         if (def->getValue() && !def->isStatic()) {
             if (!isNodeOfType<FunctionCreation>(def->getValue(), _ctx)) {
-                _ctx->reporter().error(*def, "A method definition must be a function expression");
+                _rep.error(*def, "A method definition must be a function expression");
             } else if (def->isConstructor() && staticExprs.size() > 0) {
                 FunctionCreation* constr = static_cast<FunctionCreation*>(def->getValue());
                 Annotable savedAnnot = *constr;
@@ -1335,7 +1529,7 @@ DefineDecl* Parser::desugarTrivialConstructor(std::vector<TypeSpecifier*>& field
 
             // CREATE PARAM
 
-            Identifier* paramName = _mngr.New<Identifier>(fieldName->getValue() + "$arg");
+            Identifier* paramName = _mngr.New<Identifier>(_ctx->names().intern(fieldName->getValue() + "$arg"));
             paramName->setPos(*fieldName);
 
             TypeSpecifier* param = _mngr.New<TypeSpecifier>(paramName, tp);
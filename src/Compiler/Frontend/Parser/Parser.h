@@ -43,11 +43,27 @@ public:
      */
     Parser(CompCtx_Ptr& ctx, lex::Lexer& lexer, const common::AbstractPrimitiveNamer* namer);
 
+    /**
+     * @brief Creates a Parser object which reports its errors to another reporter than the one
+     * of the compilation context, e.g. to parse a source in a thread of its own
+     * @param ctx The compilation context used throughout the parsing to allocate memory
+     * @param rep The reporter to which syntax errors are reported
+     * @param lexer The lexer from which to fetch the tokens during the parsing
+     */
+    Parser(CompCtx_Ptr& ctx, common::AbstractReporter& rep, lex::Lexer& lexer, const common::AbstractPrimitiveNamer* namer);
+
     /**
      * @brief Start the parsing process
      */
     ast::Program* parse();
 
+    /**
+     * @brief Parses the input one top level module at a time, instead of building the whole program
+     * @param onModule Called with each top level module as soon as it is parsed, before
+     * the rest of the input is read
+     */
+    void parseModules(const std::function<void(ast::ModuleDecl*)>& onModule);
+
     /**
      * @brief Parses a single expression
      */
@@ -81,11 +97,50 @@ private:
     template<typename T>
     T expectSemicolonAndReturn(T expr);
 
-    template<typename T>
-    T* as();
+    common::Positionnable posOf(const tok::Token& token) const;
+
+    /**
+     * @brief Reports an error at the current token, unless one was already reported there:
+     * the enclosing constructs that fail on the same token would only repeat the first error
+     */
+    void reportErrorAtCurrentToken(const std::string& msg);
 
     void reportUnexpectedCurrentToken();
 
+    // Error recovery
+
+    /**
+     * @brief The boundaries at which the parsing can resume after a syntax error
+     */
+    enum SYNC_POINT {
+        SYNC_TOP_LEVEL,     ///< the start of a top level module
+        SYNC_MEMBER,        ///< the start of a module or class member, or the end of its enclosing body
+        SYNC_STATEMENT      ///< right after the end of a statement, or the end of its enclosing block
+    };
+
+    /**
+     * @brief Skips tokens until the given synchronization point is reached,
+     * ignoring anything that appears inside parentheses, brackets or braces
+     * opened along the way. Stops at the end of the input in any case.
+     */
+    void synchronize(SYNC_POINT point);
+
+    /**
+     * @return True if the current token is a keyword at which #synchronize can stop,
+     * which must then be left for the enclosing construct to resume from
+     */
+    bool isSynchronizingKeyword();
+
+    bool isClosingDelimiter();
+
+    ast::ErrorExpression* makeError(const common::Positionnable& pos);
+
+    /**
+     * @brief Creates the kind that stands for a kind specifying expression which could
+     * not be parsed, which is the kind given to type parameters whose kind is not specified
+     */
+    ast::KindSpecifyingExpression* makeErrorKind(const common::Positionnable& pos);
+
     // Parsing
 
     template<typename T>
@@ -95,6 +150,7 @@ private:
     ast::TypeIdentifier* parseTypeIdentifier(const std::string& errMsg = "");
 
     ast::Program* parseProgram();
+    ast::ModuleDecl* parseTopLevelModule();
     ast::ModuleDecl* parseModule();
     ast::DefineDecl* parseDef(DefFlags flags, ast::Identifier* name = nullptr);
     ast::ClassDecl* parseClass(bool isAbstract);
@@ -158,7 +214,7 @@ private:
     ast::Expression* makeMethodCall(Expression* callee, const std::string& memberName, const std::vector<Expression*>& argExprs,
                                     const common::Positionnable& memberPos, const common::Positionnable& argsPos, TypeTuple* typeArgs = nullptr);
 
-    ast::Expression* makeBinary(Expression* left, Expression* right, tok::Operator* oper);
+    ast::Expression* makeBinary(Expression* left, Expression* right, const tok::Token& oper);
     ast::Identifier* parseOperatorsAsIdentifer();
 
     ast::ClassDecl* parseClassBody(bool isAbstract, const std::string& className,
@@ -174,11 +230,14 @@ private:
 
     CompCtx_Ptr _ctx;
     common::AbstractMemoryManager& _mngr;
+    common::AbstractReporter& _rep;
     lex::Lexer& _lex;
     const common::AbstractPrimitiveNamer* _namer;
 
     size_t _lastTokenEndPos;
-    tok::Token* _currentToken;
+    size_t _consumedTokens;
+    size_t _lastErrorToken; // one more than the number of tokens consumed when the last error was reported
+    tok::Token _currentToken;
 
     std::string _currentTypeName;
     std::string _currentDefName;
@@ -0,0 +1,102 @@
+//
+//  ResolutionCache.cpp
+//  SFSL
+//
+//  Created by Romain Beguet on 25.10.16.
+//  Copyright (c) 2016 Romain Beguet. All rights reserved.
+//
+
+#include "ResolutionCache.h"
+
+#define RESOLUTION_CACHE_ENTRY_NAME "ResolutionCache@sfsl::sym::ResolutionCache"
+#define RESOLUTION_CACHE_INITIAL_SLOTS 64
+
+namespace sfsl {
+
+namespace sym {
+
+ResolutionCache::Slot::Slot() : scope(nullptr), traversedDefScope(false), epoch(0) {
+
+}
+
+ResolutionCache::ResolutionCache() : _size(0) {
+
+}
+
+ResolutionCache::~ResolutionCache() {
+
+}
+
+const std::vector<ResolutionCache::Resolution>* ResolutionCache::find(const Scope* scope, common::Name name, bool traversedDefScope, size_t epoch) {
+    ++_stats.lookups;
+
+    if (_size == 0) {
+        return nullptr;
+    }
+
+    const Slot& slot = _slots[indexOf(scope, name, traversedDefScope)];
+
+    if (slot.scope && slot.epoch == epoch) {
+        ++_stats.hits;
+        return &slot.resolutions;
+    }
+
+    return nullptr;
+}
+
+void ResolutionCache::store(const Scope* scope, common::Name name, bool traversedDefScope, size_t epoch,
+                            std::vector<Resolution>&& resolutions) {
+    // keep the load factor under 1/2
+    if ((_size + 1) * 2 > _slots.size()) {
+        grow();
+    }
+
+    Slot& slot = _slots[indexOf(scope, name, traversedDefScope)];
+
+    if (!slot.scope) {
+        slot.scope = scope;
+        slot.name = name;
+        slot.traversedDefScope = traversedDefScope;
+        ++_size;
+    }
+
+    // a lookup from an older epoch is simply overwritten
+    slot.epoch = epoch;
+    slot.resolutions = std::move(resolutions);
+}
+
+const common::ResolutionStats& ResolutionCache::getStats() const {
+    return _stats;
+}
+
+ResolutionCache* ResolutionCache::get(const CompCtx_Ptr& ctx) {
+    return ctx->retrieveContextUserData<ResolutionCache>(RESOLUTION_CACHE_ENTRY_NAME);
+}
+
+size_t ResolutionCache::indexOf(const Scope* scope, common::Name name, bool traversedDefScope) const {
+    size_t mask = _slots.size() - 1;
+    size_t hash = name.hash() ^ ((size_t)scope >> 4) * 0x9E3779B9u ^ (size_t)traversedDefScope;
+    size_t i = hash & mask;
+
+    while (_slots[i].scope &&
+           (_slots[i].scope != scope || _slots[i].name != name || _slots[i].traversedDefScope != traversedDefScope)) {
+        i = (i + 1) & mask;
+    }
+
+    return i;
+}
+
+void ResolutionCache::grow() {
+    std::vector<Slot> slots(_slots.empty() ? RESOLUTION_CACHE_INITIAL_SLOTS : _slots.size() * 2);
+    slots.swap(_slots);
+
+    for (Slot& slot : slots) {
+        if (slot.scope) {
+            _slots[indexOf(slot.scope, slot.name, slot.traversedDefScope)] = std::move(slot);
+        }
+    }
+}
+
+}
+
+}
@@ -0,0 +1,103 @@
+//
+//  ResolutionCache.h
+//  SFSL
+//
+//  Created by Romain Beguet on 25.10.16.
+//  Copyright (c) 2016 Romain Beguet. All rights reserved.
+//
+
+#ifndef __SFSL__ResolutionCache__
+#define __SFSL__ResolutionCache__
+
+#include <vector>
+#include "../../Common/CompilationContext.h"
+#include "../../Common/MemoryManageable.h"
+#include "../../Common/ResolutionStats.h"
+#include "Symbols.h"
+
+namespace sfsl {
+
+namespace sym {
+
+class Scope;
+
+/**
+ * @brief Remembers the symbols to which a name resolved when it was looked up from a
+ * given scope, for the whole compilation. Scopes can still gain symbols and usings after
+ * names were resolved through them (e.g. when the inherited members of a class are copied
+ * into its scope), so each lookup is tagged with the epoch of its scope at the time it was
+ * stored: the scopes whose lookups may have changed move to a new epoch, which makes their
+ * old lookups unreachable.
+ */
+class ResolutionCache final : public common::MemoryManageable {
+public:
+    static const common::MEMORY_CATEGORY MemoryCategory = common::MEM_SYMBOL;
+
+    /**
+     * @brief A symbol to which a name resolved, and the environment in which it was found
+     */
+    struct Resolution final {
+        Symbol* symbol;
+        const type::Environment* env;
+    };
+
+    ResolutionCache();
+    virtual ~ResolutionCache();
+
+    /**
+     * @param scope The scope from which the name is looked up
+     * @param name The name which is looked up
+     * @param traversedDefScope True if the lookup comes from behind a def scope
+     * @param epoch The current epoch of the scope
+     * @return The symbols to which the name resolved, or nullptr if the lookup is not in the cache
+     */
+    const std::vector<Resolution>* find(const Scope* scope, common::Name name, bool traversedDefScope, size_t epoch);
+
+    /**
+     * @brief Remembers the symbols to which the name resolved
+     * @param scope The scope from which the name was looked up
+     * @param name The name which was looked up
+     * @param traversedDefScope True if the lookup came from behind a def scope
+     * @param epoch The current epoch of the scope
+     * @param resolutions The symbols to which the name resolved
+     */
+    void store(const Scope* scope, common::Name name, bool traversedDefScope, size_t epoch,
+               std::vector<Resolution>&& resolutions);
+
+    /**
+     * @return The lookups that went through the cache so far
+     */
+    const common::ResolutionStats& getStats() const;
+
+    /**
+     * @param ctx The compilation context
+     * @return The resolution cache of the compilation
+     */
+    static ResolutionCache* get(const CompCtx_Ptr& ctx);
+
+private:
+
+    struct Slot final {
+        Slot();
+
+        const Scope* scope;
+        common::Name name;
+        bool traversedDefScope;
+        size_t epoch;
+        std::vector<Resolution> resolutions;
+    };
+
+    size_t indexOf(const Scope* scope, common::Name name, bool traversedDefScope) const;
+    void grow();
+
+    std::vector<Slot> _slots;
+    size_t _size;
+
+    common::ResolutionStats _stats;
+};
+
+}
+
+}
+
+#endif
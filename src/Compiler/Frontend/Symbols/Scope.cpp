@@ -13,17 +13,51 @@ namespace sfsl {
 
 namespace sym {
 
-Scope::Scope(Scope* parent, bool isDefScope) : _parent(parent), _isDefScope(isDefScope) {
+namespace {
+
+// below this number of used scopes, probing each of them is as fast as probing an index
+const size_t MIN_USED_SCOPES_FOR_INDEX = 4;
+
+// below this number of symbols, copying them is cheaper than inheriting them lazily
+const size_t MIN_SYMBOLS_FOR_LAZY_INHERITANCE = 8;
+
+// if we traversed a def scope, we can't access vars and methods
+bool isAccessible(const SymbolData& data, bool traversedDefScope) {
+    if (traversedDefScope) {
+        if (data.symbol->getSymbolType() == sym::SYM_VAR) {
+            return false;
+        } else if (sym::DefinitionSymbol* defsym = sym::getIfSymbolOfType<sym::DefinitionSymbol>(data.symbol)) {
+            // a method means we must capture `this` which is also not possible
+            return defsym->getOwner() == nullptr;
+        }
+    }
+    return true;
+}
+
+}
+
+Scope::Scope(ResolutionCache* cache)
+    : _parent(nullptr), _cache(cache), _isDefScope(false), _cachesLookups(false),
+      _lookupsEpoch(0), _hasCachedLookups(false), _usingsIndexStale(true) {
 
 }
 
+Scope::Scope(Scope* parent, bool isDefScope, bool cachesLookups)
+    : _parent(parent), _cache(parent ? parent->_cache : nullptr), _isDefScope(isDefScope), _cachesLookups(cachesLookups),
+      _lookupsEpoch(0), _hasCachedLookups(false), _usingsIndexStale(true) {
+    if (_cache) {
+        _parent->_children.push_back(this);
+    }
+}
+
 Scope::~Scope() {
 
 }
 
 Symbol* Scope::addSymbol(Symbol* sym) {
-    SymbolData& data = addEntry(make_pair(sym->getName(), SymbolData(sym, type::Environment::Empty)));
+    SymbolData& data = addEntry(std::make_pair(sym->getName(), SymbolData(sym, type::Environment::Empty)));
     if (data.symbol == sym) {
+        symbolsChanged();
         return nullptr;
     } else {
         return data.symbol;
@@ -31,8 +65,23 @@ Symbol* Scope::addSymbol(Symbol* sym) {
 }
 
 Symbol* Scope::copySymbolsFrom(const Scope* other, const type::Environment& env, const SymbolExcluder* excluder) {
-    for (const std::pair<std::string, SymbolData>& entry : other->getAllSymbols()) {
-        if (excluder && excluder->exclude(entry.second)) {
+    SymbolTable::Filter excluded = [excluder](Symbol* s) {
+        return excluder && excluder->exclude(SymbolData(s, type::Environment::Empty));
+    };
+
+    // the inherited symbols are only built when they are looked up, unless one of them
+    // conflicts with a symbol of this scope, in which case they are copied up to that one
+    if (!_symbols.inherits() && other->_symbols.size() >= MIN_SYMBOLS_FOR_LAZY_INHERITANCE &&
+            !conflictsWithInheritedSymbols(other, excluded)) {
+        _symbols.inherit(&other->_symbols, env, excluded);
+        symbolsChanged();
+        return nullptr;
+    }
+
+    Symbol* conflicting = nullptr;
+
+    for (const std::pair<common::Name, SymbolData>& entry : other->getAllSymbols()) {
+        if (excluded(entry.second.symbol)) {
             continue;
         }
         SymbolData& data = addEntry(entry);
@@ -40,25 +89,29 @@ Symbol* Scope::copySymbolsFrom(const Scope* other, const type::Environment& env,
             data.env.substituteAll(env);
             data.env.insert(env.begin(), env.end());
         } else {
-            return data.symbol;
+            conflicting = data.symbol;
+            break;
         }
     }
-    return nullptr;
+
+    symbolsChanged();
+    return conflicting;
 }
 
 Scope* Scope::getParent() const {
     return _parent;
 }
 
-const std::multimap<std::string, SymbolData>& Scope::getAllSymbols() const {
+const SymbolTable& Scope::getAllSymbols() const {
     return _symbols;
 }
 
 void Scope::buildUsingsFromPaths(CompCtx_Ptr& ctx, const ast::CanUseModules& obj) {
     const std::vector<ast::CanUseModules::ModulePath>& paths(obj.getUsedModules());
+    size_t usedScopesCount = _usedScopes.size();
 
     for (const ast::CanUseModules::ModulePath& path : paths) {
-        ModuleSymbol* curMod = static_cast<ModuleSymbol*>(_getSymbol(path[0], sym::SYM_MODULE, true, false));
+        ModuleSymbol* curMod = static_cast<ModuleSymbol*>(_getSymbol(ctx->names().intern(path[0]), sym::SYM_MODULE, true, false));
         if (!curMod) {
             ctx->reporter().error(path, "Cannot find any module named `" + path[0] + "`");
             break;
@@ -67,7 +120,7 @@ void Scope::buildUsingsFromPaths(CompCtx_Ptr& ctx, const ast::CanUseModules& obj
         bool ok = true;
         for (size_t i = 1; i < path.size(); ++i) {
             if (ModuleSymbol* next = static_cast<ModuleSymbol*>(
-                        curMod->getScope()->_getSymbol(path[i], sym::SYM_MODULE, false, false))) {
+                        curMod->getScope()->_getSymbol(ctx->names().intern(path[i]), sym::SYM_MODULE, false, false))) {
                 curMod = next;
             } else {
                 ok = false;
@@ -78,28 +131,114 @@ void Scope::buildUsingsFromPaths(CompCtx_Ptr& ctx, const ast::CanUseModules& obj
 
         if (ok) {
             _usedScopes.push_back(curMod->getScope());
+            curMod->getScope()->_usingScopes.push_back(this);
         }
     }
+
+    if (_usedScopes.size() != usedScopesCount) {
+        // the users of this scope only see its own symbols, so they are not affected
+        _usingsIndexStale = true;
+        forgetLookups();
+    }
 }
 
-SymbolData& Scope::addEntry(const std::pair<std::string, SymbolData>& entry) {
-    auto pos = _symbols.find(entry.first);
-    if (pos == _symbols.end() || pos->second.symbol->isOverloadableWith(entry.second.symbol)) {
-        return _symbols.insert(pos, entry)->second;
+SymbolData& Scope::addEntry(const std::pair<common::Name, SymbolData>& entry) {
+    SymbolTable::value_type* last = _symbols.find(entry.first);
+    if (!last || last->second.symbol->isOverloadableWith(entry.second.symbol)) {
+        return _symbols.insert(entry).second;
     } else {
-        return pos->second;
+        return last->second;
+    }
+}
+
+bool Scope::conflictsWithInheritedSymbols(const Scope* other, const SymbolTable::Filter& excluded) const {
+    // the inherited symbols were already checked against each other when they were added to
+    // the other scope, so only those which share their name with a symbol of this scope can conflict
+    std::vector<Symbol*> inherited;
+
+    for (const std::pair<common::Name, SymbolData>& entry : _symbols) {
+        if (_symbols.find(entry.first) != &entry) {
+            continue; // only the most recent entry of each name is compared
+        }
+
+        inherited.clear();
+
+        const auto& itPair = other->_symbols.equal_range(entry.first);
+        for (auto it = itPair.first; it != itPair.second; ++it) {
+            if (!excluded(it->second.symbol)) {
+                inherited.push_back(it->second.symbol);
+            }
+        }
+
+        // as if they were copied one by one, starting with the oldest
+        Symbol* last = entry.second.symbol;
+        for (auto it = inherited.rbegin(); it != inherited.rend(); ++it) {
+            if (!last->isOverloadableWith(*it)) {
+                return true;
+            }
+            last = *it;
+        }
+    }
+
+    return false;
+}
+
+void Scope::symbolsChanged() {
+    forgetLookups();
+
+    for (Scope* user : _usingScopes) {
+        user->_usingsIndexStale = true;
+        user->forgetLookups();
+    }
+}
+
+void Scope::forgetLookups() const {
+    if (!_hasCachedLookups) {
+        return;
+    }
+
+    ++_lookupsEpoch;
+    _hasCachedLookups = false;
+
+    for (const Scope* child : _children) {
+        child->forgetLookups();
+    }
+}
+
+void Scope::markCachedLookups() const {
+    // the ancestors of a marked scope are always marked as well
+    for (const Scope* s = this; s && !s->_hasCachedLookups; s = s->_parent) {
+        s->_hasCachedLookups = true;
     }
 }
 
-Symbol* Scope::_getSymbol(const std::string& name, SYM_TYPE symType, bool recursive, bool searchUsings) const {
+const common::NameMap<std::vector<const SymbolData*>>& Scope::getUsingsIndex() const {
+    if (_usingsIndexStale) {
+        _usingsIndex.clear();
+
+        for (const Scope* used : _usedScopes) {
+            // most recent symbols first, as when looking up the used scope itself
+            for (auto it = used->_symbols.end(); it != used->_symbols.begin();) {
+                --it;
+                _usingsIndex[it->first].push_back(&it->second);
+            }
+        }
+
+        _usingsIndexStale = false;
+    }
+
+    return _usingsIndex;
+}
+
+Symbol* Scope::_getSymbol(common::Name name, SYM_TYPE symType, bool recursive, bool searchUsings) const {
     if (_isDefScope && symType == SYM_VAR) {
         return nullptr;
     }
 
-    const auto it = _symbols.find(name);
+    const SymbolTable::value_type* entry = _symbols.find(name);
 
-    if (it != _symbols.end() && (it->second.symbol->getSymbolType() == symType || symType == -1)) {
-        return it->second.symbol;
+    if (entry && (entry->second.symbol->getSymbolType() == symType || symType == -1)) {
+        return entry->second.symbol;
     } else if (recursive) {
         Symbol* found = _parent ? _parent->_getSymbol(name, symType, recursive, searchUsings) : nullptr;
         if (!found && searchUsings) {
@@ -115,38 +254,71 @@ Symbol* Scope::_getSymbol(const std::string& name, SYM_TYPE symType, bool recurs
     }
 }
 
-bool Scope::_assignSymbolicPrologue(sym::Symbolic<Symbol>& symbolic, const std::string& id, bool searchUsings) const {
+bool Scope::_assignSymbolicPrologue(sym::Symbolic<Symbol>& symbolic, common::Name id, bool searchUsings) const {
     symbolic._symbols.clear();
-    return _assignSymbolic(symbolic, id, searchUsings, false);
+    return searchUsings ? _assignSymbolicCached(symbolic, id, false) : _assignSymbolicUncached(symbolic, id, false, false);
+}
+
+bool Scope::_assignSymbolic(sym::Symbolic<Symbol>& symbolic, common::Name id, bool searchUsings, bool traversedDefScope) const {
+    if (searchUsings && _cachesLookups) {
+        return _assignSymbolicCached(symbolic, id, traversedDefScope);
+    }
+    return _assignSymbolicUncached(symbolic, id, searchUsings, traversedDefScope);
+}
+
+bool Scope::_assignSymbolicCached(sym::Symbolic<Symbol>& symbolic, common::Name id, bool traversedDefScope) const {
+    if (!_cache) {
+        return _assignSymbolicUncached(symbolic, id, true, traversedDefScope);
+    }
+
+    // complete lookups always start with an empty symbolic, so their results can be reused as is
+    if (const std::vector<ResolutionCache::Resolution>* resolutions = _cache->find(this, id, traversedDefScope, _lookupsEpoch)) {
+        for (const ResolutionCache::Resolution& resolution : *resolutions) {
+            symbolic._symbols.push_back(Symbolic<Symbol>::SymbolData(resolution.symbol, resolution.env));
+        }
+        return !resolutions->empty();
+    }
+
+    bool found = _assignSymbolicUncached(symbolic, id, true, traversedDefScope);
+
+    std::vector<ResolutionCache::Resolution> resolutions;
+    resolutions.reserve(symbolic._symbols.size());
+    for (const Symbolic<Symbol>::SymbolData& data : symbolic._symbols) {
+        resolutions.push_back(ResolutionCache::Resolution{data.symbol, data.env});
+    }
+    _cache->store(this, id, traversedDefScope, _lookupsEpoch, std::move(resolutions));
+    markCachedLookups();
+
+    return found;
 }
 
-bool Scope::_assignSymbolic(sym::Symbolic<Symbol>& symbolic, const std::string& id, bool searchUsings, bool traversedDefScope) const {
+bool Scope::_assignSymbolicUncached(sym::Symbolic<Symbol>& symbolic, common::Name id, bool searchUsings, bool traversedDefScope) const {
     const auto& itPair = _symbols.equal_range(id);
 
     if (itPair.first != itPair.second) {
         for (auto it = itPair.first; it != itPair.second; ++it) {
             const SymbolData& data = it->second;
-
-            // if we traversed a def scope, we can't access vars and method
-            if (traversedDefScope) {
-                if (data.symbol->getSymbolType() == sym::SYM_VAR) {
-                    continue;
-                } else if (sym::DefinitionSymbol* defsym = sym::getIfSymbolOfType<sym::DefinitionSymbol>(data.symbol)) {
-                    if (defsym->getOwner() != nullptr) {
-                        // means we must capture `this` which is also not possible
-                        continue;
-                    }
-                }
+            if (isAccessible(data, traversedDefScope)) {
+                symbolic._symbols.push_back(Symbolic<Symbol>::SymbolData(data.symbol, data.env));
             }
-
-            symbolic._symbols.push_back(Symbolic<Symbol>::SymbolData(data.symbol, data.env));
         }
         return symbolic.getSymbolCount() > 0;
     } else if (searchUsings) {
         bool ok = false;
 
-        for (const Scope* s : _usedScopes) {
-            ok = ok | s->_assignSymbolic(symbolic, id, false, traversedDefScope);
+        if (_cachesLookups && _usedScopes.size() >= MIN_USED_SCOPES_FOR_INDEX) {
+            if (const std::vector<const SymbolData*>* candidates = getUsingsIndex().find(id)) {
+                for (const SymbolData* data : *candidates) {
+                    if (isAccessible(*data, traversedDefScope)) {
+                        symbolic._symbols.push_back(Symbolic<Symbol>::SymbolData(data->symbol, data->env));
+                    }
+                }
+            }
+            ok = symbolic.getSymbolCount() > 0;
+        } else {
+            for (const Scope* s : _usedScopes) {
+                ok = ok | s->_assignSymbolic(symbolic, id, false, traversedDefScope);
+            }
         }
 
         if (!ok) { // couldn't find symbol in usings
@@ -179,7 +351,7 @@ Scope::SymbolExcluder::~SymbolExcluder() {
 }
 
 
-Scope::ByNameSymbolExcluder::ByNameSymbolExcluder(const std::string& name) : _name(name) {
+Scope::ByNameSymbolExcluder::ByNameSymbolExcluder(common::Name name) : _name(name) {
 
 }
 
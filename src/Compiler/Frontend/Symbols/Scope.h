@@ -10,9 +10,11 @@
 #define __SFSL__Scope__
 
 #include <iostream>
-#include <map>
 #include "../../Common/MemoryManageable.h"
+#include "../../Common/NameMap.h"
 #include "Symbols.h"
+#include "SymbolTable.h"
+#include "ResolutionCache.h"
 #include "Symbolic.h"
 #include "../AST/Utils/CanUseModules.h"
 
@@ -22,9 +24,25 @@ namespace sym {
 
 class Scope final : public common::MemoryManageable {
 public:
+    static const common::MEMORY_CATEGORY MemoryCategory = common::MEM_SYMBOL;
+
     struct SymbolExcluder;
 
-    Scope(Scope* parent, bool isDefScope = false);
+    /**
+     * @brief Creates a root scope
+     * @param cache The cache in which the scope and its descendants remember
+     * the result of their lookups, or nullptr to disable caching
+     */
+    Scope(ResolutionCache* cache);
+
+    /**
+     * @param parent The enclosing scope
+     * @param isDefScope True if vars and methods of the enclosing scopes are not accessible from this scope
+     * @param cachesLookups True if the lookups going through this scope should be remembered,
+     * and not only those starting from it. Meant for scopes through which many names are looked up,
+     * such as the scopes of modules and classes, so that the lookups of inner scopes stop at them.
+     */
+    Scope(Scope* parent, bool isDefScope = false, bool cachesLookups = false);
     virtual ~Scope();
 
     /**
@@ -37,8 +55,13 @@ public:
     Symbol* addSymbol(Symbol* sym);
 
     /**
-     * @brief Copies all the symbols from the given scope into this one
+     * @brief Makes all the symbols from the given scope visible from this one, as if they
+     * were copied into it. Their environments are only composed with the given one when
+     * they are looked up, so the given scope must not change anymore
+     *
      * @param other The scope from which to copy the symbol
+     * @param env The environment with which to compose the ones of the copied symbols
+     * @param excluder Tells which symbols must not be copied. Must outlive this scope
      * @return A non-overloadable symbol of the same name in the current scope if any, otherwise nullptr
      */
     Symbol* copySymbolsFrom(const Scope* other, const type::Environment& env, const SymbolExcluder* exluder);
@@ -53,7 +76,7 @@ public:
      * @param recursive Sets whether or not to recursively look in the parents scope
      * @return The Symbol that matched the given arguments, or nullptr if none was found
      */
-    T* getSymbol(const std::string& name, bool recursive = true) const {
+    T* getSymbol(common::Name name, bool recursive = true) const {
         return nullptr;
     }
 
@@ -66,7 +89,7 @@ public:
      * @param id The name of the symbol to look up
      * @return True if a symbol with the given named was found, otherwise false
      */
-    bool assignSymbolic(sym::Symbolic<T>& symbolic, const std::string& id);
+    bool assignSymbolic(sym::Symbolic<T>& symbolic, common::Name id);
 
     /**
      * @return The parent if this scope
@@ -74,9 +97,9 @@ public:
     Scope* getParent() const;
 
     /**
-     * @return The map containing all the symbols
+     * @return The table containing all the symbols
      */
-    const std::multimap<std::string, SymbolData>& getAllSymbols() const;
+    const SymbolTable& getAllSymbols() const;
 
     /**
      * @brief Builds the related scopes from the using statements
@@ -100,13 +123,13 @@ public:
      * @brief Implementation of symbol excluder which excludes symbol based on the given name
      */
     struct ByNameSymbolExcluder : public SymbolExcluder {
-        ByNameSymbolExcluder(const std::string& name);
+        ByNameSymbolExcluder(common::Name name);
         virtual ~ByNameSymbolExcluder();
 
         virtual bool exclude(const SymbolData s) const override;
 
     private:
-        std::string _name;
+        common::Name _name;
     };
 
     /**
@@ -121,47 +144,69 @@ public:
 
 private:
 
-    SymbolData& addEntry(const std::pair<std::string, SymbolData>& entry);
+    SymbolData& addEntry(const std::pair<common::Name, SymbolData>& entry);
+    bool conflictsWithInheritedSymbols(const Scope* other, const SymbolTable::Filter& excluded) const;
+    void symbolsChanged();
+    void forgetLookups() const;
+    void markCachedLookups() const;
+
+    const common::NameMap<std::vector<const SymbolData*>>& getUsingsIndex() const;
 
-    Symbol* _getSymbol(const std::string& name, SYM_TYPE symType, bool recursive, bool searchUsings) const;
-    bool _assignSymbolicPrologue(Symbolic<Symbol>& symbolic, const std::string& id, bool searchUsings) const;
-    bool _assignSymbolic(Symbolic<Symbol>& symbolic, const std::string& id, bool searchUsings, bool traversedDefScope) const;
+    Symbol* _getSymbol(common::Name name, SYM_TYPE symType, bool recursive, bool searchUsings) const;
+    bool _assignSymbolicPrologue(Symbolic<Symbol>& symbolic, common::Name id, bool searchUsings) const;
+    bool _assignSymbolic(Symbolic<Symbol>& symbolic, common::Name id, bool searchUsings, bool traversedDefScope) const;
+    bool _assignSymbolicCached(Symbolic<Symbol>& symbolic, common::Name id, bool traversedDefScope) const;
+    bool _assignSymbolicUncached(Symbolic<Symbol>& symbolic, common::Name id, bool searchUsings, bool traversedDefScope) const;
 
     Scope* _parent;
+    ResolutionCache* _cache;
     bool _isDefScope;
+    bool _cachesLookups;
 
     std::vector<Scope*> _usedScopes;
+    std::vector<Scope*> _usingScopes;
+
+    // the lookups starting from a scope go through its ancestors and their used scopes,
+    // so a change to a scope only affects the cached lookups of its subtree (and of the
+    // subtrees of its users). Children are only known to scopes which have a cache.
+    std::vector<const Scope*> _children;
+    mutable size_t _lookupsEpoch;
+    mutable bool _hasCachedLookups; // true if this scope or a descendant may have cached lookups
+
+    SymbolTable _symbols;
 
-    std::multimap<std::string, SymbolData> _symbols;
+    // the symbols of all the used scopes, by name
+    mutable bool _usingsIndexStale;
+    mutable common::NameMap<std::vector<const SymbolData*>> _usingsIndex;
 };
 
 template<typename T>
-bool Scope::assignSymbolic(Symbolic<T>& symbolic, const std::string& id) {
+bool Scope::assignSymbolic(Symbolic<T>& symbolic, common::Name id) {
     return _assignSymbolicPrologue(static_cast<Symbolic<Symbol>&>(symbolic), id, true);
 }
 
 template<>
-inline Symbol* Scope::getSymbol(const std::string& name, bool recursive) const {
+inline Symbol* Scope::getSymbol(common::Name name, bool recursive) const {
     return _getSymbol(name, static_cast<SYM_TYPE>(-1), recursive, true);
 }
 
 template<>
-inline ModuleSymbol* Scope::getSymbol(const std::string& name, bool recursive) const {
+inline ModuleSymbol* Scope::getSymbol(common::Name name, bool recursive) const {
     return static_cast<ModuleSymbol*>(_getSymbol(name, SYM_MODULE, recursive, true));
 }
 
 template<>
-inline TypeSymbol* Scope::getSymbol(const std::string& name, bool recursive) const {
+inline TypeSymbol* Scope::getSymbol(common::Name name, bool recursive) const {
     return static_cast<TypeSymbol*>(_getSymbol(name, SYM_TPE, recursive, true));
 }
 
 template<>
-inline DefinitionSymbol* Scope::getSymbol(const std::string& name, bool recursive) const {
+inline DefinitionSymbol* Scope::getSymbol(common::Name name, bool recursive) const {
     return static_cast<DefinitionSymbol*>(_getSymbol(name, SYM_DEF, recursive, true));
 }
 
 template<>
-inline VariableSymbol* Scope::getSymbol(const std::string& name, bool recursive) const {
+inline VariableSymbol* Scope::getSymbol(common::Name name, bool recursive) const {
     return static_cast<VariableSymbol*>(_getSymbol(name, SYM_VAR, recursive, true));
 }
 
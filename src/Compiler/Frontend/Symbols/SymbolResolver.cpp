@@ -34,7 +34,7 @@ Symbol* SymbolResolver::getSymbol(const std::vector<std::string>& fullPath) cons
             return nullptr;
         }
 
-        if ((lastSym = scope->getSymbol<sym::Symbol>(part, false))) {
+        if ((lastSym = scope->getSymbol<sym::Symbol>(_ctx->names().intern(part), false))) {
             Scoped* scoped;
 
             switch (lastSym->getSymbolType()) {
@@ -0,0 +1,235 @@
+//
+//  SymbolTable.cpp
+//  SFSL
+//
+//  Created by Romain Beguet on 24.10.16.
+//  Copyright (c) 2016 Romain Beguet. All rights reserved.
+//
+
+#include "SymbolTable.h"
+
+namespace sfsl {
+
+namespace sym {
+
+// CONST ITERATOR
+
+SymbolTable::const_iterator::const_iterator(const SymbolTable* table, size_t index)
+    : _table(table), _index(index) {
+
+}
+
+const SymbolTable::value_type& SymbolTable::const_iterator::operator *() const {
+    return _table->entryAt(_index);
+}
+
+const SymbolTable::value_type* SymbolTable::const_iterator::operator ->() const {
+    return &_table->entryAt(_index);
+}
+
+SymbolTable::const_iterator& SymbolTable::const_iterator::operator ++() {
+    ++_index;
+    return *this;
+}
+
+SymbolTable::const_iterator& SymbolTable::const_iterator::operator --() {
+    --_index;
+    return *this;
+}
+
+bool SymbolTable::const_iterator::operator ==(const const_iterator& other) const {
+    return _index == other._index;
+}
+
+bool SymbolTable::const_iterator::operator !=(const const_iterator& other) const {
+    return _index != other._index;
+}
+
+// NAME ITERATOR
+
+SymbolTable::NameIterator::NameIterator(const SymbolTable* table, size_t index, size_t inheritedBegin, size_t inheritedEnd)
+    : _table(table), _index(index), _inherited(NO_ENTRY),
+      _inheritedBegin(inheritedBegin), _inheritedEnd(inheritedEnd), _resume(NO_ENTRY) {
+    enterInheritedEntries();
+}
+
+const SymbolTable::value_type& SymbolTable::NameIterator::operator *() const {
+    return _inherited == NO_ENTRY ? _table->_entries[_index] : _table->_inheritance->entries[_inherited];
+}
+
+const SymbolTable::value_type* SymbolTable::NameIterator::operator ->() const {
+    return &**this;
+}
+
+SymbolTable::NameIterator& SymbolTable::NameIterator::operator ++() {
+    if (_inherited != NO_ENTRY) {
+        if (++_inherited == _inheritedEnd) {
+            _inherited = NO_ENTRY;
+            _index = _resume;
+        }
+    } else {
+        _index = _table->_nextWithSameName[_index];
+        enterInheritedEntries();
+    }
+    return *this;
+}
+
+bool SymbolTable::NameIterator::operator ==(const NameIterator& other) const {
+    return _index == other._index && _inherited == other._inherited;
+}
+
+bool SymbolTable::NameIterator::operator !=(const NameIterator& other) const {
+    return !(*this == other);
+}
+
+void SymbolTable::NameIterator::enterInheritedEntries() {
+    // the inherited entries come right before the ones that were added before the table inherited
+    if (_inheritedBegin != _inheritedEnd && (_index == NO_ENTRY || _index < _table->_inheritedAt)) {
+        _resume = _index;
+        _index = NO_ENTRY;
+        _inherited = _inheritedBegin;
+        _inheritedBegin = _inheritedEnd;
+    }
+}
+
+// SYMBOL TABLE
+
+const size_t SymbolTable::NO_ENTRY;
+
+SymbolTable::SymbolTable() : _inheritedAt(NO_ENTRY) {
+
+}
+
+SymbolTable::~SymbolTable() {
+
+}
+
+SymbolTable::const_iterator SymbolTable::begin() const {
+    return const_iterator(this, 0);
+}
+
+SymbolTable::const_iterator SymbolTable::end() const {
+    return const_iterator(this, size());
+}
+
+std::pair<SymbolTable::NameIterator, SymbolTable::NameIterator> SymbolTable::equal_range(common::Name name) const {
+    const size_t* last = _lastWithName.find(name);
+    std::pair<size_t, size_t> inherited(inheritedRange(name));
+
+    return std::make_pair(NameIterator(this, last ? *last : NO_ENTRY, inherited.first, inherited.second),
+                          NameIterator(this, NO_ENTRY, 0, 0));
+}
+
+SymbolTable::value_type* SymbolTable::find(common::Name name) {
+    const auto& itPair = equal_range(name);
+    return itPair.first != itPair.second ? const_cast<value_type*>(&*itPair.first) : nullptr;
+}
+
+const SymbolTable::value_type* SymbolTable::find(common::Name name) const {
+    return const_cast<SymbolTable*>(this)->find(name);
+}
+
+SymbolTable::value_type& SymbolTable::insert(const value_type& entry) {
+    const size_t* last = _lastWithName.find(entry.first);
+
+    _nextWithSameName.push_back(last ? *last : NO_ENTRY);
+    _entries.push_back(entry);
+    _lastWithName[entry.first] = _entries.size() - 1;
+
+    return _entries.back();
+}
+
+void SymbolTable::inherit(const SymbolTable* base, const type::Environment& env, const Filter& excluded) {
+    _inheritance.reset(new Inheritance{base, env, excluded, {}, {}, {}, {}, false});
+    _inheritedAt = _entries.size();
+}
+
+bool SymbolTable::inherits() const {
+    return _inheritance != nullptr;
+}
+
+size_t SymbolTable::size() const {
+    return _entries.size() + (_inheritance ? inheritedSymbols().size() : 0);
+}
+
+const SymbolTable::value_type& SymbolTable::entryAt(size_t index) const {
+    if (index < _inheritedAt) {
+        return _entries[index];
+    }
+
+    size_t inheritedCount = inheritedSymbols().size();
+
+    if (index - _inheritedAt < inheritedCount) {
+        return *inheritedInOrder()[index - _inheritedAt];
+    } else {
+        return _entries[index - inheritedCount];
+    }
+}
+
+std::pair<size_t, size_t> SymbolTable::inheritedRange(common::Name name) const {
+    if (!_inheritance) {
+        return std::make_pair(0, 0);
+    }
+
+    Inheritance& inheritance(*_inheritance);
+
+    if (const std::pair<size_t, size_t>* range = inheritance.byName.find(name)) {
+        return *range;
+    }
+
+    size_t first = inheritance.entries.size();
+
+    const auto& itPair = inheritance.base->equal_range(name);
+    for (auto it = itPair.first; it != itPair.second; ++it) {
+        if (!inheritance.excluded(it->second.symbol)) {
+            inheritance.entries.push_back(*it);
+
+            type::Environment& env = inheritance.entries.back().second.env;
+            env.substituteAll(inheritance.env);
+            env.insert(inheritance.env.begin(), inheritance.env.end());
+        }
+    }
+
+    return inheritance.byName[name] = std::make_pair(first, inheritance.entries.size());
+}
+
+const std::vector<std::pair<common::Name, Symbol*>>& SymbolTable::inheritedSymbols() const {
+    Inheritance& inheritance(*_inheritance);
+
+    if (!inheritance.symbolsBuilt) {
+        inheritance.base->forEachSymbol([&inheritance](common::Name name, Symbol* s) {
+            if (!inheritance.excluded(s)) {
+                inheritance.symbols.push_back(std::make_pair(name, s));
+            }
+        });
+        inheritance.symbolsBuilt = true;
+    }
+
+    return inheritance.symbols;
+}
+
+const std::vector<const SymbolTable::value_type*>& SymbolTable::inheritedInOrder() const {
+    Inheritance& inheritance(*_inheritance);
+    const std::vector<std::pair<common::Name, Symbol*>>& symbols(inheritedSymbols());
+
+    if (inheritance.inOrder.size() != symbols.size()) {
+        inheritance.inOrder.clear();
+        inheritance.inOrder.reserve(symbols.size());
+
+        for (const std::pair<common::Name, Symbol*>& inherited : symbols) {
+            std::pair<size_t, size_t> range(inheritedRange(inherited.first));
+            for (size_t i = range.first; i < range.second; ++i) {
+                if (inheritance.entries[i].second.symbol == inherited.second) {
+                    inheritance.inOrder.push_back(&inheritance.entries[i]);
+                    break;
+                }
+            }
+        }
+    }
+
+    return inheritance.inOrder;
+}
+
+}
+
+}
@@ -0,0 +1,207 @@
+//
+//  SymbolTable.h
+//  SFSL
+//
+//  Created by Romain Beguet on 24.10.16.
+//  Copyright (c) 2016 Romain Beguet. All rights reserved.
+//
+
+#ifndef __SFSL__SymbolTable__
+#define __SFSL__SymbolTable__
+
+#include <deque>
+#include <vector>
+#include <iterator>
+#include <functional>
+#include <memory>
+#include "../../Common/NameMap.h"
+#include "Symbols.h"
+
+namespace sfsl {
+
+namespace sym {
+
+/**
+ * @brief The symbols of a scope. Several symbols can share the same name
+ * (e.g. overloaded definitions), in which case they are enumerated from the
+ * most recently added to the oldest one. The entries are never moved, so
+ * pointers to them remain valid when other symbols are added.
+ *
+ * A table can also inherit the entries of another one (e.g. a class inherits
+ * the members of its parent class). They behave as if they had been copied
+ * at that point with their environment composed with the given one, but
+ * an inherited entry is only built the first time its name is looked up.
+ */
+class SymbolTable final {
+public:
+
+    typedef std::pair<common::Name, SymbolData> value_type;
+    typedef std::function<bool(Symbol*)> Filter;
+
+    /**
+     * @brief Iterates over all the entries of the table, in the order in which they were added
+     */
+    class const_iterator final : public std::iterator<std::bidirectional_iterator_tag, value_type> {
+    public:
+        const_iterator(const SymbolTable* table, size_t index);
+
+        const value_type& operator *() const;
+        const value_type* operator ->() const;
+
+        const_iterator& operator ++();
+        const_iterator& operator --();
+
+        bool operator ==(const const_iterator& other) const;
+        bool operator !=(const const_iterator& other) const;
+
+    private:
+
+        const SymbolTable* _table;
+        size_t _index;
+    };
+
+    /**
+     * @brief Iterates over the entries of the table which have a given name
+     */
+    class NameIterator final : public std::iterator<std::forward_iterator_tag, value_type> {
+    public:
+        NameIterator(const SymbolTable* table, size_t index, size_t inheritedBegin, size_t inheritedEnd);
+
+        const value_type& operator *() const;
+        const value_type* operator ->() const;
+
+        NameIterator& operator ++();
+
+        bool operator ==(const NameIterator& other) const;
+        bool operator !=(const NameIterator& other) const;
+
+    private:
+
+        void enterInheritedEntries();
+
+        const SymbolTable* _table;
+        size_t _index; // the current entry of the table itself, if any
+        size_t _inherited; // the current inherited entry, if any
+        size_t _inheritedBegin;
+        size_t _inheritedEnd;
+        size_t _resume; // the entry of the table itself which comes after the inherited ones
+    };
+
+    SymbolTable();
+    ~SymbolTable();
+
+    /**
+     * @return An iterator to the first entry, in the order in which they were added
+     */
+    const_iterator begin() const;
+
+    /**
+     * @return An iterator past the last entry
+     */
+    const_iterator end() const;
+
+    /**
+     * @param name The name of the entries to look for
+     * @return The range of entries which have the given name
+     */
+    std::pair<NameIterator, NameIterator> equal_range(common::Name name) const;
+
+    /**
+     * @param name The name of the entry to look for
+     * @return The most recently added entry with the given name, or nullptr if there is none
+     */
+    value_type* find(common::Name name);
+
+    /**
+     * @param name The name of the entry to look for
+     * @return The most recently added entry with the given name, or nullptr if there is none
+     */
+    const value_type* find(common::Name name) const;
+
+    /**
+     * @brief Adds the entry in front of the entries which have the same name
+     * @param entry The entry to add
+     * @return The added entry
+     */
+    value_type& insert(const value_type& entry);
+
+    /**
+     * @brief Makes the entries of the given table visible from this one, as
+     * if they were all inserted now. Can only be done once per table.
+     *
+     * @param base The table to inherit from. Must not change anymore
+     * @param env The environment with which to compose the ones of the inherited entries
+     * @param excluded Tells which symbols of the base table must not be inherited.
+     * Must not depend on anything else than the symbol
+     */
+    void inherit(const SymbolTable* base, const type::Environment& env, const Filter& excluded);
+
+    /**
+     * @return True if this table already inherits from another one
+     */
+    bool inherits() const;
+
+    template<typename F>
+    /**
+     * @brief Calls the given function with the name and the symbol of each entry, in the
+     * order in which they were added. Unlike iterating over the table, this does not
+     * build the inherited entries
+     *
+     * @param f The function to call
+     */
+    void forEachSymbol(F f) const {
+        for (size_t i = 0; i <= _entries.size(); ++i) {
+            if (i == _inheritedAt) {
+                for (const std::pair<common::Name, Symbol*>& inherited : inheritedSymbols()) {
+                    f(inherited.first, inherited.second);
+                }
+            }
+            if (i < _entries.size()) {
+                f(_entries[i].first, _entries[i].second.symbol);
+            }
+        }
+    }
+
+    /**
+     * @return The number of entries in the table
+     */
+    size_t size() const;
+
+private:
+
+    static const size_t NO_ENTRY = (size_t)-1;
+
+    const value_type& entryAt(size_t index) const;
+    std::pair<size_t, size_t> inheritedRange(common::Name name) const;
+    const std::vector<std::pair<common::Name, Symbol*>>& inheritedSymbols() const;
+    const std::vector<const value_type*>& inheritedInOrder() const;
+
+    std::deque<value_type> _entries;
+    std::vector<size_t> _nextWithSameName;
+    common::NameMap<size_t> _lastWithName;
+
+    // only allocated by the tables which inherit, as most of them never do
+    struct Inheritance final {
+        const SymbolTable* base;
+        type::Environment env;
+        Filter excluded;
+
+        // the inherited entries which were built so far, grouped by name
+        std::deque<value_type> entries;
+        common::NameMap<std::pair<size_t, size_t>> byName;
+
+        // the inherited symbols in the order of the base table, and the corresponding entries
+        std::vector<std::pair<common::Name, Symbol*>> symbols;
+        std::vector<const value_type*> inOrder;
+        bool symbolsBuilt;
+    };
+
+    std::unique_ptr<Inheritance> _inheritance;
+    size_t _inheritedAt; // the number of entries the table had when it inherited
+};
+
+}
+
+}
+
+#endif
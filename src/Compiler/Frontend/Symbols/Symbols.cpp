@@ -14,7 +14,7 @@ namespace sym {
 
 // SYMBOL
 
-Symbol::Symbol(const std::string& name, const std::string& absoluteName)
+Symbol::Symbol(common::Name name, const std::string& absoluteName)
     : _name(name), _absoluteName(absoluteName) {
 
 }
@@ -27,7 +27,7 @@ bool Symbol::isOverloadableWith(Symbol*) const {
     return false;
 }
 
-const std::string& Symbol::getName() const {
+common::Name Symbol::getName() const {
     return _name;
 }
 
@@ -37,7 +37,7 @@ const std::string& Symbol::getAbsoluteName() const {
 
 // MODULE SYMBOL
 
-ModuleSymbol::ModuleSymbol(const std::string& name, const std::string& absoluteName) : Symbol(name, absoluteName) {
+ModuleSymbol::ModuleSymbol(common::Name name, const std::string& absoluteName) : Symbol(name, absoluteName) {
 
 }
 
@@ -51,7 +51,7 @@ SYM_TYPE ModuleSymbol::getSymbolType() const {
 
 // CLASS SYMBOL
 
-TypeSymbol::TypeSymbol(const std::string& name, const std::string& absoluteName, ast::TypeDecl* type)
+TypeSymbol::TypeSymbol(common::Name name, const std::string& absoluteName, ast::TypeDecl* type)
     : Symbol(name, absoluteName), _type(type) {
 
 }
@@ -70,7 +70,7 @@ ast::TypeDecl* TypeSymbol::getTypeDecl() const {
 
 // DEFINITION SYMBOL
 
-DefinitionSymbol::DefinitionSymbol(const std::string& name, const std::string& absoluteName, ast::DefineDecl* def, ast::TypeExpression* owner)
+DefinitionSymbol::DefinitionSymbol(common::Name name, const std::string& absoluteName, ast::DefineDecl* def, ast::TypeExpression* owner)
     : Symbol(name, absoluteName), _def(def), _owner(owner), _overriden(nullptr) {
 
 }
@@ -105,7 +105,7 @@ DefinitionSymbol *DefinitionSymbol::getOverridenSymbol() const {
 
 // VARIABLE SYMBOL
 
-VariableSymbol::VariableSymbol(const std::string& name, const std::string& absoluteName) : Symbol(name, absoluteName) {
+VariableSymbol::VariableSymbol(common::Name name, const std::string& absoluteName) : Symbol(name, absoluteName) {
 
 }
 
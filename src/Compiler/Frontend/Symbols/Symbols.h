@@ -13,6 +13,7 @@
 #include <map>
 #include "../../Common/MemoryManageable.h"
 #include "../../Common/Positionnable.h"
+#include "../../Common/Name.h"
 #include "../../Common/ManageableUserData.h"
 #include "../Types/Types.h"
 #include "../Kinds/Kinds.h"
@@ -41,6 +42,8 @@ class VariableSymbol;
  */
 class Symbol : public common::MemoryManageable, public common::Positionnable {
 public:
+    static const common::MEMORY_CATEGORY MemoryCategory = common::MEM_SYMBOL;
+
     virtual ~Symbol();
 
     /**
@@ -56,7 +59,7 @@ public:
     /**
      * @return The name of this symbol
      */
-    const std::string& getName() const;
+    common::Name getName() const;
 
     /**
      * @return The absolute name of this symbol (path.name)
@@ -64,11 +67,11 @@ public:
     const std::string& getAbsoluteName() const;
 
 protected:
-    Symbol(const std::string& name, const std::string& absoluteName);
+    Symbol(common::Name name, const std::string& absoluteName);
 
 private:
 
-    const std::string _name;
+    const common::Name _name;
     const std::string _absoluteName;
 };
 
@@ -77,7 +80,7 @@ private:
  */
 class ModuleSymbol : public Symbol, public Scoped {
 public:
-    ModuleSymbol(const std::string& name, const std::string& absoluteName);
+    ModuleSymbol(common::Name name, const std::string& absoluteName);
     virtual ~ModuleSymbol();
 
     virtual SYM_TYPE getSymbolType() const override;
@@ -88,7 +91,7 @@ public:
  */
 class TypeSymbol : public Symbol, public Scoped, public type::Typed, public kind::Kinded, public common::HasManageableUserdata {
 public:
-    TypeSymbol(const std::string& name, const std::string& absoluteName, ast::TypeDecl* type);
+    TypeSymbol(common::Name name, const std::string& absoluteName, ast::TypeDecl* type);
     virtual ~TypeSymbol();
 
     virtual SYM_TYPE getSymbolType() const override;
@@ -105,7 +108,7 @@ private:
  */
 class DefinitionSymbol : public Symbol, public Scoped, public type::Typed, public common::HasManageableUserdata {
 public:
-    DefinitionSymbol(const std::string& name, const std::string& absoluteName, ast::DefineDecl* def, ast::TypeExpression* owner = nullptr);
+    DefinitionSymbol(common::Name name, const std::string& absoluteName, ast::DefineDecl* def, ast::TypeExpression* owner = nullptr);
     virtual ~DefinitionSymbol();
 
     virtual SYM_TYPE getSymbolType() const override;
@@ -135,7 +138,7 @@ class VariableSymbol :
         public ast::UsageTrackable,
         public common::HasManageableUserdata {
 public:
-    VariableSymbol(const std::string& name, const std::string& absoluteName);
+    VariableSymbol(common::Name name, const std::string& absoluteName);
     virtual ~VariableSymbol();
 
     virtual SYM_TYPE getSymbolType() const override;
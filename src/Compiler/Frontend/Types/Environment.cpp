@@ -10,11 +10,102 @@
 #include "Types.h"
 #include <algorithm>
 #include <numeric>
+#include <atomic>
+#include <memory>
+#include <new>
 
 namespace sfsl {
 
 namespace type {
 
+/**
+ * @brief The storage of the environments that have more than #InlineCapacity substitutions.
+ * The substitutions are stored right after the block. A block can only be modified
+ * while a single environment refers to it.
+ *
+ * A block also remembers the result of its last composition with a small environment,
+ * whose substitutions it keeps a copy of: environments built at different places often
+ * have the same substitutions. The result is always a block allocated after this one,
+ * so that blocks cannot retain each other in a cycle.
+ */
+struct Environment::Block final {
+    static constexpr size_t ComposedCapacity = 4;
+
+    Block(size_t cap) : refCount(1), capacity(cap),
+        composedWithSize(0), composedResult(nullptr), composedMatched(false) {
+
+    }
+
+    Substitution* subs() {
+        return reinterpret_cast<Substitution*>(this + 1);
+    }
+
+    bool hasComposedWith(const Environment& env) const {
+        if (composedWithSize != env._size) {
+            return false;
+        }
+
+        const Substitution* subs = env.data();
+        for (size_t i = 0; i < composedWithSize; ++i) {
+            if (composedWith[i].key != subs[i].key || composedWith[i].value != subs[i].value) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    void remember(const Environment& env, Block* result, bool matched) {
+        forgetComposition();
+        if (env._size > ComposedCapacity) {
+            return;
+        }
+
+        if (result) {
+            ++result->refCount;
+        }
+
+        std::copy(env.begin(), env.end(), composedWith);
+        composedWithSize = env._size;
+        composedResult = result;
+        composedMatched = matched;
+    }
+
+    void forgetComposition() {
+        if (composedResult) {
+            release(composedResult);
+        }
+        composedWithSize = 0;
+        composedResult = nullptr;
+    }
+
+    static Block* allocate(size_t capacity) {
+        void* mem = ::operator new(sizeof(Block) + capacity * sizeof(Substitution));
+        return new (mem) Block(capacity);
+    }
+
+    static void release(Block* block) {
+        // iterative, since results of compositions may form long chains
+        while (block && --block->refCount == 0) {
+            Block* next = block->composedResult;
+            block->~Block();
+            ::operator delete(block);
+            block = next;
+        }
+    }
+
+    size_t refCount;
+    size_t capacity;
+
+    size_t composedWithSize;
+    Substitution composedWith[ComposedCapacity];
+    Block* composedResult;
+    bool composedMatched;
+};
+
+static_assert(sizeof(Environment::Substitution) % alignof(Environment::Substitution) == 0 &&
+              alignof(Environment::Substitution) <= alignof(void*),
+              "Substitutions must be storable right after a block");
+
 Environment const Environment::Empty = type::Environment();
 
 Environment::Substitution::Substitution()
@@ -27,74 +118,176 @@ Environment::Substitution::Substitution(common::VARIANCE_TYPE vt, Type* k, Type*
 
 }
 
-Environment::SubstitutionComparator Environment::Comparator;
+static std::atomic<size_t> copyCount(0);
+static std::atomic<size_t> copiedBytes(0);
+
+static bool keyLess(const Environment::Substitution& a, const Environment::Substitution& b) {
+    return a.key < b.key;
+}
+
+Environment::Environment() : _size(0), _block(nullptr) {
 
-Environment::Environment() {
+}
+
+Environment::Environment(const Environment& other) : _size(other._size), _block(nullptr) {
+    if (other.isShared()) {
+        _block = other._block;
+        ++_block->refCount;
+    } else {
+        std::copy(other._inline, other._inline + _size, _inline);
+    }
+}
 
+Environment::Environment(Environment&& other) : _size(other._size), _block(nullptr) {
+    if (other.isShared()) {
+        _block = other._block;
+    } else {
+        std::copy(other._inline, other._inline + _size, _inline);
+    }
+    other._size = 0;
 }
 
 Environment::~Environment() {
+    release();
+}
 
+Environment& Environment::operator =(const Environment& other) {
+    if (this != &other) {
+        if (other.isShared()) {
+            ++other._block->refCount;
+            assignBlock(other._block);
+            _size = other._size;
+        } else {
+            release();
+            std::copy(other._inline, other._inline + other._size, _inline);
+            _size = other._size;
+        }
+    }
+    return *this;
 }
 
-bool Environment::empty() const {
-    return _subs.empty();
+Environment& Environment::operator =(Environment&& other) {
+    if (this != &other) {
+        if (other.isShared()) {
+            assignBlock(other._block);
+        } else {
+            release();
+            std::copy(other._inline, other._inline + other._size, _inline);
+        }
+        _size = other._size;
+        other._size = 0;
+    }
+    return *this;
 }
 
-size_t Environment::size() const {
-    return _subs.size();
+common::MemoryUsage Environment::getCopyStats() {
+    return common::MemoryUsage{copiedBytes.load(std::memory_order_relaxed), copyCount.load(std::memory_order_relaxed)};
 }
 
-Environment::iterator Environment::insert(const Environment::Substitution& p) {
-    auto lb = std::lower_bound(begin(), end(), p, Comparator);
-    return _subs.insert(lb, p);
+void Environment::accountCopy(size_t count) {
+    if (count > 0) {
+        copyCount.fetch_add(1, std::memory_order_relaxed);
+        copiedBytes.fetch_add(count * sizeof(Substitution), std::memory_order_relaxed);
+    }
 }
 
-void Environment::insert(Environment::const_iterator b, Environment::const_iterator e) {
-    std::for_each(b, e, [=](const Substitution& p) { insert(p); });
+bool Environment::isShared() const {
+    return _size > InlineCapacity;
 }
 
-Environment::iterator Environment::begin() {
-    return _subs.begin();
+const Environment::Substitution* Environment::data() const {
+    return isShared() ? _block->subs() : _inline;
 }
 
-Environment::const_iterator Environment::begin() const {
-    return _subs.begin();
+Environment::Substitution* Environment::makeUnique(size_t capacity) {
+    if (isShared()) {
+        if (_block->refCount == 1 && _block->capacity >= capacity) {
+            // the block is about to change: its last composition is not valid anymore
+            _block->forgetComposition();
+            return _block->subs();
+        }
+    } else if (capacity <= InlineCapacity) {
+        return _inline;
+    }
+
+    Block* block = Block::allocate(capacity > _size ? std::max(capacity, 2 * _size) : capacity);
+    std::uninitialized_copy(begin(), end(), block->subs());
+
+    if (isShared() && _block->refCount > 1) {
+        accountCopy(_size);
+    }
+
+    assignBlock(block);
+    return block->subs();
 }
 
-Environment::iterator Environment::end() {
-    return _subs.end();
+void Environment::assignBlock(Block* block) {
+    if (isShared()) {
+        Block::release(_block);
+    }
+    _block = block;
 }
 
-Environment::const_iterator Environment::end() const {
-    return _subs.end();
+void Environment::release() {
+    if (isShared()) {
+        Block::release(_block);
+    }
+    _size = 0;
 }
 
-Type*& Environment::operator [](Type* key) {
-    iterator it = find(key);
-    if (it != end()) {
-        return it->value;
-    } else {
-        return insert(Substitution(common::VAR_T_NONE, key, nullptr))->value;
+bool Environment::empty() const {
+    return _size == 0;
+}
+
+size_t Environment::size() const {
+    return _size;
+}
+
+void Environment::insert(const Environment::Substitution& p) {
+    size_t pos = std::lower_bound(begin(), end(), p, keyLess) - begin();
+    Substitution* subs = makeUnique(_size + 1);
+    std::copy_backward(subs + pos, subs + _size, subs + _size + 1);
+    subs[pos] = p;
+    ++_size;
+}
+
+void Environment::insert(Environment::const_iterator b, Environment::const_iterator e) {
+    for (; b != e; ++b) {
+        insert(*b);
     }
 }
 
-Environment::iterator Environment::find(const Type* key) {
-    for (size_t i = 0, e = _subs.size(); i < e; ++i) {
-        if (_subs[i].key == key) {
-            return begin() + i;
-        }
+Environment::const_iterator Environment::begin() const {
+    return data();
+}
+
+Environment::const_iterator Environment::end() const {
+    return data() + _size;
+}
+
+Type*& Environment::operator [](Type* key) {
+    const_iterator it = find(key);
+    if (it == end()) {
+        insert(Substitution(common::VAR_T_NONE, key, nullptr));
+        it = find(key);
     }
-    return end();
+    size_t pos = it - begin();
+    return makeUnique(_size)[pos].value;
 }
 
 Environment::const_iterator Environment::find(const Type* key) const {
-    for (size_t i = 0, e = _subs.size(); i < e; ++i) {
-        if (_subs[i].key == key) {
-            return begin() + i;
+    const_iterator b = begin(), e = end();
+    if (_size <= 8) {
+        for (; b != e; ++b) {
+            if (b->key == key) {
+                return b;
+            }
         }
+        return e;
     }
-    return end();
+
+    const_iterator it = std::lower_bound(b, e, Substitution(common::VAR_T_NONE, const_cast<Type*>(key), nullptr), keyLess);
+    return (it != e && it->key == key) ? it : e;
 }
 
 Type* Environment::findSubstOrReturnMe(Type* toFind, bool* found) const {
@@ -109,12 +302,65 @@ Type* Environment::findSubstOrReturnMe(Type* toFind, bool* found) const {
 }
 
 bool Environment::substituteAll(const Environment& env) {
+    if (empty() || env.empty()) {
+        return false;
+    }
+
+    Block* source = nullptr;
+
+    if (isShared()) {
+        if (_block->hasComposedWith(env)) {
+            bool matched = _block->composedMatched;
+            if (Block* result = _block->composedResult) {
+                ++result->refCount;
+                assignBlock(result);
+            }
+            return matched;
+        }
+        source = _block;
+    }
+
+    // look for the first value that actually changes before writing anything,
+    // so that a shared block is only duplicated when needed
+    const Substitution* subs = data();
     bool matched = false;
-    for (auto& pair : _subs) {
-        bool tmp;
-        pair.value = env.findSubstOrReturnMe(pair.value, &tmp);
-        matched |= tmp;
+    Type* value = nullptr;
+    size_t i = 0;
+
+    for (; i < _size; ++i) {
+        bool found;
+        value = env.findSubstOrReturnMe(subs[i].value, &found);
+        matched |= found;
+        if (value != subs[i].value) {
+            break;
+        }
+    }
+
+    if (i == _size) {
+        if (source) {
+            source->remember(env, nullptr, matched);
+        }
+        return matched;
+    }
+
+    // the source survives its duplication only if another environment refers to it
+    if (source && source->refCount == 1) {
+        source = nullptr;
+    }
+
+    Substitution* out = makeUnique(_size);
+    out[i].value = value;
+
+    for (++i; i < _size; ++i) {
+        bool found;
+        out[i].value = env.findSubstOrReturnMe(out[i].value, &found);
+        matched |= found;
     }
+
+    if (source) {
+        source->remember(env, _block, matched);
+    }
+
     return matched;
 }
 
@@ -124,10 +370,6 @@ std::string Environment::toString() const {
     }) + "}";
 }
 
-bool Environment::SubstitutionComparator::operator ()(const Environment::Substitution& a, const Environment::Substitution& b) const {
-    return a.key < b.key;
-}
-
 }
 
 }
@@ -9,9 +9,9 @@
 #ifndef __SFSL__SubstitutionTable__
 #define __SFSL__SubstitutionTable__
 
-#include <vector>
-#include <map>
+#include <string>
 #include "../Common/Miscellaneous.h"
+#include "../../Common/MemoryStats.h"
 
 namespace sfsl {
 
@@ -20,7 +20,16 @@ namespace type {
 class Type;
 
 /**
- * @brief
+ * @brief A persistent sorted map from type parameters to the types they are substituted with.
+ *
+ * Environments of at most #InlineCapacity substitutions are stored inline. Larger ones are
+ * kept in reference counted blocks which are shared between copies and only duplicated when
+ * a shared environment gets modified, so that copying an environment into a type or a symbol
+ * costs a pointer copy. Blocks belong to the compilation that created them and must not be
+ * shared across threads.
+ *
+ * The substitutions are sorted by key. Several substitutions may have the same key, in which
+ * case the one inserted last is found first.
  */
 class Environment final {
 public:
@@ -33,44 +42,72 @@ public:
         Type* value;
     };
 
-    typedef std::vector<Substitution>::iterator iterator;
-    typedef std::vector<Substitution>::const_iterator const_iterator;
+    typedef const Substitution* const_iterator;
 
     Environment();
+    Environment(const Environment& other);
+    Environment(Environment&& other);
     ~Environment();
 
+    Environment& operator =(const Environment& other);
+    Environment& operator =(Environment&& other);
+
     bool empty() const;
     size_t size() const;
 
-    iterator insert(const Substitution& p);
+    void insert(const Substitution& p);
     void insert(const_iterator b, const_iterator e);
 
-    iterator begin();
     const_iterator begin() const;
-
-    iterator end();
     const_iterator end() const;
 
     Type*& operator [](Type* key);
-    iterator find(const Type* key);
     const_iterator find(const Type* key) const;
     Type* findSubstOrReturnMe(Type* toFind, bool* found = nullptr) const;
 
+    /**
+     * @brief Replaces the value of each substitution by its substitution in the given environment.
+     * A block remembers the result of its last substitution with a small environment, so
+     * that substituting it again with the same substitutions only costs a pointer copy.
+     *
+     * @param env The environment to take the substitutions from
+     * @return True if any value was found in the given environment
+     */
     bool substituteAll(const Environment& env);
 
     std::string toString() const;
 
     static const Environment Empty;
 
+    /**
+     * @return The number of copies of non empty environments made so far
+     * in the process, and the size of the substitutions they copied. Only the
+     * duplications of shared blocks are accounted: other copies either share
+     * the block or are stored inline.
+     */
+    static common::MemoryUsage getCopyStats();
+
 private:
 
-    struct SubstitutionComparator final {
-        bool operator ()(const Substitution& a, const Substitution& b) const;
-    };
+    struct Block;
+
+    static constexpr size_t InlineCapacity = 2;
 
-    static SubstitutionComparator Comparator;
+    bool isShared() const;
+    const Substitution* data() const;
 
-    std::vector<Substitution> _subs;
+    Substitution* makeUnique(size_t capacity);
+    void assignBlock(Block* block);
+    void release();
+
+    static void accountCopy(size_t count);
+
+    size_t _size;
+
+    union {
+        Substitution _inline[InlineCapacity];
+        Block* _block;
+    };
 };
 
 }
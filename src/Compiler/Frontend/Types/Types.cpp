@@ -7,6 +7,7 @@
 //
 
 #include "Types.h"
+#include <algorithm>
 #include "../AST/Nodes/TypeExpressions.h"
 #include "../AST/Nodes/KindExpressions.h"
 
@@ -16,6 +17,7 @@
 #include "../AST/Visitors/ASTKindCreator.h"
 
 #define DEFAULT_GENERIC_TYPE_HOLDER_ENTRY_NAME "DefaultGenericTypeHolder@sfsl::type::DefaultGenericType"
+#define TYPE_TABLE_ENTRY_NAME "TypeTable@sfsl::type::TypeTable"
 
 namespace sfsl {
 
@@ -25,7 +27,7 @@ bool envsEqual(const Environment& env1, const Environment& env2, CompCtx_Ptr& ct
     for (Environment::const_iterator env1It = env1.begin(), env2It = env2.begin(), env1End = env1.end();
          env1It != env1End; ++env1It, ++env2It) {
 
-        if (!env1It->value->apply(ctx)->equals(env2It->value->apply(ctx), ctx)) {
+        if (env1It->value != env2It->value && !env1It->value->apply(ctx)->equals(env2It->value->apply(ctx), ctx)) {
             return false;
         }
     }
@@ -154,6 +156,130 @@ Type* Type::DefaultGenericType(ast::TypeExpression* tpe, CompCtx_Ptr& ctx) {
     return res;
 }
 
+// TYPE TABLE
+
+/**
+ * @brief Hash-conses the types of a compilation: the types which are built from the same
+ * parts (kind, class or type constructor, substitutions, type arguments and argument types)
+ * are the same instance, so they can be compared by address and share the results of apply.
+ * The parts are compared by address too, so this holds recursively.
+ */
+struct TypeTable final : public common::MemoryManageable {
+    static const common::MEMORY_CATEGORY MemoryCategory = common::MEM_TYPE;
+
+    TypeTable() : _size(0) { }
+
+    virtual ~TypeTable() { }
+
+    TypeTable& startKey(TYPE_KIND kind, const void* head) {
+        _key.clear();
+        _key.push_back(kind);
+        return add(head);
+    }
+
+    TypeTable& add(const Environment& env) {
+        _key.push_back(env.size());
+        for (const Environment::Substitution& sub : env) {
+            _key.push_back(sub.varianceType);
+            add(sub.key);
+            add(sub.value);
+        }
+        return *this;
+    }
+
+    template<typename T>
+    TypeTable& add(const std::vector<T*>& parts) {
+        _key.push_back(parts.size());
+        for (T* part : parts) {
+            add(part);
+        }
+        return *this;
+    }
+
+    TypeTable& add(const void* part) {
+        _key.push_back(reinterpret_cast<uintptr_t>(part));
+        return *this;
+    }
+
+    template<typename T, typename... Args>
+    T* get(CompCtx_Ptr& ctx, Args... args) {
+        // keep the load factor under 1/2
+        if ((_size + 1) * 2 > _slots.size()) {
+            grow();
+        }
+
+        size_t hash = hashOf(_key.data(), _key.size());
+        Slot& slot = _slots[indexOf(hash, _key.data(), _key.size())];
+
+        if (!slot.type) {
+            slot.hash = hash;
+            slot.keyOffset = _keys.size();
+            slot.keySize = _key.size();
+            slot.type = ctx->memoryManager().New<T>(args...);
+            _keys.insert(_keys.end(), _key.begin(), _key.end());
+            ++_size;
+        }
+
+        return static_cast<T*>(slot.type);
+    }
+
+    static TypeTable* get(CompCtx_Ptr& ctx) {
+        return ctx->retrieveContextUserData<TypeTable>(TYPE_TABLE_ENTRY_NAME);
+    }
+
+private:
+
+    struct Slot final {
+        Slot() : hash(0), keyOffset(0), keySize(0), type(nullptr) { }
+
+        size_t hash;
+        size_t keyOffset;
+        size_t keySize;
+        Type* type;
+    };
+
+    static size_t hashOf(const uintptr_t* key, size_t size) {
+        size_t hash = 14695981039346656037ULL;
+        for (size_t i = 0; i < size; ++i) {
+            hash = (hash ^ key[i]) * 1099511628211ULL;
+        }
+        return hash ^ (hash >> 29);
+    }
+
+    size_t indexOf(size_t hash, const uintptr_t* key, size_t size) const {
+        size_t mask = _slots.size() - 1;
+        size_t i = hash & mask;
+
+        while (_slots[i].type && (_slots[i].hash != hash || _slots[i].keySize != size ||
+                                  !std::equal(key, key + size, _keys.begin() + _slots[i].keyOffset))) {
+            i = (i + 1) & mask;
+        }
+
+        return i;
+    }
+
+    void grow() {
+        std::vector<Slot> slots(_slots.empty() ? 256 : _slots.size() * 2);
+        slots.swap(_slots);
+
+        size_t mask = _slots.size() - 1;
+        for (const Slot& slot : slots) {
+            if (slot.type) {
+                size_t i = slot.hash & mask;
+                while (_slots[i].type) {
+                    i = (i + 1) & mask;
+                }
+                _slots[i] = slot;
+            }
+        }
+    }
+
+    std::vector<uintptr_t> _key;
+    std::vector<uintptr_t> _keys; // the keys of all the types, one after the other
+    std::vector<Slot> _slots;
+    size_t _size;
+};
+
 // TYPE MUST BE INFERRED
 
 TypeToBeInferred::TypeToBeInferred(const std::vector<Typed*>& associatedTyped) : _associatedTyped(associatedTyped) {
@@ -206,6 +332,10 @@ ProperType::~ProperType() {
 TYPE_KIND ProperType::getTypeKind() const { return TYPE_PROPER; }
 
 bool ProperType::isSubTypeOf(const Type* other, CompCtx_Ptr& ctx) const {
+    if (this == other) {
+        return true;
+    }
+
     if (ProperType* objother = getIf<ProperType>(other)) {
         const Environment& osubs = objother->getEnvironment();
 
@@ -238,6 +368,10 @@ bool ProperType::isSubTypeOf(const Type* other, CompCtx_Ptr& ctx) const {
 }
 
 bool ProperType::equals(const Type* other, CompCtx_Ptr& ctx) const {
+    if (this == other) {
+        return true;
+    }
+
     if (ProperType* objother = getIf<ProperType>(other)) {
         if (_class == objother->getClass()) {
             return envsEqual(_env, objother->getEnvironment(), ctx);
@@ -253,7 +387,7 @@ std::string ProperType::toString(CompCtx_Ptr* shouldApply) const {
 ProperType* ProperType::substituteDeep(const Environment& env, CompCtx_Ptr& ctx) const {
     Environment copy = _env;
     if (copy.substituteAll(env)) {
-        return ctx->memoryManager().New<ProperType>(_class, copy);
+        return create(_class, copy, ctx);
     } else {
         return const_cast<ProperType*>(this);
     }
@@ -263,6 +397,10 @@ ast::ClassDecl* ProperType::getClass() const {
     return _class;
 }
 
+ProperType* ProperType::create(ast::ClassDecl* clss, const Environment& substitutionTable, CompCtx_Ptr& ctx) {
+    return TypeTable::get(ctx)->startKey(TYPE_PROPER, clss).add(substitutionTable).get<ProperType>(ctx, clss, substitutionTable);
+}
+
 // VALUE CONSTRUCTOR TYPE
 
 ValueConstructorType::ValueConstructorType(const std::vector<ast::TypeExpression*>& typeArgs,
@@ -276,6 +414,10 @@ ValueConstructorType::~ValueConstructorType() {
 }
 
 bool ValueConstructorType::isSubTypeOfValueConstructor(const ValueConstructorType* other, CompCtx_Ptr& ctx) const {
+    if (this == other) {
+        return true;
+    }
+
     const std::vector<ast::TypeExpression*>& oTypeArgs = other->getTypeArgs();
     const std::vector<Type*>& oArgTypes = other->getArgTypes();
     const Type* oRetType = other->getRetType();
@@ -301,6 +443,10 @@ bool ValueConstructorType::isSubTypeOfValueConstructor(const ValueConstructorTyp
 }
 
 bool ValueConstructorType::equalsValueConstructor(const ValueConstructorType* other, CompCtx_Ptr& ctx) const {
+    if (this == other) {
+        return true;
+    }
+
     const std::vector<ast::TypeExpression*>& oTypeArgs = other->getTypeArgs();
     const std::vector<Type*>& oArgTypes = other->getArgTypes();
     const Type* oRetType = other->getRetType();
@@ -440,13 +586,19 @@ FunctionType* FunctionType::rebuildValueConstructor(
         const std::vector<Type*>& argTypes, Type* retType,
         const Environment& substitutionTable,
         CompCtx_Ptr& ctx) const {
-    return ctx->memoryManager().New<FunctionType>(typeArgs, argTypes, retType, _class, substitutionTable);
+    return create(typeArgs, argTypes, retType, _class, substitutionTable, ctx);
 }
 
 const Environment& FunctionType::getValueConstructorEnvironment() const {
     return _env;
 }
 
+FunctionType* FunctionType::create(const std::vector<ast::TypeExpression*>& typeArgs, const std::vector<Type*>& argTypes, Type* retType,
+                                   ast::ClassDecl* clss, const Environment& substitutionTable, CompCtx_Ptr& ctx) {
+    return TypeTable::get(ctx)->startKey(TYPE_FUNCTION, clss).add(substitutionTable).add(typeArgs).add(argTypes).add(retType)
+            .get<FunctionType>(ctx, typeArgs, argTypes, retType, clss, substitutionTable);
+}
+
 // METHOD TYPE
 
 MethodType::MethodType(ast::ClassDecl* owner,
@@ -512,7 +664,7 @@ MethodType* MethodType::rebuildValueConstructor(
         const std::vector<Type*>& argTypes, Type* retType,
         const Environment& substitutionTable,
         CompCtx_Ptr& ctx) const {
-    return ctx->memoryManager().New<MethodType>(_owner, typeArgs, argTypes, retType, substitutionTable);
+    return create(_owner, typeArgs, argTypes, retType, substitutionTable, ctx);
 }
 
 ast::ClassDecl* MethodType::getOwner() const {
@@ -520,7 +672,13 @@ ast::ClassDecl* MethodType::getOwner() const {
 }
 
 MethodType* MethodType::fromFunctionType(const FunctionType* ft, ast::ClassDecl* owner, CompCtx_Ptr& ctx) {
-    return ctx->memoryManager().New<MethodType>(owner, ft->getTypeArgs(), ft->getArgTypes(), ft->getRetType(), ft->getEnvironment());
+    return create(owner, ft->getTypeArgs(), ft->getArgTypes(), ft->getRetType(), ft->getEnvironment(), ctx);
+}
+
+MethodType* MethodType::create(ast::ClassDecl* owner, const std::vector<ast::TypeExpression*>& typeArgs, const std::vector<Type*>& argTypes,
+                               Type* retType, const Environment& substitutionTable, CompCtx_Ptr& ctx) {
+    return TypeTable::get(ctx)->startKey(TYPE_METHOD, owner).add(substitutionTable).add(typeArgs).add(argTypes).add(retType)
+            .get<MethodType>(ctx, owner, typeArgs, argTypes, retType, substitutionTable);
 }
 
 const Environment& MethodType::getValueConstructorEnvironment() const {
@@ -547,6 +705,10 @@ bool TypeConstructorType::isSubTypeOf(const Type* other, CompCtx_Ptr& ctx) const
 }
 
 bool TypeConstructorType::equals(const Type* other, CompCtx_Ptr& ctx) const {
+    if (this == other) {
+        return true;
+    }
+
     if (TypeConstructorType* tc = getIf<TypeConstructorType>(other)) {
         return _typeConstructor == tc->getTypeConstructor()
             && envsEqual(_env, tc->getEnvironment(), ctx);
@@ -561,7 +723,7 @@ std::string TypeConstructorType::toString(CompCtx_Ptr* shouldApply) const {
 TypeConstructorType* TypeConstructorType::substituteDeep(const Environment& env, CompCtx_Ptr& ctx) const {
     Environment copy = _env;
     if (copy.substituteAll(env)) {
-        return ctx->memoryManager().New<TypeConstructorType>(_typeConstructor, copy);
+        return create(_typeConstructor, copy, ctx);
     } else {
         return const_cast<TypeConstructorType*>(this);
     }
@@ -571,6 +733,11 @@ ast::TypeConstructorCreation* TypeConstructorType::getTypeConstructor() const {
     return _typeConstructor;
 }
 
+TypeConstructorType* TypeConstructorType::create(ast::TypeConstructorCreation* typeConstructor, const Environment& substitutionTable, CompCtx_Ptr& ctx) {
+    return TypeTable::get(ctx)->startKey(TYPE_CONSTRUCTOR_TYPE, typeConstructor).add(substitutionTable)
+            .get<TypeConstructorType>(ctx, typeConstructor, substitutionTable);
+}
+
 // CONSTRUCTOR APPLY TYPE
 
 ConstructorApplyType::ConstructorApplyType(Type* callee, const std::vector<Type*>& args)
@@ -611,7 +778,7 @@ ConstructorApplyType* ConstructorApplyType::substituteDeep(const Environment& en
         substitued[i] = _args[i]->substitute(env, ctx);
     }
 
-    return ctx->memoryManager().New<ConstructorApplyType>(_callee->substitute(env, ctx), substitued);
+    return create(_callee->substitute(env, ctx), substitued, ctx);
 }
 
 Type* ConstructorApplyType::apply(CompCtx_Ptr& ctx) const {
@@ -638,6 +805,10 @@ const std::vector<Type*>& ConstructorApplyType::getArgs() {
     return _args;
 }
 
+ConstructorApplyType* ConstructorApplyType::create(Type* callee, const std::vector<Type*>& args, CompCtx_Ptr& ctx) {
+    return TypeTable::get(ctx)->startKey(TYPE_CONSTRUCTOR_APPLY, callee).add(args).get<ConstructorApplyType>(ctx, callee, args);
+}
+
 // TYPED
 
 Typed::Typed() : _type(Type::NotYetDefined()) {
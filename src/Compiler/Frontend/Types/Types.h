@@ -33,6 +33,8 @@ class Typed;
 
 class Type : public common::MemoryManageable {
 public:
+    static const common::MEMORY_CATEGORY MemoryCategory = common::MEM_TYPE;
+
     Type(const Environment& substitutionTable = {});
 
     virtual ~Type();
@@ -95,6 +97,8 @@ public:
 
     ast::ClassDecl* getClass() const;
 
+    static ProperType* create(ast::ClassDecl* clss, const Environment& substitutionTable, CompCtx_Ptr& ctx);
+
 protected:
 
     virtual ProperType* substituteDeep(const Environment& env, CompCtx_Ptr& ctx) const override;
@@ -155,6 +159,9 @@ public:
             const Environment& substitutionTable,
             CompCtx_Ptr& ctx) const override;
 
+    static FunctionType* create(const std::vector<ast::TypeExpression*>& typeArgs, const std::vector<Type*>& argTypes, Type* retType,
+                                ast::ClassDecl* clss, const Environment& substitutionTable, CompCtx_Ptr& ctx);
+
 protected:
 
     virtual FunctionType* substituteDeep(const Environment& env, CompCtx_Ptr& ctx) const override;
@@ -184,6 +191,9 @@ public:
 
     static MethodType* fromFunctionType(const FunctionType* ft, ast::ClassDecl* owner, CompCtx_Ptr& ctx);
 
+    static MethodType* create(ast::ClassDecl* owner, const std::vector<ast::TypeExpression*>& typeArgs, const std::vector<Type*>& argTypes,
+                              Type* retType, const Environment& substitutionTable, CompCtx_Ptr& ctx);
+
 protected:
 
     virtual MethodType* substituteDeep(const Environment& env, CompCtx_Ptr& ctx) const override;
@@ -207,6 +217,8 @@ public:
 
     ast::TypeConstructorCreation* getTypeConstructor() const;
 
+    static TypeConstructorType* create(ast::TypeConstructorCreation* typeConstructor, const Environment& substitutionTable, CompCtx_Ptr& ctx);
+
 protected:
 
     virtual TypeConstructorType* substituteDeep(const Environment& env, CompCtx_Ptr& ctx) const override;
@@ -230,6 +242,8 @@ public:
     Type* getCallee() const;
     const std::vector<Type*>& getArgs();
 
+    static ConstructorApplyType* create(Type* callee, const std::vector<Type*>& args, CompCtx_Ptr& ctx);
+
 protected:
 
     virtual ConstructorApplyType* substituteDeep(const Environment& env, CompCtx_Ptr& ctx) const override;
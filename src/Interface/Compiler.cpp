@@ -7,6 +7,9 @@
 //
 
 #include <ctime>
+#include <thread>
+#include <atomic>
+#include <exception>
 
 #include "api/Compiler.h"
 #include "api/Errors.h"
@@ -25,6 +28,7 @@
 #include "Compiler/Backend/BytecodeGenerator.h"
 
 #include "Compiler/Frontend/Symbols/Scope.h"
+#include "Compiler/Frontend/Symbols/ResolutionCache.h"
 
 #include "PhaseGraph.h"
 
@@ -53,6 +57,10 @@
 
 #ifdef USER_API_PLUGIN_FEATURE
 
+#ifndef _WIN32
+#define __stdcall
+#endif
+
 typedef void (__stdcall *CompilePass)(sfsl::ProgramBuilder, sfsl::Pipeline&, const std::vector<std::string>&);
 
 #ifdef _WIN32
@@ -82,7 +90,11 @@ typedef void* DLLHandle;
 typedef void* FuncPtr;
 
 DLLHandle loadDll(const std::string& path) {
-    return dlopen(path.c_str(), RTLD_LAZY);
+    if (DLLHandle handle = dlopen(path.c_str(), RTLD_LAZY)) {
+        return handle;
+    }
+    // mimic LoadLibrary, which appends the default extension
+    return dlopen((path + ".so").c_str(), RTLD_LAZY);
 }
 
 FuncPtr getSymbol(DLLHandle handle, const std::string& sym) {
@@ -118,16 +130,24 @@ class COMPILER_IMPL_NAME final {
 public:
     COMPILER_IMPL_NAME(const CompilerConfig& config) : config(config) {
         AbstractReporter* reporter = nullptr;
-        size_t initialChunkSize = 2048;
+        common::ChunkPolicy policy;
 
-        config.get<opt::InitialChunkSize>(initialChunkSize);
+        config.get<opt::InitialChunkSize>(policy.initialChunkSize);
+        config.get<opt::MaxChunkSize>(policy.maxChunkSize);
+        config.get<opt::ChunkGrowthFactor>(policy.growthFactor);
+        config.get<opt::LargeObjectSize>(policy.largeObjectSize);
+
+        if (policy.initialChunkSize == 0 || policy.growthFactor == 0 || policy.maxChunkSize < policy.initialChunkSize) {
+            throw CompileError("Invalid memory options: chunk sizes and growth factor must be positive, "
+                               "and the maximum chunk size must be at least the initial one");
+        }
 
         if (config.get<opt::Reporter>(reporter)) {
             ctx = common::CompilationContext::CustomReporterCompilationContext(
-                        initialChunkSize,
+                        policy,
                         std::unique_ptr<ReporterAdapter>(new ReporterAdapter(reporter)));
         } else {
-            ctx = common::CompilationContext::DefaultCompilationContext(initialChunkSize);
+            ctx = common::CompilationContext::DefaultCompilationContext(policy);
         }
 
         if (!config.get<opt::PrimitiveNamer>(namer)) {
@@ -222,11 +242,12 @@ public:
 
 class MODULE_IMPL_NAME final : public ModuleContainer {
 public:
-    MODULE_IMPL_NAME(common::AbstractMemoryManager& mngr, const std::string& name) : mngr(mngr), _name(name) { }
+    MODULE_IMPL_NAME(common::AbstractMemoryManager& mngr, common::NameTable& names, const std::string& name)
+        : mngr(mngr), names(names), _name(name) { }
     virtual ~MODULE_IMPL_NAME() { }
 
     virtual Module createProxyModule(const std::string& name) const {
-        return Module(NEW_MODULE_IMPL(mngr, name));
+        return Module(NEW_MODULE_IMPL(mngr, names, name));
     }
 
     virtual ast::ModuleDecl* buildModule(Module m) {
@@ -234,7 +255,7 @@ public:
     }
 
     ast::ModuleDecl* closeModule() {
-        return mngr.New<ast::ModuleDecl>(mngr.New<ast::Identifier>(_name), closeContainer(mngr), _tdecls, _ddecls);
+        return mngr.New<ast::ModuleDecl>(mngr.New<ast::Identifier>(names.intern(_name)), closeContainer(mngr), _tdecls, _ddecls);
     }
 
     void externDef(const std::string& defName, Type defType) {
@@ -242,7 +263,7 @@ public:
             throw CompileError("Type of definition was not valid");
         }
 
-        ast::Identifier* nameId = mngr.New<ast::Identifier>(defName);
+        ast::Identifier* nameId = mngr.New<ast::Identifier>(names.intern(defName));
         _ddecls.push_back(mngr.New<ast::DefineDecl>(nameId, defType._impl->_type, nullptr, ast::DefFlags::EXTERN));
     }
 
@@ -251,10 +272,11 @@ public:
             throw CompileError("Type to typedef was not valid");
         }
 
-        _tdecls.push_back(mngr.New<ast::TypeDecl>(mngr.New<ast::TypeIdentifier>(name), type._impl->_type, isExtern));
+        _tdecls.push_back(mngr.New<ast::TypeDecl>(mngr.New<ast::TypeIdentifier>(names.intern(name)), type._impl->_type, isExtern));
     }
 
     common::AbstractMemoryManager& mngr;
+    common::NameTable& names;
 
     const std::string _name;
     std::vector<ast::TypeDecl*> _tdecls;
@@ -269,7 +291,7 @@ public:
     virtual ~PROGRAMBUILDER_IMPL_NAME() { }
 
     virtual Module createProxyModule(const std::string& name) const {
-        return Module(NEW_MODULE_IMPL(mngr, name));
+        return Module(NEW_MODULE_IMPL(mngr, cmp->ctx->names(), name));
     }
 
     virtual ast::ModuleDecl* buildModule(Module m) {
@@ -297,8 +319,8 @@ public:
 
 class CLASSBUILDER_IMPL_NAME final {
 public:
-    CLASSBUILDER_IMPL_NAME(common::AbstractMemoryManager& mngr, const std::string& name)
-        : _mngr(mngr), _name(name), _isAbstract(false) { }
+    CLASSBUILDER_IMPL_NAME(common::AbstractMemoryManager& mngr, common::NameTable& names, const std::string& name)
+        : _mngr(mngr), _names(names), _name(name), _isAbstract(false) { }
 
     ~CLASSBUILDER_IMPL_NAME() { }
 
@@ -311,7 +333,7 @@ public:
             throw CompileError("Type of field was not valid");
         }
 
-        ast::Identifier* id = _mngr.New<ast::Identifier>(fieldName);
+        ast::Identifier* id = _mngr.New<ast::Identifier>(_names.intern(fieldName));
         ast::TypeExpression* tpe = fieldType._impl->_type;
         _fields.push_back(_mngr.New<ast::TypeSpecifier>(id, tpe));
     }
@@ -321,7 +343,7 @@ public:
             throw CompileError("Type of definition was not valid");
         }
 
-        ast::Identifier* id = _mngr.New<ast::Identifier>(defName);
+        ast::Identifier* id = _mngr.New<ast::Identifier>(_names.intern(defName));
         ast::TypeExpression* tpe = defType._impl->_type;
         _defs.push_back(_mngr.New<ast::DefineDecl>(id, tpe, nullptr, flags));
     }
@@ -339,6 +361,7 @@ public:
 private:
 
     common::AbstractMemoryManager& _mngr;
+    common::NameTable& _names;
 
     std::string _name;
     bool _isAbstract;
@@ -349,8 +372,8 @@ private:
 
 class TCBUILDER_IMPL_NAME final {
 public:
-    TCBUILDER_IMPL_NAME(common::AbstractMemoryManager& mngr, const std::string& name)
-        : _mngr(mngr), _name(name) { }
+    TCBUILDER_IMPL_NAME(common::AbstractMemoryManager& mngr, common::NameTable& names, const std::string& name)
+        : _mngr(mngr), _names(names), _name(name) { }
 
     ~TCBUILDER_IMPL_NAME() { }
 
@@ -377,7 +400,7 @@ public:
             case TypeConstructorBuilder::Parameter::V_NONE: vt = common::VAR_T_NONE; break;
             }
 
-            ast::TypeIdentifier* id = _mngr.New<ast::TypeIdentifier>(_params[i].getName());
+            ast::TypeIdentifier* id = _mngr.New<ast::TypeIdentifier>(_names.intern(_params[i].getName()));
             ast::KindSpecifyingExpression* kd = _mngr.New<ast::ProperTypeKindSpecifier>();
 
             params[i] = _mngr.New<ast::TypeParameter>(vt, id, kd);
@@ -396,6 +419,7 @@ public:
 private:
 
     common::AbstractMemoryManager& _mngr;
+    common::NameTable& _names;
 
     std::string _name;
 
@@ -425,16 +449,72 @@ void Compiler::unloadPlugin(const std::string& pathToPluginDll) {
     _impl->unloadPlugin(pathToPluginDll);
 }
 
+static ast::Program* parseSource(const COMPILER_IMPL_PTR& impl, src::SpanSource& source) {
+    common::MemoryStats memoryBefore(impl->ctx->memoryStats());
+
+    lex::Lexer lexer(impl->ctx->reporter(), impl->ctx->names(), source);
+    ast::Parser parser(impl->ctx, lexer, impl->namer);
+    ast::Program* program = parser.parse();
+
+    impl->ctx->recordPhaseMemory("Parsing", impl->ctx->memoryStats() - memoryBefore);
+
+    return impl->ctx->reporter().getErrorCount() == 0 ? program : nullptr;
+}
+
+static void parseSourceByModule(const COMPILER_IMPL_PTR& impl, src::SpanSource& source,
+                                const std::function<void(ast::Program*)>& onProgram) {
+    common::MemoryStats memoryBefore(impl->ctx->memoryStats());
+    common::AbstractMemoryManager& mngr(impl->ctx->memoryManager());
+    common::AbstractReporter& rep(impl->ctx->reporter());
+
+    // tokens are only kept in the lookahead window of the lexer, so
+    // the memory they take does not grow with the size of the source
+    lex::Lexer lexer(rep, impl->ctx->names(), source);
+    ast::Parser parser(impl->ctx, lexer, impl->namer);
+    size_t errorCount = rep.getErrorCount();
+
+    parser.parseModules([&](ast::ModuleDecl* module) {
+        if (rep.getErrorCount() == errorCount) {
+            ast::Program* program = mngr.New<ast::Program>(std::vector<ast::ModuleDecl*>{module});
+            program->setPos(*module);
+            onProgram(program);
+        } else {
+            errorCount = rep.getErrorCount();
+            onProgram(nullptr);
+        }
+    });
+
+    if (rep.getErrorCount() != errorCount) {
+        // syntax errors after the last module, e.g. stray tokens at the end of the source
+        onProgram(nullptr);
+    }
+
+    impl->ctx->recordPhaseMemory("Parsing", impl->ctx->memoryStats() - memoryBefore);
+}
+
 ProgramBuilder Compiler::parse(const std::string& srcName, const std::string& srcContent) {
+    return parse(srcName, srcContent.data(), srcContent.size());
+}
+
+ProgramBuilder Compiler::parse(const std::string& srcName, const char* srcContent, size_t srcSize) {
     try {
-        common::ChunkedMemoryManager lexerMemMngr(srcContent.size() * sizeof(tok::Identifier) / 3 + 40); // random heuristic :D
+        src::SpanSource source(src::InputSourceName::make(_impl->ctx, srcName), srcContent, srcSize);
 
-        src::StringSource source(src::InputSourceName::make(_impl->ctx, srcName), srcContent);
-        lex::Lexer lexer(lexerMemMngr, _impl->ctx->reporter(), source);
-        ast::Parser parser(_impl->ctx, lexer, _impl->namer);
-        ast::Program* program = parser.parse();
+        if (ast::Program* program = parseSource(_impl, source)) {
+            return ProgramBuilder(NEW_PROGRAMBUILDER_IMPL(_impl, program));
+        } else {
+            return MAKE_INVALID(ProgramBuilder);
+        }
+    } catch (const common::CompilationFatalError& err) {
+        throw CompileError(err.what());
+    }
+}
 
-        if (_impl->ctx->reporter().getErrorCount() == 0) {
+ProgramBuilder Compiler::parseFile(const std::string& srcPath) {
+    try {
+        src::MappedFileSource source(src::InputSourceName::make(_impl->ctx, srcPath), srcPath);
+
+        if (ast::Program* program = parseSource(_impl, source)) {
             return ProgramBuilder(NEW_PROGRAMBUILDER_IMPL(_impl, program));
         } else {
             return MAKE_INVALID(ProgramBuilder);
@@ -444,6 +524,115 @@ ProgramBuilder Compiler::parse(const std::string& srcName, const std::string& sr
     }
 }
 
+ProgramBuilder Compiler::parseFiles(const std::vector<std::string>& srcPaths) {
+    struct ParsedFile final {
+        common::BufferedReporter rep;
+        ast::Program* program;
+        std::exception_ptr error;
+    };
+
+    CompCtx_Ptr ctx(_impl->ctx);
+    const common::AbstractPrimitiveNamer* namer = _impl->namer;
+    common::MemoryStats memoryBefore(ctx->memoryStats());
+
+    std::vector<ParsedFile> files(srcPaths.size());
+    std::atomic<size_t> nextFile(0);
+
+    // each file is lexed and parsed on its own, and its messages are kept aside
+    // so that they can be reported in the order of the files once all are parsed
+    auto parseNextFiles = [&]() {
+        CompCtx_Ptr workerCtx(ctx);
+
+        for (size_t i; (i = nextFile++) < srcPaths.size();) {
+            ParsedFile& file(files[i]);
+            file.program = nullptr;
+
+            try {
+                src::MappedFileSource source(src::InputSourceName::make(workerCtx, srcPaths[i]), srcPaths[i]);
+                lex::Lexer lexer(file.rep, workerCtx->names(), source);
+                ast::Parser parser(workerCtx, file.rep, lexer, namer);
+                file.program = parser.parse();
+            } catch (...) {
+                file.error = std::current_exception();
+            }
+        }
+    };
+
+    size_t threadCount = std::min<size_t>(std::max(std::thread::hardware_concurrency(), 1u), srcPaths.size());
+    std::vector<std::thread> workers;
+
+    for (size_t i = 1; i < threadCount; ++i) {
+        workers.emplace_back(parseNextFiles);
+    }
+
+    parseNextFiles();
+
+    for (std::thread& worker : workers) {
+        worker.join();
+    }
+
+    ctx->recordPhaseMemory("Parsing", ctx->memoryStats() - memoryBefore);
+
+    std::vector<ast::ModuleDecl*> modules;
+    std::exception_ptr firstError;
+
+    for (const ParsedFile& file : files) {
+        file.rep.replayTo(ctx->reporter());
+
+        if (file.error) {
+            if (!firstError) {
+                firstError = file.error;
+            }
+        } else {
+            modules.insert(modules.end(), file.program->getModules().begin(), file.program->getModules().end());
+        }
+    }
+
+    try {
+        if (firstError) {
+            std::rethrow_exception(firstError);
+        }
+    } catch (const common::CompilationFatalError& err) {
+        throw CompileError(err.what());
+    }
+
+    if (ctx->reporter().getErrorCount() != 0) {
+        return MAKE_INVALID(ProgramBuilder);
+    }
+
+    ast::Program* program = ctx->memoryManager().New<ast::Program>(modules);
+
+    if (!files.empty()) {
+        program->setPos(*files.front().program);
+    }
+
+    return ProgramBuilder(NEW_PROGRAMBUILDER_IMPL(_impl, program));
+}
+
+void Compiler::parseByModule(const std::string& srcName, const char* srcContent, size_t srcSize, const ModuleHandler& onModule) {
+    try {
+        src::SpanSource source(src::InputSourceName::make(_impl->ctx, srcName), srcContent, srcSize);
+
+        parseSourceByModule(_impl, source, [&](ast::Program* program) {
+            onModule(program ? ProgramBuilder(NEW_PROGRAMBUILDER_IMPL(_impl, program)) : MAKE_INVALID(ProgramBuilder));
+        });
+    } catch (const common::CompilationFatalError& err) {
+        throw CompileError(err.what());
+    }
+}
+
+void Compiler::parseFileByModule(const std::string& srcPath, const ModuleHandler& onModule) {
+    try {
+        src::MappedFileSource source(src::InputSourceName::make(_impl->ctx, srcPath), srcPath);
+
+        parseSourceByModule(_impl, source, [&](ast::Program* program) {
+            onModule(program ? ProgramBuilder(NEW_PROGRAMBUILDER_IMPL(_impl, program)) : MAKE_INVALID(ProgramBuilder));
+        });
+    } catch (const common::CompilationFatalError& err) {
+        throw CompileError(err.what());
+    }
+}
+
 void Compiler::compile(ProgramBuilder progBuilder, AbstractOutputCollector& collector, const Pipeline& tmp) {
     if (!progBuilder) {
         return;
@@ -474,6 +663,8 @@ void Compiler::compile(ProgramBuilder progBuilder, AbstractOutputCollector& coll
     _impl->config.get<opt::AfterEachPhase>(afterEachPhaseRep);
     _impl->config.get<opt::AtEnd>(atEndRep);
 
+    sym::ResolutionCache* resolutionCache = sym::ResolutionCache::get(ctx);
+
     try {
         std::set<std::shared_ptr<Phase>> phases(ppl.getPhases());
         std::vector<std::shared_ptr<Phase>> sortedPhases(sortPhases(phases));
@@ -482,11 +673,17 @@ void Compiler::compile(ProgramBuilder progBuilder, AbstractOutputCollector& coll
 
         for (std::shared_ptr<Phase> phase : sortedPhases) {
 
+            common::MemoryStats memoryBefore(ctx->memoryStats());
+            common::ResolutionStats resolutionsBefore(resolutionCache->getStats());
             clock_t phaseStart = clock();
             bool success = phase->run(pctx);
+            clock_t phaseEnd = clock();
+
+            ctx->recordPhaseMemory(phase->getName(), ctx->memoryStats() - memoryBefore);
+            ctx->recordPhaseResolutions(phase->getName(), resolutionCache->getStats() - resolutionsBefore);
 
             if (afterEachPhaseRep) {
-                afterEachPhaseRep(phase->getName(), (clock() - phaseStart) / (double) CLOCKS_PER_SEC, ctx->memoryManager().getInfos());
+                afterEachPhaseRep(phase->getName(), (phaseEnd - phaseStart) / (double) CLOCKS_PER_SEC, ctx->memoryManager().getInfos());
             }
 
             if (!success) {
@@ -507,6 +704,10 @@ void Compiler::compile(ProgramBuilder progBuilder, AbstractOutputCollector& coll
     }
 }
 
+void Compiler::dumpMemoryStats(std::ostream& o) const {
+    _impl->ctx->writeMemoryStatsJSON(o);
+}
+
 // PROGRAM BUILDER
 
 ProgramBuilder::ProgramBuilder(PROGRAMBUILDER_IMPL_PTR impl) : _impl(impl) {
@@ -534,7 +735,7 @@ Type ProgramBuilder::parseType(const std::string& str) {
     }
 
     src::StringSource source(src::InputSourceName::make(_impl->cmp->ctx, "type"), str);
-    lex::Lexer lexer(_impl->cmp->ctx->memoryManager(), _impl->cmp->ctx->reporter(), source);
+    lex::Lexer lexer(_impl->cmp->ctx->reporter(), _impl->cmp->ctx->names(), source);
     ast::Parser parser(_impl->cmp->ctx, lexer, _impl->cmp->namer);
     ast::TypeExpression* tpe = parser.parseType();
 
@@ -565,7 +766,7 @@ Type ProgramBuilder::createFunctionType(const std::vector<Type>& argTypes, Type
 
 ClassBuilder ProgramBuilder::classBuilder(const std::string& className) {
     if (_impl) {
-        return ClassBuilder(NEW_CLASSBUILDER_IMPL(_impl->cmp->ctx->memoryManager(), className));
+        return ClassBuilder(NEW_CLASSBUILDER_IMPL(_impl->cmp->ctx->memoryManager(), _impl->cmp->ctx->names(), className));
     } else {
         return MAKE_INVALID(ClassBuilder);
     }
@@ -573,7 +774,7 @@ ClassBuilder ProgramBuilder::classBuilder(const std::string& className) {
 
 TypeConstructorBuilder ProgramBuilder::typeConstructorBuilder(const std::string& typeConstructorName) {
     if (_impl) {
-        return TypeConstructorBuilder(NEW_TCBUILDER_IMPL(_impl->cmp->ctx->memoryManager(), typeConstructorName));
+        return TypeConstructorBuilder(NEW_TCBUILDER_IMPL(_impl->cmp->ctx->memoryManager(), _impl->cmp->ctx->names(), typeConstructorName));
     } else {
         return MAKE_INVALID(TypeConstructorBuilder);
     }
@@ -19,4 +19,12 @@ CompileError::~CompileError() {
 
 }
 
+RuntimeError::RuntimeError(const std::string& msg) : std::runtime_error(msg) {
+
+}
+
+RuntimeError::~RuntimeError() {
+
+}
+
 }
@@ -12,6 +12,8 @@
 
 #include "Compiler/Backend/BytecodeGenerator.h"
 
+#include "VirtualMachineImpl.h"
+
 namespace sfsl {
 
 // ABSTRACT OUTPUT COLLECTOR
@@ -41,8 +43,9 @@ ByteCodeCollector::~ByteCodeCollector() {
 void ByteCodeCollector::collect(PhaseContext& pctx) {
     _result.clear();
 
-    out::LinkedListOutput<bc::BCInstruction*>* out = pctx.require<out::LinkedListOutput<bc::BCInstruction*>>("out");
-    std::vector<bc::BCInstruction*> instrs(out->toVector());
+    CompCtx_Ptr ctx = *pctx.require<CompCtx_Ptr>("ctx");
+    bc::BytecodeBuffer* out = pctx.require<bc::BytecodeBuffer>("out");
+    std::vector<bc::BCInstruction*> instrs(out->toInstructions(ctx));
 
     for (bc::BCInstruction* instr : instrs) {
         _result.push_back(instr->toStringDetailed());
@@ -53,6 +56,32 @@ std::vector<std::string> ByteCodeCollector::get() const {
     return _result;
 }
 
+// VM COLLECTOR
+
+VMCollector::VMCollector() : _vm(nullptr) {
+
+}
+
+VMCollector::~VMCollector() {
+
+}
+
+void VMCollector::collect(PhaseContext& pctx) {
+    CompCtx_Ptr ctx = *pctx.require<CompCtx_Ptr>("ctx");
+
+    if (ctx->reporter().getErrorCount() != 0) {
+        _vm = VirtualMachine(nullptr);
+        return;
+    }
+
+    bc::BytecodeBuffer* out = pctx.require<bc::BytecodeBuffer>("out");
+    _vm = VirtualMachine(NEW_VM_IMPL(vm::Program::load(*out)));
+}
+
+VirtualMachine VMCollector::get() const {
+    return _vm;
+}
+
 // ERROR COUNT COLLECTOR
 
 ErrorCountCollector::ErrorCountCollector() : _errCount(0) {
@@ -168,8 +168,16 @@ public:
     virtual std::vector<std::string> runsAfter() const override { return {"AST2BAST"}; }
 
     virtual bool run(PhaseContext& pctx) {
+        bast::Program* bprog = pctx.require<bast::Program>("bprog");
         CompCtx_Ptr ctx = *pctx.require<CompCtx_Ptr>("ctx");
-        pctx.output("out", new out::LinkedListOutput<bc::BCInstruction*>(ctx));
+
+        bc::BytecodeBuffer* out = ctx->memoryManager().New<bc::BytecodeBuffer>();
+        bc::DefaultBytecodeGenerator gen(ctx, *out);
+
+        bprog->onVisit(&gen);
+
+        pctx.output("out", out);
+
         return ctx->reporter().getErrorCount() == 0;
     }
 };
@@ -0,0 +1,83 @@
+//
+//  VirtualMachine.cpp
+//  SFSL
+//
+//  Created by Romain Beguet on 17.10.16.
+//  Copyright (c) 2016 Romain Beguet. All rights reserved.
+//
+
+#include "api/VirtualMachine.h"
+#include "api/Errors.h"
+
+#include "VirtualMachineImpl.h"
+#include "VM/ModuleFile.h"
+
+namespace sfsl {
+
+namespace vm {
+
+// RUNTIME CONTEXT
+
+RuntimeCtx::~RuntimeCtx() {
+
+}
+
+}
+
+// VIRTUAL MACHINE
+
+VirtualMachine::VirtualMachine(VM_IMPL_PTR impl) : _impl(impl) {
+
+}
+
+VirtualMachine::~VirtualMachine() {
+
+}
+
+VirtualMachine::operator bool() const {
+    return _impl != nullptr;
+}
+
+bool VirtualMachine::has(const std::string& symbol) const {
+    size_t index;
+    return _impl->interpreter.getProgram().findConst(symbol, index);
+}
+
+VirtualMachine& VirtualMachine::link(const std::string& symbol, vm::NativeMethod native) {
+    size_t index;
+    if (_impl->interpreter.getProgram().findConst(symbol, index)) {
+        _impl->interpreter.setConst(index, _impl->interpreter.makeNative(native));
+    }
+    return *this;
+}
+
+vm::Value VirtualMachine::get(const std::string& symbol) {
+    size_t index;
+    if (!_impl->interpreter.getProgram().findConst(symbol, index)) {
+        throw RuntimeError("Unknown symbol '" + symbol + "'");
+    }
+    _impl->initialize();
+    return _impl->interpreter.getConst(index);
+}
+
+vm::Value VirtualMachine::call(const std::string& symbol, const std::vector<vm::Value>& args) {
+    return _impl->interpreter.callMethod(get(symbol), 0, args);
+}
+
+vm::RuntimeCtx& VirtualMachine::getContext() {
+    return _impl->interpreter;
+}
+
+void VirtualMachine::save(const std::string& path) const {
+    vm::ModuleFile::write(_impl->interpreter.getProgram(), path);
+}
+
+VirtualMachine VirtualMachine::load(const std::string& path) {
+    return VirtualMachine(NEW_VM_IMPL(vm::ModuleFile::map(path)));
+}
+
+void VirtualMachine::dump(std::ostream& o) const {
+    _impl->interpreter.getProgram().dump(o);
+}
+
+}
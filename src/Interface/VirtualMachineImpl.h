@@ -0,0 +1,39 @@
+//
+//  VirtualMachineImpl.h
+//  SFSL
+//
+//  Created by Romain Beguet on 17.10.16.
+//  Copyright (c) 2016 Romain Beguet. All rights reserved.
+//
+
+#ifndef __SFSL__API_VirtualMachineImpl__
+#define __SFSL__API_VirtualMachineImpl__
+
+#include "api/VirtualMachine.h"
+#include "VM/Interpreter.h"
+
+#define VM_IMPL_NAME                NAME_OF_IMPL(VirtualMachine)
+#define VM_IMPL_PTR                 PRIVATE_IMPL_PTR(VirtualMachine)
+#define NEW_VM_IMPL                 NEW_PRIV_IMPL(VirtualMachine)
+
+BEGIN_PRIVATE_DEF
+
+class VM_IMPL_NAME final {
+public:
+    VM_IMPL_NAME(std::shared_ptr<const vm::Program> prog) : interpreter(prog), initialized(false) {}
+    ~VM_IMPL_NAME() {}
+
+    void initialize() {
+        if (!initialized) {
+            initialized = true;
+            interpreter.initialize();
+        }
+    }
+
+    vm::Interpreter interpreter;
+    bool initialized;
+};
+
+END_PRIVATE_DEF
+
+#endif
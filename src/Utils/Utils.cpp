@@ -8,3 +8,128 @@
 
 #include "Utils.h"
 
+#include <algorithm>
+#include <cmath>
+#include <clocale>
+#include <cstdio>
+#include <cstdlib>
+#include <limits>
+
+namespace sfsl {
+
+namespace utils {
+
+std::string formatInteger(uint64_t magnitude, bool negative) {
+    char buffer[21]; // 20 digits for the largest uint64_t + the sign
+    char* begin = buffer + sizeof(buffer);
+
+    do {
+        *--begin = '0' + (magnitude % 10);
+        magnitude /= 10;
+    } while (magnitude != 0);
+
+    if (negative) {
+        *--begin = '-';
+    }
+
+    return std::string(begin, buffer + sizeof(buffer));
+}
+
+std::string formatReal(double val) {
+    char buffer[32];
+    int length = std::snprintf(buffer, sizeof(buffer), "%g", val);
+
+    const char separator = *std::localeconv()->decimal_point;
+    if (separator != '.') {
+        std::replace(buffer, buffer + length, separator, '.');
+    }
+
+    return std::string(buffer, length);
+}
+
+bool parseInteger(const char* begin, const char* end, sfsl_int_t& res) {
+    typedef std::make_unsigned<sfsl_int_t>::type uint_t;
+    const uint_t max = std::numeric_limits<sfsl_int_t>::max();
+
+    uint_t value = 0;
+
+    for (; begin != end; ++begin) {
+        uint_t digit = *begin - '0';
+        if (value > (max - digit) / 10) {
+            return false;
+        }
+        value = value * 10 + digit;
+    }
+
+    res = value;
+    return true;
+}
+
+namespace {
+
+// powers of ten that are exactly representable by a double
+const double EXACT_POWERS_OF_TEN[] = {
+    1e0,  1e1,  1e2,  1e3,  1e4,  1e5,  1e6,  1e7,  1e8,  1e9,  1e10, 1e11,
+    1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22
+};
+
+const uint64_t MAX_EXACT_MANTISSA = uint64_t(1) << std::numeric_limits<double>::digits;
+
+inline void strToReal(const char* str, double& res) {
+    res = std::strtod(str, nullptr);
+}
+
+inline void strToReal(const char* str, float& res) {
+    res = std::strtof(str, nullptr);
+}
+
+}
+
+bool parseReal(const char* begin, const char* end, sfsl_real_t& res) {
+    uint64_t mantissa = 0;
+    size_t fractionDigits = 0;
+    bool inFraction = false;
+    bool exact = std::numeric_limits<sfsl_real_t>::digits >= std::numeric_limits<double>::digits;
+
+    for (const char* it = begin; exact && it != end; ++it) {
+        if (*it == '.') {
+            inFraction = true;
+        } else {
+            mantissa = mantissa * 10 + (*it - '0');
+            fractionDigits += inFraction;
+            exact = mantissa <= MAX_EXACT_MANTISSA;
+        }
+    }
+
+    if (exact && fractionDigits < sizeof(EXACT_POWERS_OF_TEN) / sizeof(double)) {
+        // both operands are exact, so the division is correctly rounded
+        res = mantissa / EXACT_POWERS_OF_TEN[fractionDigits];
+        return true;
+    }
+
+    // slow path: too many significant digits for the division to be exact.
+    // the decimal separator is replaced by an exponent so that the conversion
+    // does not depend on the locale
+    std::string scientific;
+    scientific.reserve(end - begin + 24);
+    fractionDigits = 0;
+    inFraction = false;
+
+    for (const char* it = begin; it != end; ++it) {
+        if (*it == '.') {
+            inFraction = true;
+        } else {
+            scientific += *it;
+            fractionDigits += inFraction;
+        }
+    }
+
+    scientific += "e-" + formatInteger(fractionDigits, false);
+    strToReal(scientific.c_str(), res);
+
+    return !std::isinf(res);
+}
+
+}
+
+}
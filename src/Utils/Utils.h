@@ -10,8 +10,11 @@
 #define __SFSL__Utils__
 
 #include <sstream>
+#include <string>
 #include <vector>
 #include <iterator>
+#include <cstdint>
+#include <type_traits>
 
 #define PTR_SIZE sizeof(void*)
 
@@ -35,12 +38,57 @@ struct AdaptedType<8> {
     typedef double adapted_real;
 };
 
+/**
+ * @brief Writes the decimal representation of an integer without going through iostreams.
+ * @param magnitude The absolute value of the integer
+ * @param negative True if the integer is negative
+ * @return the string representation of the integer
+ */
+std::string formatInteger(uint64_t magnitude, bool negative);
+
+/**
+ * @brief Writes a real the same way an std::ostream with the default flags
+ * would (6 significant digits), but always uses '.' as the decimal separator.
+ * @param val The real to convert to String
+ * @return the string representation of the real
+ */
+std::string formatReal(double val);
+
+template<typename T>
+inline typename std::enable_if<std::is_signed<T>::value, std::string>::type integerToString(T val) {
+    return val < 0 ? formatInteger(0 - static_cast<uint64_t>(val), true) : formatInteger(val, false);
+}
+
+template<typename T>
+inline typename std::enable_if<std::is_unsigned<T>::value, std::string>::type integerToString(T val) {
+    return formatInteger(val, false);
+}
+
 template<typename T>
 /**
  * @param val The value to convert to String
  * @return the string representation of the given value
  */
-inline std::string T_toString(T val) {
+inline typename std::enable_if<std::is_integral<T>::value && (sizeof(T) > 1), std::string>::type T_toString(T val) {
+    return integerToString(val);
+}
+
+template<typename T>
+/**
+ * @param val The value to convert to String
+ * @return the string representation of the given value
+ */
+inline typename std::enable_if<std::is_floating_point<T>::value, std::string>::type T_toString(T val) {
+    return formatReal(val);
+}
+
+template<typename T>
+/**
+ * @param val The value to convert to String (characters, booleans, enums and
+ * any other type that can be written to an std::ostream)
+ * @return the string representation of the given value
+ */
+inline typename std::enable_if<!std::is_arithmetic<T>::value || sizeof(T) == 1, std::string>::type T_toString(T val) {
     std::ostringstream oss;
     oss << val;
     return oss.str();
@@ -88,7 +136,7 @@ inline std::string join(const std::vector<std::string>& parts, const std::string
 }
 
 template<typename T>
-inline max(std::initializer_list<T> list, T default_max = T()) {
+inline T max(std::initializer_list<T> list, T default_max = T()) {
     for (auto elem : list) {
         if (elem > default_max) {
             default_max = elem;
@@ -239,6 +287,29 @@ typedef utils::AdaptedType<PTR_SIZE>::adapted_int sfsl_int_t;
  */
 typedef utils::AdaptedType<PTR_SIZE>::adapted_real sfsl_real_t;
 
+namespace utils {
+
+/**
+ * @brief Parses a sequence of decimal digits into an sfsl_int_t.
+ * @param begin The first digit
+ * @param end One past the last digit
+ * @param res Receives the parsed value
+ * @return False if the value is too large to be represented by an sfsl_int_t
+ */
+bool parseInteger(const char* begin, const char* end, sfsl_int_t& res);
+
+/**
+ * @brief Parses a real of the form `digits[.digits]` into an sfsl_real_t.
+ * Does not depend on the current locale.
+ * @param begin The first character of the real
+ * @param end One past the last character of the real
+ * @param res Receives the parsed value
+ * @return False if the value is too large to be represented by an sfsl_real_t
+ */
+bool parseReal(const char* begin, const char* end, sfsl_real_t& res);
+
+}
+
 }
 
 #endif
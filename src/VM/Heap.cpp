@@ -0,0 +1,135 @@
+//
+//  Heap.cpp
+//  SFSL
+//
+//  Created by Romain Beguet on 17.10.16.
+//  Copyright (c) 2016 Romain Beguet. All rights reserved.
+//
+
+#include <new>
+#include <algorithm>
+#include "Heap.h"
+
+#define INITIAL_GC_THRESHOLD 1024
+
+namespace sfsl {
+
+namespace vm {
+
+Heap::Heap() : _objects(nullptr), _objectCount(0), _threshold(INITIAL_GC_THRESHOLD) {
+
+}
+
+Heap::~Heap() {
+    while (_objects) {
+        HeapObject* next = _objects->next;
+        release(_objects);
+        _objects = next;
+    }
+}
+
+StringObject* Heap::newString(const std::string& str) {
+    return allocate<StringObject>(0, str);
+}
+
+ClassObject* Heap::newClass(size_t fieldCount, size_t methodCount) {
+    return allocate<ClassObject>(methodCount, fieldCount, methodCount);
+}
+
+InstanceObject* Heap::newInstance(ClassObject* clss) {
+    InstanceObject* obj = allocate<InstanceObject>(clss->fieldCount, clss);
+    Value* fields = obj->fields();
+    for (size_t i = 0; i < clss->fieldCount; ++i) {
+        fields[i] = Value::Unit();
+    }
+    return obj;
+}
+
+bool Heap::shouldCollect() const {
+    return _objectCount >= _threshold;
+}
+
+void Heap::mark(const Value& val) {
+    switch (val.type) {
+    case Value::STRING:
+    case Value::CLASS:
+    case Value::OBJECT: {
+        HeapObject* obj = static_cast<HeapObject*>(val.ref);
+        if (!obj->marked) {
+            obj->marked = true;
+            _grey.push_back(obj);
+        }
+        break;
+    }
+    default:
+        break;
+    }
+}
+
+void Heap::collect() {
+    while (!_grey.empty()) {
+        HeapObject* obj = _grey.back();
+        _grey.pop_back();
+
+        switch (obj->kind) {
+        case HeapObject::CLASS_OBJECT: {
+            ClassObject* clss = static_cast<ClassObject*>(obj);
+            for (size_t i = 0; i < clss->methodCount; ++i) {
+                mark(clss->methods()[i]);
+            }
+            break;
+        }
+        case HeapObject::INSTANCE_OBJECT: {
+            InstanceObject* inst = static_cast<InstanceObject*>(obj);
+            if (!inst->clss->marked) {
+                inst->clss->marked = true;
+                _grey.push_back(inst->clss);
+            }
+            for (size_t i = 0; i < inst->clss->fieldCount; ++i) {
+                mark(inst->fields()[i]);
+            }
+            break;
+        }
+        default:
+            break;
+        }
+    }
+
+    HeapObject** link = &_objects;
+    while (*link) {
+        HeapObject* obj = *link;
+        if (obj->marked) {
+            obj->marked = false;
+            link = &obj->next;
+        } else {
+            *link = obj->next;
+            release(obj);
+            --_objectCount;
+        }
+    }
+
+    _threshold = std::max<size_t>(INITIAL_GC_THRESHOLD, _objectCount * 2);
+}
+
+size_t Heap::getObjectCount() const {
+    return _objectCount;
+}
+
+template<typename T, typename... Args>
+T* Heap::allocate(size_t trailingValues, Args... args) {
+    void* mem = ::operator new(sizeof(T) + trailingValues * sizeof(Value));
+    T* obj = new (mem) T(std::forward<Args>(args)...);
+    obj->next = _objects;
+    _objects = obj;
+    ++_objectCount;
+    return obj;
+}
+
+void Heap::release(HeapObject* obj) {
+    obj->~HeapObject();
+    ::operator delete(obj);
+}
+
+}
+
+}
@@ -0,0 +1,114 @@
+//
+//  Heap.h
+//  SFSL
+//
+//  Created by Romain Beguet on 17.10.16.
+//  Copyright (c) 2016 Romain Beguet. All rights reserved.
+//
+
+#ifndef __SFSL__VM_Heap__
+#define __SFSL__VM_Heap__
+
+#include <iostream>
+#include <vector>
+#include "api/Value.h"
+
+namespace sfsl {
+
+namespace vm {
+
+/**
+ * @brief Base of every object allocated on the garbage collected heap
+ */
+struct HeapObject {
+    enum KIND { STRING_OBJECT, CLASS_OBJECT, INSTANCE_OBJECT };
+
+    HeapObject(KIND k) : kind(k), marked(false), next(nullptr) {}
+    virtual ~HeapObject() {}
+
+    KIND kind;
+    bool marked;
+    HeapObject* next;
+};
+
+struct StringObject final : public HeapObject {
+    StringObject(const std::string& str) : HeapObject(STRING_OBJECT), value(str) {}
+    virtual ~StringObject() {}
+
+    std::string value;
+};
+
+/**
+ * @brief A class: the number of fields of its instances and its virtual table,
+ * which is stored right after the object.
+ */
+struct ClassObject final : public HeapObject {
+    ClassObject(size_t fieldCount, size_t methodCount)
+        : HeapObject(CLASS_OBJECT), fieldCount(fieldCount), methodCount(methodCount) {}
+    virtual ~ClassObject() {}
+
+    Value* methods() { return reinterpret_cast<Value*>(this + 1); }
+
+    size_t fieldCount;
+    size_t methodCount;
+};
+
+/**
+ * @brief An instance of a class, whose fields are stored right after the object
+ */
+struct InstanceObject final : public HeapObject {
+    InstanceObject(ClassObject* clss) : HeapObject(INSTANCE_OBJECT), clss(clss) {}
+    virtual ~InstanceObject() {}
+
+    Value* fields() { return reinterpret_cast<Value*>(this + 1); }
+
+    ClassObject* clss;
+};
+
+/**
+ * @brief A mark and sweep garbage collected heap.
+ * The owner of the heap is responsible of marking the roots (see #mark)
+ * before calling #collect, which it should do whenever #shouldCollect returns true.
+ */
+class Heap final {
+public:
+    Heap();
+    ~Heap();
+
+    StringObject* newString(const std::string& str);
+    ClassObject* newClass(size_t fieldCount, size_t methodCount);
+    InstanceObject* newInstance(ClassObject* clss);
+
+    bool shouldCollect() const;
+
+    /**
+     * @brief Marks the object referred to by the value (if any) as reachable
+     */
+    void mark(const Value& val);
+
+    /**
+     * @brief Marks everything reachable from the objects marked so far,
+     * and frees the other ones.
+     */
+    void collect();
+
+    size_t getObjectCount() const;
+
+private:
+
+    template<typename T, typename... Args>
+    T* allocate(size_t trailingValues, Args... args);
+
+    void release(HeapObject* obj);
+
+    HeapObject* _objects;
+    size_t _objectCount;
+    size_t _threshold;
+    std::vector<HeapObject*> _grey;
+};
+
+}
+
+}
+
+#endif
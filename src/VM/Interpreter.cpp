@@ -0,0 +1,426 @@
+//
+//  Interpreter.cpp
+//  SFSL
+//
+//  Created by Romain Beguet on 17.10.16.
+//  Copyright (c) 2016 Romain Beguet. All rights reserved.
+//
+
+#include <algorithm>
+#include "Interpreter.h"
+#include "api/Errors.h"
+
+#define NO_PC ((size_t)-1)
+
+namespace sfsl {
+
+namespace vm {
+
+static_assert(std::is_same<int_t, sfsl_int_t>::value, "vm::int_t must match the compiler's integer type");
+static_assert(std::is_same<real_t, sfsl_real_t>::value, "vm::real_t must match the compiler's real type");
+
+static Value makeRef(Value::TYPE type, void* ref) {
+    Value v;
+    v.type = type;
+    v.ref = ref;
+    return v;
+}
+
+static Value makeMethod(size_t index) {
+    Value v;
+    v.type = Value::METHOD;
+    v.i = (int_t)index;
+    return v;
+}
+
+Interpreter::Interpreter(std::shared_ptr<const Program> prog, size_t stackSize)
+    : _prog(prog), _code(prog->getCode()), _stack(stackSize), _sp(0), _fp(0), _consts(prog->getConstCount()) {
+
+}
+
+Interpreter::~Interpreter() {
+
+}
+
+const Program& Interpreter::getProgram() const {
+    return *_prog;
+}
+
+Value Interpreter::getConst(size_t index) const {
+    return _consts[index];
+}
+
+void Interpreter::setConst(size_t index, Value val) {
+    _consts[index] = val;
+}
+
+Value Interpreter::makeNative(NativeMethod native) {
+    _natives.push_back(native);
+    return makeRef(Value::NATIVE, &_natives.back());
+}
+
+void Interpreter::initialize() {
+    size_t oldSp = _sp, oldFp = _fp, oldDepth = _frames.size();
+
+    try {
+        size_t calleePos = _sp;
+        push(Value::Unit(), NO_PC);
+        enterFrame(calleePos, makeMethod(0), NO_PC, NO_PC);
+        execute(_prog->getMethod(0).entry, oldDepth);
+    } catch (...) {
+        _sp = oldSp;
+        _fp = oldFp;
+        _frames.resize(oldDepth);
+        throw;
+    }
+}
+
+Value Interpreter::makeString(const std::string& str) {
+    if (_heap.shouldCollect()) {
+        collectGarbage();
+    }
+    Value v = makeRef(Value::STRING, _heap.newString(str));
+    _tempRoots.push_back(v);
+    return v;
+}
+
+const std::string& Interpreter::getString(Value str) const {
+    if (str.type != Value::STRING) {
+        error(NO_PC, "Value is not a string");
+    }
+    return static_cast<StringObject*>(str.ref)->value;
+}
+
+Value Interpreter::getField(Value obj, size_t index) const {
+    if (obj.type != Value::OBJECT) {
+        error(NO_PC, "Value is not an object");
+    }
+    InstanceObject* inst = static_cast<InstanceObject*>(obj.ref);
+    if (index >= inst->clss->fieldCount) {
+        error(NO_PC, "Field index out of bounds");
+    }
+    return inst->fields()[index];
+}
+
+void Interpreter::setField(Value obj, size_t index, Value val) {
+    if (obj.type != Value::OBJECT) {
+        error(NO_PC, "Value is not an object");
+    }
+    InstanceObject* inst = static_cast<InstanceObject*>(obj.ref);
+    if (index >= inst->clss->fieldCount) {
+        error(NO_PC, "Field index out of bounds");
+    }
+    inst->fields()[index] = val;
+}
+
+Value Interpreter::callMethod(Value callee, size_t methodIndex, const std::vector<Value>& args) {
+    size_t oldSp = _sp, oldFp = _fp, oldDepth = _frames.size();
+    bool outermost = (_sp == 0);
+
+    try {
+        size_t calleePos = _sp;
+        push(callee, NO_PC);
+        for (const Value& arg : args) {
+            push(arg, NO_PC);
+        }
+
+        if (outermost) {
+            // values given to the host by a previous call are not protected anymore
+            _tempRoots.clear();
+        }
+
+        return invoke(calleePos, methodIndex, NO_PC);
+    } catch (...) {
+        _sp = oldSp;
+        _fp = oldFp;
+        _frames.resize(oldDepth);
+        throw;
+    }
+}
+
+Value Interpreter::invoke(size_t calleePos, size_t methodIndex, size_t pc) {
+    Value target = resolveMethod(_stack[calleePos], methodIndex, pc);
+
+    if (target.type == Value::NATIVE) {
+        return callNative(target, calleePos);
+    }
+
+    size_t depth = _frames.size();
+    enterFrame(calleePos, target, NO_PC, pc);
+    return execute(_prog->getMethod((size_t)target.i).entry, depth);
+}
+
+Value Interpreter::execute(size_t pc, size_t stopDepth) {
+    const Instruction* code = _code;
+    Value* stack = _stack.data();
+    size_t sp = _sp;
+    size_t fp = _fp;
+
+    for (;;) {
+        const Instruction& instr(code[pc]);
+
+        switch (instr.opcode) {
+        case bc::OP_MAKE_CLASS: {
+            _sp = sp;
+            if (_heap.shouldCollect()) {
+                collectGarbage();
+            }
+            ClassObject* clss = _heap.newClass(instr.arg, instr.arg2);
+            sp -= instr.arg2;
+            std::copy(stack + sp, stack + sp + instr.arg2, clss->methods());
+            stack[sp++] = makeRef(Value::CLASS, clss);
+            ++pc;
+            break;
+        }
+
+        case bc::OP_MAKE_METHOD:
+            stack[sp++] = makeMethod(instr.arg);
+            ++pc;
+            break;
+
+        case bc::OP_STORE_CONST:
+            _consts[instr.arg] = stack[--sp];
+            ++pc;
+            break;
+
+        case bc::OP_LOAD_CONST:
+            stack[sp++] = _consts[instr.arg];
+            ++pc;
+            break;
+
+        case bc::OP_INSTANTIATE: {
+            if (stack[sp - 1].type != Value::CLASS) {
+                error(pc, "Cannot instantiate a value which is not a class");
+            }
+            _sp = sp;
+            if (_heap.shouldCollect()) {
+                collectGarbage();
+            }
+            ClassObject* clss = static_cast<ClassObject*>(stack[sp - 1].ref);
+            stack[sp - 1] = makeRef(Value::OBJECT, _heap.newInstance(clss));
+            ++pc;
+            break;
+        }
+
+        case bc::OP_PUSH_UNIT:
+            stack[sp++] = Value::Unit();
+            ++pc;
+            break;
+
+        case bc::OP_PUSH_BOOL:
+            stack[sp++] = Value::Bool(instr.arg != 0);
+            ++pc;
+            break;
+
+        case bc::OP_PUSH_INT:
+            stack[sp++] = Value::Int(instr.intValue);
+            ++pc;
+            break;
+
+        case bc::OP_PUSH_REAL:
+            stack[sp++] = Value::Real(instr.realValue);
+            ++pc;
+            break;
+
+        case bc::OP_PUSH_STRING: {
+            _sp = sp;
+            if (_heap.shouldCollect()) {
+                collectGarbage();
+            }
+            stack[sp++] = makeRef(Value::STRING, _heap.newString(_prog->getString(instr.arg)));
+            ++pc;
+            break;
+        }
+
+        case bc::OP_LOAD_STACK:
+            stack[sp] = stack[fp + instr.arg];
+            ++sp;
+            ++pc;
+            break;
+
+        case bc::OP_STORE_STACK:
+            stack[fp + instr.arg] = stack[sp - 1];
+            ++pc;
+            break;
+
+        case bc::OP_LOAD_FIELD: {
+            Value& obj(stack[sp - 1]);
+            if (obj.type != Value::OBJECT) {
+                error(pc, "Cannot access a field of a value which is not an object");
+            }
+            InstanceObject* inst = static_cast<InstanceObject*>(obj.ref);
+            if (instr.arg >= inst->clss->fieldCount) {
+                error(pc, "Field index out of bounds");
+            }
+            obj = inst->fields()[instr.arg];
+            ++pc;
+            break;
+        }
+
+        case bc::OP_STORE_FIELD: {
+            Value val = stack[--sp];
+            Value& obj(stack[sp - 1]);
+            if (obj.type != Value::OBJECT) {
+                error(pc, "Cannot assign a field of a value which is not an object");
+            }
+            InstanceObject* inst = static_cast<InstanceObject*>(obj.ref);
+            if (instr.arg >= inst->clss->fieldCount) {
+                error(pc, "Field index out of bounds");
+            }
+            inst->fields()[instr.arg] = val;
+            obj = val;
+            ++pc;
+            break;
+        }
+
+        case bc::OP_POP:
+            --sp;
+            ++pc;
+            break;
+
+        case bc::OP_DUP:
+            stack[sp] = stack[sp - 1];
+            ++sp;
+            ++pc;
+            break;
+
+        case bc::OP_RETURN: {
+            Value res = stack[sp - 1];
+            Frame frame = _frames.back();
+            _frames.pop_back();
+
+            sp = fp;
+            fp = frame.fp;
+
+            if (_frames.size() == stopDepth) {
+                _sp = sp;
+                _fp = fp;
+                return res;
+            }
+
+            stack[sp++] = res;
+            pc = frame.returnPc;
+            break;
+        }
+
+        case bc::OP_IF_FALSE: {
+            Value cond = stack[--sp];
+            if (cond.type != Value::BOOL) {
+                error(pc, "Condition is not a boolean");
+            }
+            pc = cond.b ? pc + 1 : instr.arg;
+            break;
+        }
+
+        case bc::OP_JUMP:
+            pc = instr.arg;
+            break;
+
+        case bc::OP_VCALL: {
+            size_t calleePos = sp - instr.arg2 - 1;
+            Value target = resolveMethod(stack[calleePos], instr.arg, pc);
+
+            _sp = sp;
+            _fp = fp;
+
+            if (target.type == Value::METHOD) {
+                enterFrame(calleePos, target, pc + 1, pc);
+                pc = _prog->getMethod((size_t)target.i).entry;
+            } else {
+                Value res = callNative(target, calleePos);
+                stack[_sp++] = res;
+                ++pc;
+            }
+
+            sp = _sp;
+            fp = _fp;
+            break;
+        }
+
+        default:
+            error(pc, "Invalid instruction");
+        }
+    }
+}
+
+void Interpreter::enterFrame(size_t calleePos, Value target, size_t returnPc, size_t pc) {
+    const MethodInfo& meth(_prog->getMethod((size_t)target.i));
+
+    if (calleePos + meth.frameSize >= _stack.size()) {
+        error(pc, "Stack overflow");
+    }
+
+    _frames.push_back(Frame{returnPc, _fp});
+    _fp = calleePos;
+
+    for (size_t top = calleePos + meth.varCount; _sp < top; ++_sp) {
+        _stack[_sp] = Value::Unit();
+    }
+}
+
+Value Interpreter::callNative(Value native, size_t calleePos) {
+    NativeMethod* fn = static_cast<NativeMethod*>(native.ref);
+    size_t tempMark = _tempRoots.size();
+
+    Value res = (*fn)(*this, _stack[calleePos], _stack.data() + calleePos + 1);
+
+    _tempRoots.resize(tempMark);
+    _sp = calleePos;
+    return res;
+}
+
+Value Interpreter::resolveMethod(Value callee, size_t methodIndex, size_t pc) {
+    Value target;
+
+    switch (callee.type) {
+    case Value::OBJECT: {
+        ClassObject* clss = static_cast<InstanceObject*>(callee.ref)->clss;
+        if (methodIndex >= clss->methodCount) {
+            error(pc, "Method index out of bounds");
+        }
+        target = clss->methods()[methodIndex];
+        break;
+    }
+    case Value::NATIVE:
+        target = callee;
+        break;
+    case Value::UNDEFINED:
+        error(pc, "Call on an undefined value (missing native link?)");
+    default:
+        error(pc, "Call on a value which is not an object");
+    }
+
+    if (target.type != Value::METHOD && target.type != Value::NATIVE) {
+        error(pc, "Call to an undefined method (abstract method or missing native link?)");
+    }
+
+    return target;
+}
+
+void Interpreter::push(Value val, size_t pc) {
+    if (_sp >= _stack.size()) {
+        error(pc, "Stack overflow");
+    }
+    _stack[_sp++] = val;
+}
+
+void Interpreter::collectGarbage() {
+    for (size_t i = 0; i < _sp; ++i) {
+        _heap.mark(_stack[i]);
+    }
+    for (const Value& val : _consts) {
+        _heap.mark(val);
+    }
+    for (const Value& val : _tempRoots) {
+        _heap.mark(val);
+    }
+    _heap.collect();
+}
+
+void Interpreter::error(size_t pc, const std::string& msg) const {
+    throw RuntimeError(_prog->positionStr(pc) + ": " + msg);
+}
+
+}
+
+}
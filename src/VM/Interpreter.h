@@ -0,0 +1,100 @@
+//
+//  Interpreter.h
+//  SFSL
+//
+//  Created by Romain Beguet on 17.10.16.
+//  Copyright (c) 2016 Romain Beguet. All rights reserved.
+//
+
+#ifndef __SFSL__VM_Interpreter__
+#define __SFSL__VM_Interpreter__
+
+#include <iostream>
+#include <vector>
+#include <list>
+#include "api/VirtualMachine.h"
+#include "Program.h"
+#include "Heap.h"
+
+#define DEFAULT_STACK_SIZE (1 << 16)
+
+namespace sfsl {
+
+namespace vm {
+
+/**
+ * @brief Executes a #sfsl::vm::Program.
+ *
+ * Every frame lives on the value stack: the callee is at the base of the frame,
+ * followed by the arguments and the remaining local variables, which are
+ * followed by the temporaries of the method.
+ * Execution is reentrant: native methods can call back into the interpreter.
+ */
+class Interpreter final : public RuntimeCtx {
+public:
+    Interpreter(std::shared_ptr<const Program> prog, size_t stackSize = DEFAULT_STACK_SIZE);
+    virtual ~Interpreter();
+
+    const Program& getProgram() const;
+
+    Value getConst(size_t index) const;
+    void setConst(size_t index, Value val);
+
+    /**
+     * @brief Creates a value wrapping the given native method. The native stays alive
+     * as long as the interpreter does.
+     */
+    Value makeNative(NativeMethod native);
+
+    /**
+     * @brief Runs the initialization code of the program
+     */
+    void initialize();
+
+    virtual Value makeString(const std::string& str) override;
+    virtual const std::string& getString(Value str) const override;
+
+    virtual Value getField(Value obj, size_t index) const override;
+    virtual void setField(Value obj, size_t index, Value val) override;
+
+    virtual Value callMethod(Value callee, size_t methodIndex, const std::vector<Value>& args) override;
+
+private:
+
+    struct Frame final {
+        size_t returnPc;
+        size_t fp;
+    };
+
+    Value invoke(size_t calleePos, size_t methodIndex, size_t pc);
+    Value execute(size_t pc, size_t stopDepth);
+
+    void enterFrame(size_t calleePos, Value target, size_t returnPc, size_t pc);
+    Value callNative(Value native, size_t calleePos);
+    Value resolveMethod(Value callee, size_t methodIndex, size_t pc);
+
+    void push(Value val, size_t pc);
+    void collectGarbage();
+
+    [[noreturn]] void error(size_t pc, const std::string& msg) const;
+
+    std::shared_ptr<const Program> _prog;
+    const Instruction* _code;
+
+    std::vector<Value> _stack;
+    size_t _sp;
+    size_t _fp;
+    std::vector<Frame> _frames;
+
+    std::vector<Value> _consts;
+    std::vector<Value> _tempRoots;
+    std::list<NativeMethod> _natives;
+
+    Heap _heap;
+};
+
+}
+
+}
+
+#endif
@@ -0,0 +1,374 @@
+//
+//  ModuleFile.cpp
+//  SFSL
+//
+//  Created by Romain Beguet on 18.10.16.
+//  Copyright (c) 2016 Romain Beguet. All rights reserved.
+//
+
+#include <algorithm>
+#include <fstream>
+#include <cstring>
+#include "ModuleFile.h"
+#include "api/Errors.h"
+
+#ifdef _WIN32
+#include <iterator>
+#else
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+#define MODULE_ALIGNMENT 8
+#define BYTE_ORDER_MARK 0x01020304
+
+namespace sfsl {
+
+namespace vm {
+
+// MAPPED FILE
+
+/**
+ * @brief Read-only memory mapping of a whole file, unmapped on destruction.
+ * Falls back to reading the file in an aligned buffer where mmap is not available.
+ */
+class ModuleFile::MappedFile final {
+public:
+
+    MappedFile(const std::string& path) : _data(nullptr), _size(0) {
+#ifdef _WIN32
+        std::ifstream f(path, std::ios::binary);
+        if (!f) {
+            throw RuntimeError("Could not open module '" + path + "'");
+        }
+        std::vector<char> content((std::istreambuf_iterator<char>(f)), std::istreambuf_iterator<char>());
+        _buffer.resize((content.size() + sizeof(uint64_t) - 1) / sizeof(uint64_t));
+        std::memcpy(_buffer.data(), content.data(), content.size());
+        _data = reinterpret_cast<const uint8_t*>(_buffer.data());
+        _size = content.size();
+#else
+        int fd = open(path.c_str(), O_RDONLY);
+        if (fd < 0) {
+            throw RuntimeError("Could not open module '" + path + "'");
+        }
+
+        struct stat st;
+        if (fstat(fd, &st) != 0 || st.st_size == 0) {
+            close(fd);
+            throw RuntimeError("Could not read module '" + path + "'");
+        }
+
+        void* addr = mmap(nullptr, (size_t)st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+        close(fd);
+
+        if (addr == MAP_FAILED) {
+            throw RuntimeError("Could not map module '" + path + "'");
+        }
+
+        _data = static_cast<const uint8_t*>(addr);
+        _size = (size_t)st.st_size;
+#endif
+    }
+
+    ~MappedFile() {
+#ifndef _WIN32
+        if (_data) {
+            munmap(const_cast<uint8_t*>(_data), _size);
+        }
+#endif
+    }
+
+    const uint8_t* data() const {
+        return _data;
+    }
+
+    size_t size() const {
+        return _size;
+    }
+
+private:
+
+    const uint8_t* _data;
+    size_t _size;
+
+#ifdef _WIN32
+    std::vector<uint64_t> _buffer;
+#endif
+};
+
+// MODULE FILE
+
+void ModuleFile::write(const Program& prog, const std::string& path) {
+    std::ofstream f(path, std::ios::binary | std::ios::trunc);
+    if (!f) {
+        throw RuntimeError("Could not create module '" + path + "'");
+    }
+
+    Header header(makeHeader());
+    header.constCount = prog._constCount;
+
+    f.write(reinterpret_cast<const char*>(&header), sizeof(Header));
+
+    auto beginSection = [&](SECTION sec, uint64_t count) {
+        static const char padding[MODULE_ALIGNMENT] = {0};
+        uint64_t pos = (uint64_t)f.tellp();
+        f.write(padding, (MODULE_ALIGNMENT - pos % MODULE_ALIGNMENT) % MODULE_ALIGNMENT);
+        header.sections[sec].offset = (uint64_t)f.tellp();
+        header.sections[sec].count = count;
+    };
+
+    auto endSection = [&](SECTION sec) {
+        header.sections[sec].size = (uint64_t)f.tellp() - header.sections[sec].offset;
+    };
+
+    auto writeTable = [&](SECTION sec, const void* data, size_t count, size_t elemSize) {
+        beginSection(sec, count);
+        f.write(static_cast<const char*>(data), count * elemSize);
+        endSection(sec);
+    };
+
+    auto writeStringTable = [&](SECTION sec, const std::vector<std::string>& strings) {
+        beginSection(sec, strings.size());
+        writeStrings(f, strings);
+        endSection(sec);
+    };
+
+    writeTable(CODE, prog._code, prog._codeSize, sizeof(Instruction));
+    writeTable(METHODS, prog._methods, prog._methodCount, sizeof(MethodInfo));
+    writeTable(CLASSES, prog._classes, prog._classCount, sizeof(ClassInfo));
+    writeTable(POSITIONS, prog._positions, prog._positionCount, sizeof(SourcePosition));
+    writeStringTable(STRINGS, prog._strings);
+    writeStringTable(CONST_NAMES, prog._constNameList);
+    writeStringTable(SOURCES, prog._sources);
+
+    f.seekp(0);
+    f.write(reinterpret_cast<const char*>(&header), sizeof(Header));
+
+    if (!f) {
+        throw RuntimeError("Failed to write module '" + path + "'");
+    }
+}
+
+std::shared_ptr<Program> ModuleFile::map(const std::string& path) {
+    std::shared_ptr<MappedFile> file = std::make_shared<MappedFile>(path);
+    const uint8_t* data = file->data();
+
+    auto invalid = [&](const std::string& reason) {
+        return RuntimeError("Invalid module '" + path + "': " + reason);
+    };
+
+    if (file->size() < sizeof(Header)) {
+        throw invalid("file is too small");
+    }
+
+    Header header;
+    std::memcpy(&header, data, sizeof(Header));
+    Header expected(makeHeader());
+
+    if (std::memcmp(header.magic, expected.magic, sizeof(header.magic)) != 0) {
+        throw invalid("not a module file");
+    }
+    if (header.version != expected.version) {
+        throw invalid("format version " + utils::T_toString(header.version) +
+                      " is not supported (expected " + utils::T_toString(expected.version) + ")");
+    }
+    if (header.byteOrder != expected.byteOrder || header.sizeOfSize != expected.sizeOfSize ||
+            header.sizeOfInt != expected.sizeOfInt || header.sizeOfReal != expected.sizeOfReal ||
+            header.sizeOfInstruction != expected.sizeOfInstruction) {
+        throw invalid("compiled for a different platform");
+    }
+
+    static const size_t elemSizes[SECTION_COUNT] = {
+        sizeof(Instruction), sizeof(MethodInfo), sizeof(ClassInfo), sizeof(SourcePosition), 0, 0, 0
+    };
+
+    for (size_t i = 0; i < SECTION_COUNT; ++i) {
+        const Section& sec(header.sections[i]);
+        if (sec.offset % MODULE_ALIGNMENT != 0 || sec.offset > file->size() || sec.size > file->size() - sec.offset) {
+            throw invalid("section out of bounds");
+        }
+        if (elemSizes[i] != 0 && sec.count * elemSizes[i] != sec.size) {
+            throw invalid("table size mismatch");
+        }
+    }
+
+    std::shared_ptr<Program> prog(new Program());
+
+    prog->_code = reinterpret_cast<const Instruction*>(data + header.sections[CODE].offset);
+    prog->_codeSize = header.sections[CODE].count;
+    prog->_methods = reinterpret_cast<const MethodInfo*>(data + header.sections[METHODS].offset);
+    prog->_methodCount = header.sections[METHODS].count;
+    prog->_classes = reinterpret_cast<const ClassInfo*>(data + header.sections[CLASSES].offset);
+    prog->_classCount = header.sections[CLASSES].count;
+    prog->_positions = reinterpret_cast<const SourcePosition*>(data + header.sections[POSITIONS].offset);
+    prog->_positionCount = header.sections[POSITIONS].count;
+
+    prog->_strings = readStrings(data, header.sections[STRINGS]);
+    prog->_constNameList = readStrings(data, header.sections[CONST_NAMES]);
+    prog->_sources = readStrings(data, header.sections[SOURCES]);
+    prog->_constCount = header.constCount;
+    prog->_mapping = file;
+
+    if (prog->_methodCount == 0 || prog->_constNameList.size() > prog->_constCount) {
+        throw invalid("inconsistent tables");
+    }
+
+    for (size_t i = 0; i < prog->_methodCount; ++i) {
+        if (prog->_methods[i].entry >= prog->_codeSize) {
+            throw invalid("method entry out of bounds");
+        }
+    }
+
+    // the stored frame sizes are not trusted, since the interpreter only checks for stack overflows against them
+    prog->_ownedMethods.assign(prog->_methods, prog->_methods + prog->_methodCount);
+    prog->_methods = prog->_ownedMethods.data();
+    prog->computeFrameSizes();
+
+    std::string codeError = checkCode(*prog);
+    if (!codeError.empty()) {
+        throw invalid(codeError);
+    }
+
+    for (size_t i = 0; i < prog->_constNameList.size(); ++i) {
+        prog->_constNames[prog->_constNameList[i]] = i;
+    }
+
+    return prog;
+}
+
+ModuleFile::Header ModuleFile::makeHeader() {
+    Header header;
+    std::memset(&header, 0, sizeof(Header));
+    std::memcpy(header.magic, "SFSM", sizeof(header.magic));
+    header.version = MODULE_FORMAT_VERSION;
+    header.byteOrder = BYTE_ORDER_MARK;
+    header.sizeOfSize = sizeof(size_t);
+    header.sizeOfInt = sizeof(sfsl_int_t);
+    header.sizeOfReal = sizeof(sfsl_real_t);
+    header.sizeOfInstruction = sizeof(Instruction);
+    return header;
+}
+
+void ModuleFile::writeStrings(std::ostream& o, const std::vector<std::string>& strings) {
+    uint64_t offset = 0;
+    for (const std::string& str : strings) {
+        o.write(reinterpret_cast<const char*>(&offset), sizeof(uint64_t));
+        offset += str.size();
+    }
+    o.write(reinterpret_cast<const char*>(&offset), sizeof(uint64_t));
+
+    for (const std::string& str : strings) {
+        o.write(str.data(), str.size());
+    }
+}
+
+std::vector<std::string> ModuleFile::readStrings(const uint8_t* data, const Section& section) {
+    std::vector<std::string> strings;
+    uint64_t indexSize = (section.count + 1) * sizeof(uint64_t);
+
+    if (section.size < indexSize) {
+        throw RuntimeError("Invalid module: truncated string table");
+    }
+
+    const uint8_t* index = data + section.offset;
+    const char* chars = reinterpret_cast<const char*>(index + indexSize);
+    uint64_t charCount = section.size - indexSize;
+
+    strings.reserve(section.count);
+
+    for (uint64_t i = 0; i < section.count; ++i) {
+        uint64_t start, end;
+        std::memcpy(&start, index + i * sizeof(uint64_t), sizeof(uint64_t));
+        std::memcpy(&end, index + (i + 1) * sizeof(uint64_t), sizeof(uint64_t));
+
+        if (start > end || end > charCount) {
+            throw RuntimeError("Invalid module: corrupted string table");
+        }
+
+        strings.push_back(std::string(chars + start, end - start));
+    }
+
+    return strings;
+}
+
+std::string ModuleFile::checkCode(const Program& prog) {
+    if (prog._codeSize == 0) {
+        return "empty code";
+    }
+
+    const Instruction& last(prog._code[prog._codeSize - 1]);
+    if (last.opcode != bc::OP_RETURN && last.opcode != bc::OP_JUMP) {
+        return "code does not end with a return";
+    }
+
+    // the code of a method spans from its entry to the entry of the next method,
+    // which is the range its jumps are allowed to target
+    std::vector<std::pair<size_t, size_t>> entries;
+    for (size_t i = 0; i < prog._methodCount; ++i) {
+        entries.push_back(std::make_pair(prog._methods[i].entry, i));
+    }
+    std::sort(entries.begin(), entries.end());
+
+    for (size_t i = 0; i < entries.size(); ++i) {
+        size_t begin = entries[i].first;
+        size_t end = prog._codeSize;
+        for (size_t j = i + 1; j < entries.size(); ++j) {
+            if (entries[j].first != begin) {
+                end = entries[j].first;
+                break;
+            }
+        }
+
+        size_t frameSize = prog._methods[entries[i].second].frameSize;
+
+        for (size_t pc = begin; pc < end; ++pc) {
+            const Instruction& instr(prog._code[pc]);
+
+            switch (instr.opcode) {
+            case bc::OP_LOAD_CONST:
+            case bc::OP_STORE_CONST:
+                if (instr.arg >= prog._constCount) {
+                    return "constant index out of bounds at " + utils::T_toString(pc);
+                }
+                break;
+
+            case bc::OP_PUSH_STRING:
+                if (instr.arg >= prog._strings.size()) {
+                    return "string index out of bounds at " + utils::T_toString(pc);
+                }
+                break;
+
+            case bc::OP_IF_FALSE:
+            case bc::OP_JUMP:
+                if (instr.arg < begin || instr.arg >= end) {
+                    return "jump target out of bounds at " + utils::T_toString(pc);
+                }
+                break;
+
+            case bc::OP_MAKE_METHOD:
+                if (instr.arg >= prog._methodCount) {
+                    return "method index out of bounds at " + utils::T_toString(pc);
+                }
+                break;
+
+            case bc::OP_LOAD_STACK:
+            case bc::OP_STORE_STACK:
+                if (instr.arg >= frameSize) {
+                    return "stack index out of bounds at " + utils::T_toString(pc);
+                }
+                break;
+
+            default:
+                break;
+            }
+        }
+    }
+
+    return "";
+}
+
+}
+
+}
@@ -0,0 +1,97 @@
+//
+//  ModuleFile.h
+//  SFSL
+//
+//  Created by Romain Beguet on 18.10.16.
+//  Copyright (c) 2016 Romain Beguet. All rights reserved.
+//
+
+#ifndef __SFSL__VM_ModuleFile__
+#define __SFSL__VM_ModuleFile__
+
+#include <iostream>
+#include <cstdint>
+#include "Program.h"
+
+/**
+ * Must be incremented whenever the layout of the file, of the tables or the numbering
+ * of the opcodes changes, since modules are mapped as is.
+ */
+#define MODULE_FORMAT_VERSION 2
+
+namespace sfsl {
+
+namespace vm {
+
+/**
+ * @brief Reads and writes the binary module files of compiled programs.
+ *
+ * A module file starts with a #Header followed by its sections, each aligned on 8 bytes.
+ * The code, method, class and position tables are stored exactly as they are laid out in
+ * memory, so that a module can be memory mapped and executed without decoding any instruction.
+ * As a consequence, a module can only be loaded on a platform whose integer sizes and byte order
+ * match the ones of the platform which wrote it, which the header records.
+ *
+ * String tables (string literals, constant names and source names) are stored as an array of
+ * `count + 1` uint64 offsets relative to the end of that array, followed by the characters.
+ */
+class ModuleFile final {
+public:
+
+    /**
+     * @brief Writes the program to a module file
+     * @param prog The program to write
+     * @param path The path of the file to create
+     */
+    static void write(const Program& prog, const std::string& path);
+
+    /**
+     * @brief Maps a module file in memory and creates the program it contains.
+     * Throws a #sfsl::RuntimeError if the file is not a valid module for this platform.
+     * @param path The path of the module file
+     * @return The loaded program
+     */
+    static std::shared_ptr<Program> map(const std::string& path);
+
+private:
+
+    enum SECTION { CODE, METHODS, CLASSES, POSITIONS, STRINGS, CONST_NAMES, SOURCES, SECTION_COUNT };
+
+    struct Section final {
+        uint64_t offset;
+        uint64_t count;
+        uint64_t size;
+    };
+
+    struct Header final {
+        char magic[4];
+        uint32_t version;
+        uint32_t byteOrder;
+        uint8_t sizeOfSize;
+        uint8_t sizeOfInt;
+        uint8_t sizeOfReal;
+        uint8_t sizeOfInstruction;
+        uint64_t constCount;
+        Section sections[SECTION_COUNT];
+    };
+
+    class MappedFile;
+
+    static Header makeHeader();
+
+    static void writeStrings(std::ostream& o, const std::vector<std::string>& strings);
+    static std::vector<std::string> readStrings(const uint8_t* data, const Section& section);
+
+    /**
+     * @brief Checks that the operands of the instructions of a mapped program are within
+     * the bounds of its tables, since the interpreter uses them without checking them.
+     * @return The reason why the code is invalid, or an empty string if it is valid
+     */
+    static std::string checkCode(const Program& prog);
+};
+
+}
+
+}
+
+#endif
@@ -0,0 +1,309 @@
+//
+//  Program.cpp
+//  SFSL
+//
+//  Created by Romain Beguet on 17.10.16.
+//  Copyright (c) 2016 Romain Beguet. All rights reserved.
+//
+
+#include <algorithm>
+#include <cstring>
+#include "Program.h"
+#include "api/Errors.h"
+#include "../Compiler/Common/Reporter.h"
+
+namespace sfsl {
+
+namespace vm {
+
+static const char* const OP_NAMES[bc::OP_COUNT] = {
+    "label", "name_cst", "mk_class", "mk_mthd", "store_cst", "load_cst", "inst_class",
+    "push_u", "push_b", "push_i", "push_r", "push_s",
+    "load", "store", "ld_field", "st_field",
+    "pop", "dup", "ret", "if_false", "jump", "vcall"
+};
+
+Program::Program()
+    : _code(nullptr), _codeSize(0), _methods(nullptr), _methodCount(0), _classes(nullptr), _classCount(0),
+      _positions(nullptr), _positionCount(0), _constCount(0) {
+
+}
+
+std::shared_ptr<Program> Program::load(const bc::BytecodeBuffer& code) {
+    std::shared_ptr<Program> prog(new Program());
+    std::vector<bc::DecodedInstruction> instrs;
+    std::map<size_t, size_t> pcOfOffset;
+
+    // first pass: decode the instructions and find the index of each of them
+
+    try {
+        size_t offset = 0;
+        bc::DecodedInstruction instr;
+        while (code.decode(offset, instr)) {
+            pcOfOffset[instr.offset] = instrs.size();
+            instrs.push_back(instr);
+        }
+        pcOfOffset[offset] = instrs.size();
+    } catch (const common::CompilationFatalError& err) {
+        throw RuntimeError(err.what());
+    }
+
+    auto labelIndex = [&](size_t offset) {
+        auto it = pcOfOffset.find(offset);
+        if (it == pcOfOffset.end()) {
+            throw RuntimeError("Invalid bytecode: label at offset " + utils::T_toString(offset) + " is not bound to an instruction");
+        }
+        return it->second;
+    };
+
+    auto useConst = [&](size_t index) {
+        prog->_constCount = std::max(prog->_constCount, index + 1);
+        return index;
+    };
+
+    prog->_constNameList = code.getConstNames();
+    for (size_t i = 0; i < prog->_constNameList.size(); ++i) {
+        prog->_constNames[prog->_constNameList[i]] = useConst(i);
+    }
+
+    prog->_strings = code.getStrings();
+    prog->_sources = code.getSources();
+
+    // second pass: resolve the labels
+
+    prog->_ownedMethods.push_back(MethodInfo{0, 1, 0}); // the initialization code, `this` being unit
+    prog->_ownedCode.reserve(instrs.size());
+
+    const std::vector<bc::BytecodeBuffer::PositionEntry>& positions(code.getPositions());
+    auto nextPos = positions.begin();
+
+    for (const bc::DecodedInstruction& instr : instrs) {
+        Instruction res;
+        std::memset(&res, 0, sizeof(res)); // no garbage in the padding, which ends up in module files
+        res.opcode = instr.opcode;
+        res.arg = instr.arg;
+        res.arg2 = instr.arg2;
+
+        switch (res.opcode) {
+        case bc::OP_MAKE_METHOD:
+            res.arg = prog->_ownedMethods.size();
+            res.arg2 = labelIndex(instr.arg2);
+            prog->_ownedMethods.push_back(MethodInfo{res.arg2, instr.arg, 0});
+            break;
+
+        case bc::OP_MAKE_CLASS:
+            prog->_ownedClasses.push_back(ClassInfo{prog->_ownedCode.size(), res.arg, res.arg2, (size_t)-1});
+            break;
+
+        case bc::OP_STORE_CONST:
+            if (!prog->_ownedClasses.empty() && prog->_ownedClasses.back().pc + 1 == prog->_ownedCode.size()) {
+                prog->_ownedClasses.back().constIndex = res.arg;
+            }
+            useConst(res.arg);
+            break;
+
+        case bc::OP_LOAD_CONST:
+            useConst(res.arg);
+            break;
+
+        case bc::OP_PUSH_STRING:
+            if (res.arg >= prog->_strings.size()) {
+                throw RuntimeError("Invalid bytecode: string index out of bounds");
+            }
+            break;
+
+        case bc::OP_IF_FALSE:
+        case bc::OP_JUMP:
+            res.arg = labelIndex(instr.arg);
+            break;
+
+        default:
+            break;
+        }
+
+        for (; nextPos != positions.end() && nextPos->offset <= instr.offset; ++nextPos) {
+            prog->_ownedPositions.push_back(SourcePosition{prog->_ownedCode.size(), nextPos->source, nextPos->start, nextPos->end});
+        }
+
+        prog->_ownedCode.push_back(res);
+    }
+
+    prog->useOwnedTables();
+    prog->computeFrameSizes();
+
+    return prog;
+}
+
+const Instruction* Program::getCode() const {
+    return _code;
+}
+
+size_t Program::getCodeSize() const {
+    return _codeSize;
+}
+
+const MethodInfo& Program::getMethod(size_t index) const {
+    return _methods[index];
+}
+
+size_t Program::getMethodCount() const {
+    return _methodCount;
+}
+
+const ClassInfo& Program::getClass(size_t index) const {
+    return _classes[index];
+}
+
+size_t Program::getClassCount() const {
+    return _classCount;
+}
+
+const std::string& Program::getString(size_t index) const {
+    return _strings[index];
+}
+
+size_t Program::getConstCount() const {
+    return _constCount;
+}
+
+bool Program::findConst(const std::string& name, size_t& index) const {
+    auto it = _constNames.find(name);
+    if (it != _constNames.end()) {
+        index = it->second;
+        return true;
+    }
+    return false;
+}
+
+std::string Program::positionStr(size_t pc) const {
+    auto it = std::upper_bound(_positions, _positions + _positionCount, pc,
+                               [](size_t p, const SourcePosition& pos) { return p < pos.pc; });
+
+    if (pc >= _codeSize || it == _positions || (it - 1)->source >= _sources.size()) {
+        return "<unknown>";
+    }
+    const SourcePosition& pos(*(it - 1));
+    return _sources[pos.source] + ":" + utils::T_toString(pos.start) + ":" + utils::T_toString(pos.end);
+}
+
+void Program::dump(std::ostream& o) const {
+    o << "constants (" << _constCount << "):" << std::endl;
+    for (size_t i = 0; i < _constNameList.size(); ++i) {
+        o << "\t" << i << "\t" << _constNameList[i] << std::endl;
+    }
+
+    o << "classes (" << _classCount << "):" << std::endl;
+    for (size_t i = 0; i < _classCount; ++i) {
+        const ClassInfo& clss(_classes[i]);
+        o << "\t@" << clss.pc << "\tfields: " << clss.fieldCount << "\tmethods: " << clss.methodCount;
+        if (clss.constIndex < _constNameList.size()) {
+            o << "\t" << _constNameList[clss.constIndex];
+        }
+        o << std::endl;
+    }
+
+    o << "methods (" << _methodCount << "):" << std::endl;
+    for (size_t i = 0; i < _methodCount; ++i) {
+        o << "\t" << i << "\t@" << _methods[i].entry << "\tvars: " << _methods[i].varCount
+          << "\tframe: " << _methods[i].frameSize << std::endl;
+    }
+
+    o << "code (" << _codeSize << "):" << std::endl;
+    for (size_t pc = 0; pc < _codeSize; ++pc) {
+        const Instruction& instr(_code[pc]);
+        o << "\t" << pc << "\t" << (instr.opcode < bc::OP_COUNT ? OP_NAMES[instr.opcode] : "???");
+
+        switch (instr.opcode) {
+        case bc::OP_MAKE_CLASS:
+        case bc::OP_MAKE_METHOD:
+        case bc::OP_VCALL:      o << "\t" << instr.arg << "\t" << instr.arg2; break;
+        case bc::OP_PUSH_INT:   o << "\t" << instr.intValue; break;
+        case bc::OP_PUSH_REAL:  o << "\t" << instr.realValue; break;
+        case bc::OP_PUSH_STRING:
+            o << "\t\"" << (instr.arg < _strings.size() ? _strings[instr.arg] : "???") << "\"";
+            break;
+        case bc::OP_INSTANTIATE:
+        case bc::OP_PUSH_UNIT:
+        case bc::OP_POP:
+        case bc::OP_DUP:
+        case bc::OP_RETURN:     break;
+        default:                o << "\t" << instr.arg; break;
+        }
+
+        o << "\t<" << positionStr(pc) << ">" << std::endl;
+    }
+}
+
+void Program::computeFrameSizes() {
+    // Simulates the stack depth through the code of each method, which spans from its entry
+    // to the entry of the next method (the bodies are laid out one after the other, after the
+    // initialization code). Branches are structured, so the depth at a jump target is the depth
+    // at the jump.
+
+    std::vector<size_t> entries;
+    for (const MethodInfo& info : _ownedMethods) {
+        entries.push_back(info.entry);
+    }
+    entries.push_back(_codeSize);
+    std::sort(entries.begin(), entries.end());
+
+    for (MethodInfo& info : _ownedMethods) {
+        size_t end = *std::upper_bound(entries.begin(), entries.end(), info.entry);
+        std::map<size_t, long> targets;
+        long depth = 0;
+        long maxDepth = 0;
+
+        for (size_t pc = info.entry; pc < end; ++pc) {
+            const Instruction& instr(_code[pc]);
+
+            auto target = targets.find(pc);
+            if (target != targets.end()) {
+                depth = target->second;
+                targets.erase(target);
+            }
+
+            switch (instr.opcode) {
+            case bc::OP_MAKE_CLASS:         depth += 1 - (long)instr.arg2; break;
+            case bc::OP_VCALL:              depth -= (long)instr.arg2; break;
+            case bc::OP_IF_FALSE:           depth -= 1; targets[instr.arg] = depth; break;
+            case bc::OP_JUMP:               targets[instr.arg] = depth; break;
+
+            case bc::OP_MAKE_METHOD:
+            case bc::OP_LOAD_CONST:
+            case bc::OP_PUSH_UNIT:
+            case bc::OP_PUSH_BOOL:
+            case bc::OP_PUSH_INT:
+            case bc::OP_PUSH_REAL:
+            case bc::OP_PUSH_STRING:
+            case bc::OP_LOAD_STACK:
+            case bc::OP_DUP:                depth += 1; break;
+
+            case bc::OP_STORE_CONST:
+            case bc::OP_STORE_FIELD:
+            case bc::OP_POP:
+            case bc::OP_RETURN:             depth -= 1; break;
+
+            default:                        break;
+            }
+
+            maxDepth = std::max(maxDepth, depth);
+        }
+
+        info.frameSize = info.varCount + (size_t)maxDepth;
+    }
+}
+
+void Program::useOwnedTables() {
+    _code = _ownedCode.data();
+    _codeSize = _ownedCode.size();
+    _methods = _ownedMethods.data();
+    _methodCount = _ownedMethods.size();
+    _classes = _ownedClasses.data();
+    _classCount = _ownedClasses.size();
+    _positions = _ownedPositions.data();
+    _positionCount = _ownedPositions.size();
+}
+
+}
+
+}
@@ -0,0 +1,164 @@
+//
+//  Program.h
+//  SFSL
+//
+//  Created by Romain Beguet on 17.10.16.
+//  Copyright (c) 2016 Romain Beguet. All rights reserved.
+//
+
+#ifndef __SFSL__VM_Program__
+#define __SFSL__VM_Program__
+
+#include <iostream>
+#include <vector>
+#include <map>
+#include <memory>
+#include "../Compiler/Backend/Bytecode/BytecodeBuffer.h"
+
+namespace sfsl {
+
+namespace vm {
+
+/**
+ * @brief A bytecode instruction in the form executed by the interpreter:
+ * labels are resolved to instruction indices, and the operands are stored inline.
+ *
+ * Operands by opcode:
+ * - LOAD/STORE_CONST, LOAD/STORE_STACK, LOAD/STORE_FIELD: arg = index
+ * - MAKE_CLASS: arg = attribute count, arg2 = method count
+ * - MAKE_METHOD: arg = method index (see #Program::getMethod), arg2 = index of the first instruction of the method
+ * - PUSH_BOOL: arg = 0 or 1, PUSH_INT: intValue, PUSH_REAL: realValue, PUSH_STRING: arg = string index
+ * - IF_FALSE, JUMP: arg = target instruction index
+ * - VCALL: arg = method index in the virtual table, arg2 = argument count
+ */
+struct Instruction final {
+    bc::OP_CODE opcode;
+    size_t arg;
+    union {
+        size_t arg2;
+        sfsl_int_t intValue;
+        sfsl_real_t realValue;
+    };
+};
+
+/**
+ * @brief Static informations about a method of the program: the index of its first instruction,
+ * its number of local variables (`this` and the arguments included) and an upper bound of the
+ * number of stack slots used by one of its frames.
+ */
+struct MethodInfo final {
+    size_t entry;
+    size_t varCount;
+    size_t frameSize;
+};
+
+/**
+ * @brief The source position of the instructions starting at index `pc`, up to the next
+ * position entry. `source` indexes the source names of the program.
+ */
+struct SourcePosition final {
+    size_t pc;
+    size_t source;
+    size_t start;
+    size_t end;
+};
+
+/**
+ * @brief Static informations about a class created by the program: the index of its
+ * MAKE_CLASS instruction, its number of fields and methods, and the constant pool slot
+ * in which it is stored (or -1 if it is not stored directly).
+ */
+struct ClassInfo final {
+    size_t pc;
+    size_t fieldCount;
+    size_t methodCount;
+    size_t constIndex;
+};
+
+/**
+ * @brief A program ready to be executed by the interpreter.
+ * The method at index 0 is the initialization code of the program, which
+ * creates all the definitions and stores them in the constant pool.
+ *
+ * The code, method, class and position tables are either owned by the program or point
+ * into a memory mapped module file (see #sfsl::vm::ModuleFile), in which case the
+ * program keeps the mapping alive.
+ */
+class Program final {
+public:
+
+    /**
+     * @brief Creates a program from the output of the bytecode generator
+     * @param code The buffer containing the emitted bytecode
+     * @return The created program
+     */
+    static std::shared_ptr<Program> load(const bc::BytecodeBuffer& code);
+
+    const Instruction* getCode() const;
+    size_t getCodeSize() const;
+
+    const MethodInfo& getMethod(size_t index) const;
+    size_t getMethodCount() const;
+
+    const ClassInfo& getClass(size_t index) const;
+    size_t getClassCount() const;
+
+    const std::string& getString(size_t index) const;
+
+    size_t getConstCount() const;
+
+    /**
+     * @param name The name of the constant
+     * @param index Filled with the index of the constant, if found
+     * @return True if a constant with the given name exists
+     */
+    bool findConst(const std::string& name, size_t& index) const;
+
+    /**
+     * @return A string of the form "source:start:end" for the instruction at the given index
+     */
+    std::string positionStr(size_t pc) const;
+
+    /**
+     * @brief Prints the tables and the code of the program in a human readable form
+     */
+    void dump(std::ostream& o) const;
+
+private:
+    friend class ModuleFile;
+
+    Program();
+
+    /**
+     * @brief Computes the frame size of each owned method from the current code table
+     */
+    void computeFrameSizes();
+    void useOwnedTables();
+
+    const Instruction* _code;
+    size_t _codeSize;
+    const MethodInfo* _methods;
+    size_t _methodCount;
+    const ClassInfo* _classes;
+    size_t _classCount;
+    const SourcePosition* _positions;
+    size_t _positionCount;
+
+    std::vector<Instruction> _ownedCode;
+    std::vector<MethodInfo> _ownedMethods;
+    std::vector<ClassInfo> _ownedClasses;
+    std::vector<SourcePosition> _ownedPositions;
+    std::shared_ptr<const void> _mapping;
+
+    std::vector<std::string> _strings;
+    std::vector<std::string> _sources;
+    std::vector<std::string> _constNameList;
+    std::map<std::string, size_t> _constNames;
+    size_t _constCount;
+};
+
+}
+
+}
+
+#endif
@@ -1,6 +1,5 @@
 #include <iostream>
 #include <fstream>
-#include <sstream>
 #include <vector>
 #include <memory>
 #include "unistd.h"
@@ -13,33 +12,51 @@ using namespace sfsl;
 int main(int argc, char** argv) {
     // LOAD FILE
 
-    char* sourceFile = NULL;
+    std::vector<std::string> sourceFiles;
+    char* moduleFile = NULL;
+    char* memoryStatsFile = NULL;
     bool checkOnly = false;
+    bool dumpModule = false;
     int option;
 
-    while((option = getopt(argc, argv, "c")) != -1) {
+    while((option = getopt(argc, argv, "co:dm:")) != -1) {
         switch (option) {
         case 'c':
             checkOnly = true;
             break;
+        case 'o':
+            moduleFile = optarg;
+            break;
+        case 'd':
+            dumpModule = true;
+            break;
+        case 'm':
+            memoryStatsFile = optarg;
+            break;
         default:
             std::cerr << "unexpected program argument : " << option << std::endl;
             break;
         }
     }
 
-    if (optind < argc) {
-        sourceFile = argv[optind++];
-    } else {
+    while (optind < argc) {
+        sourceFiles.push_back(argv[optind++]);
+    }
+
+    if (sourceFiles.empty()) {
         std::cerr << "missing source file" << std::endl;
         return 1;
     }
 
-    std::ifstream f(sourceFile);
-    std::stringstream buffer;
-    buffer << f.rdbuf();
-
-    std::string source = buffer.str();
+    if (dumpModule) {
+        try {
+            VirtualMachine::load(sourceFiles.front()).dump(std::cout);
+            return 0;
+        } catch (const RuntimeError& ex) {
+            std::cerr << ex.what() << std::endl;
+            return 1;
+        }
+    }
 
     Compiler cmp(CompilerConfig()
                  .with<opt::Reporter>(StandartReporter::CerrReporter)
@@ -49,30 +66,46 @@ int main(int argc, char** argv) {
     Pipeline ppl = Pipeline::createDefault();
 
     ByteCodeCollector bcc;
+    VMCollector vmc;
     EmptyCollector emc;
     AbstractOutputCollector* col;
 
     try {
         cmp.loadPlugin(STDLIBNAME);
 
-        ProgramBuilder builder = cmp.parse(sourceFile, source);
+        ProgramBuilder builder = sourceFiles.size() == 1 ? cmp.parseFile(sourceFiles.front()) : cmp.parseFiles(sourceFiles);
 
         if (checkOnly) {
             col = &emc;
             ppl.insert(Phase::StopRightBefore("PreTransform"));
+        } else if (moduleFile) {
+            col = &vmc;
         } else {
             col = &bcc;
         }
 
         cmp.compile(builder, *col, ppl);
 
-        if (!checkOnly) {
+        if (checkOnly) {
+            // nothing to output
+        } else if (moduleFile) {
+            if (VirtualMachine vm = vmc.get()) {
+                vm.save(moduleFile);
+            }
+        } else {
             for (const std::string& i : bcc.get()) {
                 std::cout << i << std::endl;
             }
         }
 
+        if (memoryStatsFile) {
+            std::ofstream stats(memoryStatsFile);
+            cmp.dumpMemoryStats(stats);
+        }
+
     } catch(const CompileError& ex) {
         std::cerr << ex.what() << std::endl;
+    } catch(const RuntimeError& ex) {
+        std::cerr << ex.what() << std::endl;
     }
 }
@@ -0,0 +1,139 @@
+//
+//  CharScanningTests.cpp
+//  SFSL
+//
+//  Created by Romain Beguet on 24.10.16.
+//  Copyright (c) 2016 Romain Beguet. All rights reserved.
+//
+
+#include <vector>
+#include <algorithm>
+
+#include "CharScanningTests.h"
+#include "AbstractTest.h"
+#include "../src/Compiler/Frontend/Lexer/CharScanning.h"
+
+namespace sfsl {
+
+namespace test {
+
+typedef const char* (*Scanner)(const char* begin, const char* end);
+
+static const size_t MAX_LENGTH = 70;
+static const size_t MAX_OFFSET = 32;
+
+static const char* scalarSkipWhiteSpaces(const char* begin, const char* end) {
+    while (begin < end && (*begin == ' ' || *begin == '\t' || *begin == '\n' || *begin == '\r')) {
+        ++begin;
+    }
+    return begin;
+}
+
+static const char* scalarFindNewLine(const char* begin, const char* end) {
+    while (begin < end && *begin != '\n' && *begin != '\r') {
+        ++begin;
+    }
+    return begin;
+}
+
+static const char* scalarFindCommentEnd(const char* begin, const char* end) {
+    for (; begin < end; ++begin) {
+        if (*begin == '*' && begin + 1 < end && begin[1] == '/') {
+            return begin;
+        }
+    }
+    return end;
+}
+
+static const char* scalarFindStringLiteralStop(const char* begin, const char* end) {
+    while (begin < end && *begin != '\"' && *begin != '\\' && *begin != '\n' && *begin != '\r') {
+        ++begin;
+    }
+    return begin;
+}
+
+/**
+ * @brief Compares a scanner with its scalar reference on every range of up to #MAX_LENGTH bytes
+ * starting at every offset below #MAX_OFFSET, with each delimiter written at every position of the
+ * range (including across the boundaries of the blocks tested at once) or nowhere, and another
+ * delimiter right after the end of the range, which must never be found.
+ */
+class ScannerTest final : public AbstractTest {
+public:
+    ScannerTest(const std::string& name, Scanner scanner, Scanner reference,
+                const std::string& filler, const std::vector<std::string>& delimiters)
+        : AbstractTest(name), _scanner(scanner), _reference(reference), _filler(filler), _delimiters(delimiters) {
+
+    }
+
+    virtual ~ScannerTest() {
+
+    }
+
+    virtual bool run(AbstractTestLogger& logger) override {
+        std::vector<char> buffer(MAX_OFFSET + MAX_LENGTH + 64);
+
+        for (size_t length = 0; length <= MAX_LENGTH; ++length) {
+            for (size_t offset = 0; offset < MAX_OFFSET; ++offset) {
+                for (const std::string& delimiter : _delimiters) {
+                    for (long pos = -1; pos < (long)length; ++pos) {
+                        for (size_t i = 0; i < buffer.size(); ++i) {
+                            buffer[i] = _filler[i % _filler.size()];
+                        }
+
+                        const char* begin = buffer.data() + offset;
+                        const char* end = begin + length;
+
+                        std::copy(delimiter.begin(), delimiter.end(), buffer.begin() + offset + length);
+                        if (pos >= 0) {
+                            std::copy(delimiter.begin(), delimiter.end(), buffer.begin() + offset + pos);
+                        }
+
+                        const char* found = _scanner(begin, end);
+                        const char* expected = _reference(begin, end);
+
+                        if (found != expected) {
+                            logger.result(_name, false, "length " + std::to_string(length) +
+                                          ", offset " + std::to_string(offset) +
+                                          ", delimiter at " + std::to_string(pos) +
+                                          ": found " + std::to_string(found - begin) +
+                                          " instead of " + std::to_string(expected - begin));
+                            return false;
+                        }
+                    }
+                }
+            }
+        }
+
+        logger.result(_name, true, "");
+        return true;
+    }
+
+private:
+
+    const Scanner _scanner;
+    const Scanner _reference;
+    const std::string _filler;
+    const std::vector<std::string> _delimiters;
+};
+
+TestRunner* buildCharScanningTests() {
+    TestSuiteBuilder scanners("Scanners");
+
+    scanners.addTest(new ScannerTest("White spaces", lex::scan::skipWhiteSpaces, scalarSkipWhiteSpaces,
+                                     " \t\n\r", {"a", "\v", "\x80"}));
+    scanners.addTest(new ScannerTest("New lines", lex::scan::findNewLine, scalarFindNewLine,
+                                     "a \t*", {"\n", "\r", "\r\n"}));
+    scanners.addTest(new ScannerTest("Comment ends", lex::scan::findCommentEnd, scalarFindCommentEnd,
+                                     "*a/", {"*/", "**/", "*"}));
+    scanners.addTest(new ScannerTest("Comment ends after stars", lex::scan::findCommentEnd, scalarFindCommentEnd,
+                                     "*", {"/", "*/"}));
+    scanners.addTest(new ScannerTest("String literal stops", lex::scan::findStringLiteralStop, scalarFindStringLiteralStop,
+                                     "a '/", {"\"", "\\", "\n", "\r"}));
+
+    return new TestRunner("CharScanningTests", {scanners.build()});
+}
+
+}
+
+}
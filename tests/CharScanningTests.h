@@ -0,0 +1,26 @@
+//
+//  CharScanningTests.h
+//  SFSL
+//
+//  Created by Romain Beguet on 24.10.16.
+//  Copyright (c) 2016 Romain Beguet. All rights reserved.
+//
+
+#ifndef __SFSL__CharScanningTests__
+#define __SFSL__CharScanningTests__
+
+#include <iostream>
+
+#include "TestRunner.h"
+
+namespace sfsl {
+
+namespace test {
+
+TestRunner* buildCharScanningTests();
+
+}
+
+}
+
+#endif
@@ -0,0 +1,355 @@
+//
+//  EnvironmentTests.cpp
+//  SFSL
+//
+//  Created by Romain Beguet on 25.10.16.
+//  Copyright (c) 2016 Romain Beguet. All rights reserved.
+//
+
+#include <vector>
+#include <random>
+#include <algorithm>
+
+#include "EnvironmentTests.h"
+#include "AbstractTest.h"
+#include "../src/Compiler/Common/MemoryManager.h"
+#include "../src/Compiler/Frontend/Types/Types.h"
+#include "../src/Utils/Utils.h"
+
+namespace sfsl {
+
+namespace test {
+
+using namespace type;
+
+/**
+ * @brief A plain vector of substitutions which behaves as an #Environment should:
+ * sorted by key, the substitution inserted last being found first.
+ */
+class EnvironmentModel final {
+public:
+
+    void insert(Type* key, Type* value) {
+        Environment::Substitution sub(common::VAR_T_NONE, key, value);
+        _subs.insert(std::lower_bound(_subs.begin(), _subs.end(), sub, keyLess), sub);
+    }
+
+    void set(Type* key, Type* value) {
+        for (Environment::Substitution& sub : _subs) {
+            if (sub.key == key) {
+                sub.value = value;
+                return;
+            }
+        }
+        insert(key, value);
+    }
+
+    Type* find(Type* key, bool& found) const {
+        for (const Environment::Substitution& sub : _subs) {
+            if (sub.key == key) {
+                found = true;
+                return sub.value;
+            }
+        }
+        found = false;
+        return key;
+    }
+
+    bool substituteAll(const EnvironmentModel& other) {
+        if (_subs.empty() || other._subs.empty()) {
+            return false;
+        }
+
+        bool matched = false;
+        for (Environment::Substitution& sub : _subs) {
+            bool found;
+            sub.value = other.find(sub.value, found);
+            matched |= found;
+        }
+        return matched;
+    }
+
+    bool matches(const Environment& env) const {
+        if (env.size() != _subs.size()) {
+            return false;
+        }
+
+        size_t i = 0;
+        for (const Environment::Substitution& sub : env) {
+            if (sub.key != _subs[i].key || sub.value != _subs[i].value) {
+                return false;
+            }
+            ++i;
+        }
+        return true;
+    }
+
+private:
+
+    static bool keyLess(const Environment::Substitution& a, const Environment::Substitution& b) {
+        return a.key < b.key;
+    }
+
+    std::vector<Environment::Substitution> _subs;
+};
+
+/**
+ * @brief Provides the types used as keys and values of the tested environments
+ */
+class TypePool final {
+public:
+    TypePool(size_t count) : _mngr(1024) {
+        for (size_t i = 0; i < count; ++i) {
+            _types.push_back(_mngr.New<TypeToBeInferred>(std::vector<Typed*>()));
+        }
+    }
+
+    Type* operator [](size_t i) const {
+        return _types[i];
+    }
+
+    size_t size() const {
+        return _types.size();
+    }
+
+private:
+    common::ChunkedMemoryManager _mngr;
+    std::vector<Type*> _types;
+};
+
+/**
+ * @brief An environment built along with its model
+ */
+struct TestedEnvironment final {
+    Environment env;
+    EnvironmentModel model;
+
+    void insert(Type* key, Type* value) {
+        env.insert(Environment::Substitution(common::VAR_T_NONE, key, value));
+        model.insert(key, value);
+    }
+
+    void set(Type* key, Type* value) {
+        env[key] = value;
+        model.set(key, value);
+    }
+
+    bool substituteAll(const TestedEnvironment& other) {
+        return env.substituteAll(other.env) == model.substituteAll(other.model);
+    }
+
+    bool ok() const {
+        return model.matches(env);
+    }
+};
+
+/**
+ * @brief Builds an environment mapping the first types of the pool to the following ones
+ */
+static TestedEnvironment makeEnvironment(const TypePool& types, size_t size, size_t valueOffset) {
+    TestedEnvironment tested;
+    for (size_t i = 0; i < size; ++i) {
+        tested.insert(types[i], types[(i + valueOffset) % types.size()]);
+    }
+    return tested;
+}
+
+class CopyOnWriteTest final : public AbstractTest {
+public:
+    enum MUTATION { MUT_SET, MUT_INSERT, MUT_SUBSTITUTE };
+
+    CopyOnWriteTest(const std::string& name, MUTATION mutation) : AbstractTest(name), _mutation(mutation) {}
+
+    virtual bool run(AbstractTestLogger& logger) override {
+        TypePool types(32);
+
+        // covers the inline environments as well as the shared blocks
+        for (size_t size = 0; size <= 12; ++size) {
+            for (bool mutateCopy : {true, false}) {
+                TestedEnvironment original = makeEnvironment(types, size, 1);
+                TestedEnvironment copy = original;
+
+                TestedEnvironment& mutated = mutateCopy ? copy : original;
+                TestedEnvironment& untouched = mutateCopy ? original : copy;
+
+                if (!mutate(types, mutated, size)) {
+                    logger.result(_name, false, "mutation of an environment of size " + utils::T_toString(size) + " is wrong");
+                    return false;
+                }
+
+                if (!mutated.ok() || !untouched.ok()) {
+                    logger.result(_name, false, std::string("mutating the ") + (mutateCopy ? "copy" : "original") +
+                                  " of an environment of size " + utils::T_toString(size) + " changed the other one");
+                    return false;
+                }
+            }
+        }
+
+        logger.result(_name, true, "");
+        return true;
+    }
+
+private:
+
+    bool mutate(const TypePool& types, TestedEnvironment& tested, size_t size) const {
+        switch (_mutation) {
+        case MUT_SET:
+            tested.set(types[size / 2], types[31]);
+            return true;
+        case MUT_INSERT:
+            tested.insert(types[size / 2], types[31]);
+            return true;
+        case MUT_SUBSTITUTE:
+            return tested.substituteAll(makeEnvironment(types, 32, 3));
+        }
+        return false;
+    }
+
+    MUTATION _mutation;
+};
+
+class CompositionTest final : public AbstractTest {
+public:
+    CompositionTest(const std::string& name) : AbstractTest(name) {}
+
+    virtual bool run(AbstractTestLogger& logger) override {
+        TypePool types(32);
+
+        for (size_t size = 3; size <= 12; ++size) {
+            for (size_t operandSize = 1; operandSize <= 5; ++operandSize) {
+                std::string desc = " (" + utils::T_toString(size) + " substitutions composed with " +
+                        utils::T_toString(operandSize) + ")";
+
+                TestedEnvironment source = makeEnvironment(types, size, 1);
+
+                // the operand maps the values of the source to other types
+                TestedEnvironment operand;
+                for (size_t i = 0; i < operandSize; ++i) {
+                    operand.insert(types[i + 1], types[16 + i]);
+                }
+
+                TestedEnvironment first = source;
+                if (!first.substituteAll(operand) || !first.ok()) {
+                    logger.result(_name, false, "first composition is wrong" + desc);
+                    return false;
+                }
+
+                // same keys, other values: the remembered result must not be reused
+                operand.set(types[1], types[30]);
+
+                TestedEnvironment second = source;
+                if (!second.substituteAll(operand) || !second.ok()) {
+                    logger.result(_name, false, "composition after the operand changed is wrong" + desc);
+                    return false;
+                }
+
+                // an equal operand built elsewhere must get the same result
+                TestedEnvironment equalOperand;
+                for (const Environment::Substitution& sub : operand.env) {
+                    equalOperand.insert(sub.key, sub.value);
+                }
+
+                TestedEnvironment third = source;
+                if (!third.substituteAll(equalOperand) || !third.ok()) {
+                    logger.result(_name, false, "composition with an equal operand is wrong" + desc);
+                    return false;
+                }
+
+                // the source itself changes after it was composed
+                source.set(types[0], types[2]);
+
+                TestedEnvironment fourth = source;
+                if (!fourth.substituteAll(operand) || !fourth.ok()) {
+                    logger.result(_name, false, "composition after the source changed is wrong" + desc);
+                    return false;
+                }
+
+                if (!first.ok() || !second.ok() || !third.ok() || !source.ok()) {
+                    logger.result(_name, false, "a composition changed another environment" + desc);
+                    return false;
+                }
+            }
+        }
+
+        logger.result(_name, true, "");
+        return true;
+    }
+};
+
+class RandomOperationsTest final : public AbstractTest {
+public:
+    RandomOperationsTest(const std::string& name, size_t typeCount, size_t steps)
+        : AbstractTest(name), _typeCount(typeCount), _steps(steps) {}
+
+    virtual bool run(AbstractTestLogger& logger) override {
+        TypePool types(_typeCount);
+        std::vector<TestedEnvironment> envs(6);
+        std::mt19937 rng(42);
+
+        for (size_t step = 0; step < _steps; ++step) {
+            TestedEnvironment& target = envs[rng() % envs.size()];
+            const TestedEnvironment& other = envs[rng() % envs.size()];
+
+            bool ok = true;
+
+            switch (rng() % 6) {
+            case 0:
+                if (&target != &other) {
+                    target = other;
+                }
+                break;
+            case 1:
+            case 2:
+                if (target.env.size() < 16) {
+                    target.insert(types[rng() % _typeCount], types[rng() % _typeCount]);
+                }
+                break;
+            case 3:
+                target.set(types[rng() % _typeCount], types[rng() % _typeCount]);
+                break;
+            default:
+                if (&target != &other) {
+                    ok = target.substituteAll(other);
+                }
+                break;
+            }
+
+            for (const TestedEnvironment& tested : envs) {
+                ok &= tested.ok();
+            }
+
+            if (!ok) {
+                logger.result(_name, false, "environments differ from their model after step " + utils::T_toString(step));
+                return false;
+            }
+        }
+
+        logger.result(_name, true, "");
+        return true;
+    }
+
+private:
+
+    size_t _typeCount;
+    size_t _steps;
+};
+
+TestRunner* buildEnvironmentTests() {
+    TestSuiteBuilder cow("CopyOnWrite");
+
+    cow.addTest(new CopyOnWriteTest("Subscript", CopyOnWriteTest::MUT_SET));
+    cow.addTest(new CopyOnWriteTest("Insertion", CopyOnWriteTest::MUT_INSERT));
+    cow.addTest(new CopyOnWriteTest("Substitution", CopyOnWriteTest::MUT_SUBSTITUTE));
+
+    TestSuiteBuilder composition("Composition");
+
+    composition.addTest(new CompositionTest("Changed operands"));
+    composition.addTest(new RandomOperationsTest("Random operations on few types", 6, 20000));
+    composition.addTest(new RandomOperationsTest("Random operations on many types", 24, 20000));
+
+    return new TestRunner("EnvironmentTests", {cow.build(), composition.build()});
+}
+
+}
+
+}
@@ -0,0 +1,26 @@
+//
+//  EnvironmentTests.h
+//  SFSL
+//
+//  Created by Romain Beguet on 25.10.16.
+//  Copyright (c) 2016 Romain Beguet. All rights reserved.
+//
+
+#ifndef __SFSL__EnvironmentTests__
+#define __SFSL__EnvironmentTests__
+
+#include <iostream>
+
+#include "TestRunner.h"
+
+namespace sfsl {
+
+namespace test {
+
+TestRunner* buildEnvironmentTests();
+
+}
+
+}
+
+#endif
@@ -14,6 +14,7 @@
 #include "CompilationTest.h"
 #include "SymbolicTest.h"
 #include "CapturesTest.h"
+#include "ParsingTest.h"
 
 namespace sfsl {
 
@@ -36,7 +37,7 @@ TestRunner* FileSystemTestGenerator::findAndGenerate() {
 
     if (DIR* root = opendir(_path.c_str())) {
         while (dirent* ent = readdir(root)) {
-            std::string entryName(ent->d_name, ent->d_namlen);
+            std::string entryName(ent->d_name);
 
             if (isValidEntryName(entryName)) {
                 std::string subdirPath = _path + "/" + entryName;
@@ -68,7 +69,7 @@ FileSystemTestGenerator::TEST_TYPE FileSystemTestGenerator::typeFromName(const s
 
 void FileSystemTestGenerator::buildTestSuite(TestSuiteBuilder& builder, const std::string& path, DIR* dir) {
     while (dirent* ent = readdir(dir)) {
-        std::string entryName(ent->d_name, ent->d_namlen);
+        std::string entryName(ent->d_name);
         TEST_TYPE type = typeFromName(entryName);
 
         if (isValidEntryName(entryName) && type != UNKNOWN_TEST_TYPE) {
@@ -84,7 +85,7 @@ void FileSystemTestGenerator::buildTestSuite(TestSuiteBuilder& builder, const st
 
 void FileSystemTestGenerator::createTestsForType(TestSuiteBuilder& builder, FileSystemTestGenerator::TEST_TYPE type, const std::string& path, DIR* dir) {
     while (dirent* ent = readdir(dir)) {
-        std::string testPath(ent->d_name, ent->d_namlen);
+        std::string testPath(ent->d_name);
 
         if (isValidEntryName(testPath)) {
             std::string testName = testNameFromTestPath(testPath);
@@ -99,6 +100,8 @@ void FileSystemTestGenerator::createTestsForType(TestSuiteBuilder& builder, File
                 builder.addTest(new SymbolicTest(testName, source));
             } else if (builder.getName() == "Captures") {
                 builder.addTest(new CapturesTest(testName, source, type == MUST_COMPILE));
+            } else if (builder.getName() == "Parsing") {
+                builder.addTest(new ParsingTest(testName, source, type == MUST_COMPILE));
             } else {
                 builder.addTest(new CompilationTest(testName, source, type == MUST_COMPILE, builder.getName()));
             }
@@ -0,0 +1,275 @@
+//
+//  MemoryManagerTests.cpp
+//  SFSL
+//
+//  Created by Romain Beguet on 19.10.16.
+//  Copyright (c) 2016 Romain Beguet. All rights reserved.
+//
+
+#include <atomic>
+#include <thread>
+#include <vector>
+#include <algorithm>
+
+#include "MemoryManagerTests.h"
+#include "AbstractTest.h"
+#include "../src/Compiler/Common/MemoryManager.h"
+
+namespace sfsl {
+
+namespace test {
+
+using namespace common;
+
+class Tracked final : public MemoryManageable {
+public:
+    Tracked(std::atomic<size_t>* destroyed, size_t value) : _destroyed(destroyed), _value(value) {}
+
+    virtual ~Tracked() {
+        ++*_destroyed;
+    }
+
+    size_t getValue() const {
+        return _value;
+    }
+
+private:
+    std::atomic<size_t>* _destroyed;
+    size_t _value;
+};
+
+/**
+ * @brief Same as #Tracked, but declared trivially manageable, so that its destructor is never called
+ */
+class Untracked final : public MemoryManageable {
+public:
+    Untracked(std::atomic<size_t>* destroyed) : _destroyed(destroyed) {}
+
+    virtual ~Untracked() {
+        ++*_destroyed;
+    }
+
+private:
+    std::atomic<size_t>* _destroyed;
+};
+
+}
+
+}
+
+SFSL_TRIVIALLY_MANAGEABLE(sfsl::test::Untracked)
+
+namespace sfsl {
+
+namespace test {
+
+/**
+ * @brief Allocates objects from several threads through the same manager, then checks
+ * that no two objects overlap and that all of them are destroyed with the manager.
+ */
+class ConcurrentAllocationTest final : public AbstractTest {
+public:
+    ConcurrentAllocationTest(const std::string& name, size_t threadCount, size_t objectsPerThread, bool merge)
+        : AbstractTest(name), _threadCount(threadCount), _objectsPerThread(objectsPerThread), _merge(merge) {}
+
+    bool run(AbstractTestLogger& logger) override {
+        std::atomic<size_t> destroyed(0);
+        std::vector<std::vector<Tracked*>> objects(_threadCount);
+        std::string note;
+
+        {
+            ConcurrentMemoryManager mngr(256);
+            std::vector<std::thread> threads;
+
+            for (size_t t = 0; t < _threadCount; ++t) {
+                threads.push_back(std::thread([&, t]() {
+                    for (size_t i = 0; i < _objectsPerThread; ++i) {
+                        objects[t].push_back(mngr.New<Tracked>(&destroyed, t * _objectsPerThread + i));
+                    }
+                }));
+            }
+
+            for (std::thread& thread : threads) {
+                thread.join();
+            }
+
+            if (_merge) {
+                mngr.mergeThreadArenas();
+                mngr.New<Tracked>(&destroyed, 0);
+            }
+
+            for (size_t t = 0; t < _threadCount; ++t) {
+                for (size_t i = 0; i < _objectsPerThread; ++i) {
+                    if (objects[t][i]->getValue() != t * _objectsPerThread + i) {
+                        note = "object overwritten";
+                    }
+                }
+            }
+        }
+
+        size_t expected = _threadCount * _objectsPerThread + (_merge ? 1 : 0);
+
+        if (note.empty() && destroyed != expected) {
+            note = "destroyed " + std::to_string(destroyed) + " objects out of " + std::to_string(expected);
+        }
+
+        logger.result(_name, note.empty(), note);
+        return note.empty();
+    }
+
+private:
+
+    size_t _threadCount;
+    size_t _objectsPerThread;
+    bool _merge;
+};
+
+/**
+ * @brief Checks that the manager only destroys the objects which need it
+ */
+template<typename Manager>
+class DestructionTest final : public AbstractTest {
+public:
+    DestructionTest(const std::string& name) : AbstractTest(name) {}
+
+    bool run(AbstractTestLogger& logger) override {
+        std::atomic<size_t> destroyed(0);
+
+        {
+            Manager mngr(64);
+            for (size_t i = 0; i < 100; ++i) {
+                mngr.template New<Tracked>(&destroyed, i);
+                mngr.template New<Untracked>(&destroyed);
+            }
+        }
+
+        bool success = destroyed == 100;
+        logger.result(_name, success, success ? "" : "destroyed " + std::to_string(destroyed) + " objects out of 100");
+        return success;
+    }
+};
+
+class Small final : public MemoryManageable {
+public:
+    char c;
+};
+
+class Aligned final : public MemoryManageable {
+public:
+    alignas(32) double d;
+};
+
+class Large final : public MemoryManageable {
+public:
+    Large(size_t value) {
+        std::fill(_data, _data + 512, value);
+    }
+
+    bool check(size_t value) const {
+        return std::all_of(_data, _data + 512, [value](size_t v) { return v == value; });
+    }
+
+private:
+    size_t _data[512];
+};
+
+/**
+ * @brief Interleaves objects of different sizes and alignments in small chunks,
+ * and checks that each of them is correctly aligned and keeps its content
+ */
+class ChunkPolicyTest final : public AbstractTest {
+public:
+    ChunkPolicyTest(const std::string& name, const ChunkPolicy& policy) : AbstractTest(name), _policy(policy) {}
+
+    bool run(AbstractTestLogger& logger) override {
+        ChunkedMemoryManager mngr(_policy);
+        std::vector<Large*> larges;
+        std::string note;
+
+        for (size_t i = 0; i < 200; ++i) {
+            mngr.New<Small>();
+
+            Aligned* aligned = mngr.New<Aligned>();
+            if (reinterpret_cast<uintptr_t>(aligned) % alignof(Aligned) != 0) {
+                note = "misaligned object";
+            }
+
+            if (i % 10 == 0) {
+                larges.push_back(mngr.New<Large>(i));
+            }
+        }
+
+        for (size_t i = 0; i < larges.size(); ++i) {
+            if (!larges[i]->check(i * 10)) {
+                note = "large object overwritten";
+            }
+        }
+
+        logger.result(_name, note.empty(), note);
+        return note.empty();
+    }
+
+private:
+
+    ChunkPolicy _policy;
+};
+
+/**
+ * @brief Checks that the objects are accounted in their category, whether they are tracked or not
+ */
+template<typename Manager>
+class AccountingTest final : public AbstractTest {
+public:
+    AccountingTest(const std::string& name) : AbstractTest(name) {}
+
+    bool run(AbstractTestLogger& logger) override {
+        std::atomic<size_t> destroyed(0);
+        Manager mngr(64);
+
+        MemoryStats before(mngr.getStats());
+
+        for (size_t i = 0; i < 10; ++i) {
+            mngr.template New<Tracked>(&destroyed, i);
+            mngr.template New<Untracked>(&destroyed);
+        }
+
+        MemoryStats delta(mngr.getStats() - before);
+        const MemoryUsage& other(delta.categories[MEM_OTHER]);
+        size_t expectedBytes = 10 * (sizeof(Tracked) + sizeof(Untracked));
+
+        bool success = other.objects == 20 && other.bytes == expectedBytes && delta.total().objects == 20;
+        logger.result(_name, success, success ? "" : "accounted " + std::to_string(other.objects) + " objects and "
+                      + std::to_string(other.bytes) + " bytes, expected 20 and " + std::to_string(expectedBytes));
+        return success;
+    }
+};
+
+TestRunner* buildMemoryManagerTests() {
+    TestSuiteBuilder concurrent("Concurrent");
+
+    concurrent.addTest(new ConcurrentAllocationTest("Single thread", 1, 10000, false));
+    concurrent.addTest(new ConcurrentAllocationTest("Several threads", 8, 10000, false));
+    concurrent.addTest(new ConcurrentAllocationTest("Merged arenas", 8, 10000, true));
+
+    TestSuiteBuilder destruction("Destruction");
+
+    destruction.addTest(new DestructionTest<ChunkedMemoryManager>("Chunked manager"));
+    destruction.addTest(new DestructionTest<ConcurrentMemoryManager>("Concurrent manager"));
+
+    TestSuiteBuilder accounting("Accounting");
+
+    accounting.addTest(new AccountingTest<ChunkedMemoryManager>("Chunked manager"));
+    accounting.addTest(new AccountingTest<ConcurrentMemoryManager>("Concurrent manager"));
+
+    TestSuiteBuilder policy("ChunkPolicy");
+
+    policy.addTest(new ChunkPolicyTest("Default policy", ChunkPolicy()));
+    policy.addTest(new ChunkPolicyTest("Tiny chunks", ChunkPolicy(16, 64, 2, 32)));
+    policy.addTest(new ChunkPolicyTest("Capped growth", ChunkPolicy(256, 512, 4, 4096)));
+
+    return new TestRunner("MemoryManagerTests", {concurrent.build(), destruction.build(), accounting.build(), policy.build()});
+}
+
+}
+
+}
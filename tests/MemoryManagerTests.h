@@ -0,0 +1,26 @@
+//
+//  MemoryManagerTests.h
+//  SFSL
+//
+//  Created by Romain Beguet on 19.10.16.
+//  Copyright (c) 2016 Romain Beguet. All rights reserved.
+//
+
+#ifndef __SFSL__MemoryManagerTests__
+#define __SFSL__MemoryManagerTests__
+
+#include <iostream>
+
+#include "TestRunner.h"
+
+namespace sfsl {
+
+namespace test {
+
+TestRunner* buildMemoryManagerTests();
+
+}
+
+}
+
+#endif
@@ -0,0 +1,241 @@
+//
+//  NumberLiteralTests.cpp
+//  SFSL
+//
+//  Created by Romain Beguet on 24.10.16.
+//  Copyright (c) 2016 Romain Beguet. All rights reserved.
+//
+
+#include <sstream>
+#include <vector>
+#include <random>
+#include <limits>
+#include <cstdlib>
+#include <cerrno>
+#include <cmath>
+
+#include "NumberLiteralTests.h"
+#include "AbstractTest.h"
+#include "../src/Utils/Utils.h"
+
+namespace sfsl {
+
+namespace test {
+
+typedef std::make_unsigned<sfsl_int_t>::type sfsl_uint_t;
+
+static inline void referenceReal(const char* str, double& res) {
+    res = std::strtod(str, nullptr);
+}
+
+static inline void referenceReal(const char* str, float& res) {
+    res = std::strtof(str, nullptr);
+}
+
+static std::string randomDigits(std::mt19937& rng, size_t count) {
+    std::string digits;
+    for (size_t i = 0; i < count; ++i) {
+        digits += (char)('0' + rng() % 10);
+    }
+    return digits;
+}
+
+/**
+ * @brief Checks that integer literals are parsed up to the largest sfsl_int_t, and rejected above
+ */
+class IntegerLiteralTest final : public AbstractTest {
+public:
+    IntegerLiteralTest(const std::string& name) : AbstractTest(name) {
+
+    }
+
+    virtual ~IntegerLiteralTest() {
+
+    }
+
+    virtual bool run(AbstractTestLogger& logger) override {
+        const sfsl_int_t max = std::numeric_limits<sfsl_int_t>::max();
+        const std::string maxLiteral(utils::T_toString(max));
+        const std::string aboveMaxLiteral(utils::T_toString((sfsl_uint_t)max + 1));
+
+        if (!check(logger, "0", true, 0) ||
+            !check(logger, "42", true, 42) ||
+            !check(logger, maxLiteral, true, max) ||
+            !check(logger, "000" + maxLiteral, true, max) ||
+            !check(logger, aboveMaxLiteral, false) ||
+            !check(logger, utils::T_toString(std::numeric_limits<sfsl_uint_t>::max()), false) ||
+            !check(logger, maxLiteral + "0", false) ||
+            !check(logger, std::string(100, '9'), false)) {
+            return false;
+        }
+
+        std::mt19937 rng(42);
+
+        for (size_t i = 0; i < 10000; ++i) {
+            std::string literal(randomDigits(rng, 1 + rng() % (maxLiteral.size() + 1)));
+
+            errno = 0;
+            unsigned long long expected = std::strtoull(literal.c_str(), nullptr, 10);
+            bool fits = errno == 0 && expected <= (sfsl_uint_t)max;
+
+            if (!check(logger, literal, fits, fits ? (sfsl_int_t)expected : 0)) {
+                return false;
+            }
+        }
+
+        logger.result(_name, true, "");
+        return true;
+    }
+
+private:
+
+    bool check(AbstractTestLogger& logger, const std::string& literal, bool fits, sfsl_int_t expected = 0) {
+        sfsl_int_t res = 0;
+
+        if (utils::parseInteger(literal.data(), literal.data() + literal.size(), res) != fits) {
+            logger.result(_name, false, literal + (fits ? " was rejected" : " was accepted"));
+            return false;
+        }
+
+        if (fits && res != expected) {
+            logger.result(_name, false, literal + " was parsed as " + utils::T_toString(res));
+            return false;
+        }
+
+        return true;
+    }
+};
+
+/**
+ * @brief Checks that real literals are parsed as strtod would in the C locale,
+ * and that the ones which overflow an sfsl_real_t are rejected
+ */
+class RealLiteralTest final : public AbstractTest {
+public:
+    RealLiteralTest(const std::string& name) : AbstractTest(name) {
+
+    }
+
+    virtual ~RealLiteralTest() {
+
+    }
+
+    virtual bool run(AbstractTestLogger& logger) override {
+        const size_t maxExponent = std::numeric_limits<sfsl_real_t>::max_exponent10;
+
+        if (!check(logger, "0.0") ||
+            !check(logger, "0.1") ||
+            !check(logger, "1.5") ||
+            !check(logger, "9007199254740993.0") ||
+            !check(logger, "0." + std::string(400, '0') + "1") ||
+            !check(logger, "1" + std::string(maxExponent, '0') + ".0") ||
+            !check(logger, "1" + std::string(maxExponent + 1, '0') + ".0", false) ||
+            !check(logger, std::string(maxExponent + 1, '9') + ".0", false)) {
+            return false;
+        }
+
+        std::mt19937 rng(42);
+
+        for (size_t i = 0; i < 10000; ++i) {
+            std::string literal(randomDigits(rng, 1 + rng() % 20) + "." + randomDigits(rng, 1 + rng() % 20));
+
+            if (!check(logger, literal)) {
+                return false;
+            }
+        }
+
+        logger.result(_name, true, "");
+        return true;
+    }
+
+private:
+
+    bool check(AbstractTestLogger& logger, const std::string& literal, bool fits = true) {
+        sfsl_real_t res = 0;
+
+        if (utils::parseReal(literal.data(), literal.data() + literal.size(), res) != fits) {
+            logger.result(_name, false, literal.substr(0, 32) + (fits ? " was rejected" : " was accepted"));
+            return false;
+        }
+
+        sfsl_real_t expected;
+        referenceReal(literal.c_str(), expected);
+
+        if (fits && res != expected) {
+            logger.result(_name, false, literal.substr(0, 32) + " was parsed as " + utils::T_toString(res));
+            return false;
+        }
+
+        return true;
+    }
+};
+
+/**
+ * @brief Checks that reals are formatted as an std::ostream with the default flags would,
+ * and that formatting the real parsed from a formatted real gives back the same string
+ */
+class FormatRealTest final : public AbstractTest {
+public:
+    FormatRealTest(const std::string& name) : AbstractTest(name) {
+
+    }
+
+    virtual ~FormatRealTest() {
+
+    }
+
+    virtual bool run(AbstractTestLogger& logger) override {
+        std::vector<double> values = {
+            0.0, -0.0, 1.0, -1.0, 0.1, 1.5, -2.25, 3.14159265358979, 123456.0, 1234567.0, 0.0001, 0.00001,
+            1e21, 1e-300, std::numeric_limits<double>::max(), std::numeric_limits<double>::min(),
+            std::numeric_limits<double>::denorm_min(), std::numeric_limits<double>::infinity(),
+            -std::numeric_limits<double>::infinity()
+        };
+
+        std::mt19937_64 rng(42);
+
+        for (size_t i = 0; i < 10000; ++i) {
+            values.push_back(std::ldexp((double)(rng() >> 11), (int)(rng() % 200) - 150));
+        }
+
+        for (double value : values) {
+            std::ostringstream expected;
+            expected << value;
+
+            std::string formatted(utils::formatReal(value));
+
+            if (formatted != expected.str()) {
+                logger.result(_name, false, formatted + " instead of " + expected.str());
+                return false;
+            }
+
+            // literals cannot have an exponent
+            if (value >= 0 && formatted.find_first_not_of("0123456789.") == std::string::npos) {
+                sfsl_real_t parsed;
+
+                if (!utils::parseReal(formatted.data(), formatted.data() + formatted.size(), parsed) ||
+                        utils::formatReal(parsed) != formatted) {
+                    logger.result(_name, false, formatted + " does not round-trip");
+                    return false;
+                }
+            }
+        }
+
+        logger.result(_name, true, "");
+        return true;
+    }
+};
+
+TestRunner* buildNumberLiteralTests() {
+    TestSuiteBuilder literals("Literals");
+
+    literals.addTest(new IntegerLiteralTest("Integer literals"));
+    literals.addTest(new RealLiteralTest("Real literals"));
+    literals.addTest(new FormatRealTest("Formatted reals"));
+
+    return new TestRunner("NumberLiteralTests", {literals.build()});
+}
+
+}
+
+}
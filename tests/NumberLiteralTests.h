@@ -0,0 +1,26 @@
+//
+//  NumberLiteralTests.h
+//  SFSL
+//
+//  Created by Romain Beguet on 24.10.16.
+//  Copyright (c) 2016 Romain Beguet. All rights reserved.
+//
+
+#ifndef __SFSL__NumberLiteralTests__
+#define __SFSL__NumberLiteralTests__
+
+#include <iostream>
+
+#include "TestRunner.h"
+
+namespace sfsl {
+
+namespace test {
+
+TestRunner* buildNumberLiteralTests();
+
+}
+
+}
+
+#endif
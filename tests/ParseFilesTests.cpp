@@ -0,0 +1,323 @@
+//
+//  ParseFilesTests.cpp
+//  SFSL
+//
+//  Created by Romain Beguet on 24.10.16.
+//  Copyright (c) 2016 Romain Beguet. All rights reserved.
+//
+
+#include <fstream>
+#include <sstream>
+#include <vector>
+#include <cstdlib>
+#include <unistd.h>
+
+#include "sfsl.h"
+#include "ParseFilesTests.h"
+#include "AbstractTest.h"
+
+namespace sfsl {
+
+namespace test {
+
+/**
+ * @brief A reporter which keeps every message it receives, so that
+ * the messages of two compilations can be compared
+ */
+class RecordingReporter final : public AbstractReporter {
+public:
+    virtual ~RecordingReporter() {
+
+    }
+
+    virtual void info(const std::string& sourceName, size_t start, size_t end, const std::string& message) override {
+        record("info", sourceName, start, end, message);
+    }
+
+    virtual void warning(const std::string& sourceName, size_t start, size_t end, const std::string& message) override {
+        record("warning", sourceName, start, end, message);
+    }
+
+    virtual void error(const std::string& sourceName, size_t start, size_t end, const std::string& message) override {
+        record("error", sourceName, start, end, message);
+    }
+
+    virtual void fatal(const std::string& sourceName, size_t start, size_t end, const std::string& message) override {
+        record("fatal", sourceName, start, end, message);
+    }
+
+    const std::vector<std::string>& getMessages() const {
+        return _messages;
+    }
+
+private:
+
+    void record(const std::string& kind, const std::string& sourceName, size_t start, size_t end, const std::string& message) {
+        _messages.push_back(kind + " " + sourceName + ":" + std::to_string(start) + "-" + std::to_string(end) + " " + message);
+    }
+
+    std::vector<std::string> _messages;
+};
+
+/**
+ * @brief Writes sources in a temporary directory, which is removed with them when the object is destroyed
+ */
+class SourceFiles final {
+public:
+    SourceFiles(const std::vector<std::string>& sources) {
+        char dir[] = "/tmp/sfsl-parsefiles-XXXXXX";
+
+        if (mkdtemp(dir)) {
+            _dir = dir;
+
+            for (size_t i = 0; i < sources.size(); ++i) {
+                _paths.push_back(_dir + "/source" + std::to_string(i) + ".sfsl");
+                std::ofstream(_paths.back()) << sources[i];
+            }
+        }
+    }
+
+    ~SourceFiles() {
+        for (const std::string& path : _paths) {
+            unlink(path.c_str());
+        }
+
+        if (!_dir.empty()) {
+            rmdir(_dir.c_str());
+        }
+    }
+
+    std::string missing(const std::string& name) const {
+        return _dir + "/" + name;
+    }
+
+    const std::vector<std::string>& getPaths() const {
+        return _paths;
+    }
+
+private:
+
+    std::string _dir;
+    std::vector<std::string> _paths;
+};
+
+static CompilerConfig configWith(AbstractReporter* reporter) {
+    return CompilerConfig()
+            .with<opt::Reporter>(reporter)
+            .with<opt::PrimitiveNamer>(StandartPrimitiveNamer::DefaultPrimitiveNamer)
+            .with<opt::InitialChunkSize>(2048);
+}
+
+static std::string validSource(size_t i) {
+    std::string n(std::to_string(i));
+    return "module m" + n + " {\n"
+           "    def f" + n + " = (x: int) => x\n"
+           "    def g" + n + " = (y: real) => f" + n + "(" + n + ")\n"
+           "}\n";
+}
+
+static std::string invalidSource(size_t i) {
+    std::string n(std::to_string(i));
+    return "module e" + n + " {\n"
+           "    def f" + n + " = (x: int => x\n"
+           "    def g" + n + " = ) " + n + "\n"
+           "    def h" + n + " = " + n + "\n"
+           "}\n";
+}
+
+/**
+ * @brief Parses files among which some have syntax errors, and checks that the messages
+ * are reported as if the files were parsed one after the other, however the threads were scheduled
+ */
+class ReportOrderTest final : public AbstractTest {
+public:
+    ReportOrderTest(const std::string& name, size_t fileCount, size_t runCount)
+        : AbstractTest(name), _fileCount(fileCount), _runCount(runCount) {
+
+    }
+
+    virtual ~ReportOrderTest() {
+
+    }
+
+    virtual bool run(AbstractTestLogger& logger) override {
+        std::vector<std::string> sources;
+
+        for (size_t i = 0; i < _fileCount; ++i) {
+            sources.push_back(i % 3 == 1 ? invalidSource(i) : validSource(i));
+        }
+
+        SourceFiles files(sources);
+        RecordingReporter expected;
+
+        {
+            Compiler cmp(configWith(&expected));
+
+            for (const std::string& path : files.getPaths()) {
+                cmp.parseFile(path);
+            }
+        }
+
+        if (expected.getMessages().size() < 2) {
+            logger.result(_name, false, "The sources did not produce several errors");
+            return false;
+        }
+
+        for (size_t run = 0; run < _runCount; ++run) {
+            RecordingReporter actual;
+            Compiler cmp(configWith(&actual));
+
+            if (cmp.parseFiles(files.getPaths())) {
+                logger.result(_name, false, "Run " + std::to_string(run) + ": the program was built despite the errors");
+                return false;
+            }
+
+            if (actual.getMessages() != expected.getMessages()) {
+                logger.result(_name, false, "Run " + std::to_string(run) + ": the messages were not reported in the order of the files");
+                return false;
+            }
+        }
+
+        logger.result(_name, true, "");
+        return true;
+    }
+
+private:
+
+    const size_t _fileCount;
+    const size_t _runCount;
+};
+
+/**
+ * @brief Parses files among which some cannot be opened, and checks that the
+ * error of the first of them is the one that is rethrown
+ */
+class FatalErrorTest final : public AbstractTest {
+public:
+    FatalErrorTest(const std::string& name) : AbstractTest(name) {
+
+    }
+
+    virtual ~FatalErrorTest() {
+
+    }
+
+    virtual bool run(AbstractTestLogger& logger) override {
+        SourceFiles files({validSource(0), invalidSource(1), validSource(2)});
+
+        const std::string firstMissing(files.missing("first_missing.sfsl"));
+        const std::string secondMissing(files.missing("second_missing.sfsl"));
+
+        std::vector<std::string> paths(files.getPaths());
+        paths.insert(paths.begin() + 1, firstMissing);
+        paths.push_back(secondMissing);
+
+        for (size_t run = 0; run < 10; ++run) {
+            RecordingReporter rep;
+            Compiler cmp(configWith(&rep));
+
+            try {
+                cmp.parseFiles(paths);
+                logger.result(_name, false, "No error was thrown");
+                return false;
+            } catch (const CompileError& err) {
+                std::string what(err.what());
+
+                if (what.find(firstMissing) == std::string::npos) {
+                    logger.result(_name, false, "Another error was thrown: " + what);
+                    return false;
+                }
+            }
+        }
+
+        logger.result(_name, true, "");
+        return true;
+    }
+};
+
+/**
+ * @brief Parses valid files, and checks that the merged program is the one obtained
+ * by parsing the files one after the other
+ */
+class MergedProgramTest final : public AbstractTest {
+public:
+    MergedProgramTest(const std::string& name, size_t fileCount)
+        : AbstractTest(name), _fileCount(fileCount) {
+
+    }
+
+    virtual ~MergedProgramTest() {
+
+    }
+
+    virtual bool run(AbstractTestLogger& logger) override {
+        std::vector<std::string> sources;
+
+        for (size_t i = 0; i < _fileCount; ++i) {
+            sources.push_back(validSource(i));
+        }
+
+        SourceFiles files(sources);
+        std::vector<ProgramBuilder> builders;
+        ErrorCountCollector errcount;
+
+        // the programs are printed before the name analysis, which cannot succeed without the standard
+        // library, so they are all parsed before being printed for its errors not to fail the next parses
+        Compiler sequential(configWith(StandartReporter::EmptyReporter));
+        std::ostringstream expected;
+
+        for (const std::string& path : files.getPaths()) {
+            builders.push_back(sequential.parseFile(path));
+
+            if (!builders.back()) {
+                logger.result(_name, false, "Failed to parse " + path);
+                return false;
+            }
+        }
+
+        for (ProgramBuilder builder : builders) {
+            sequential.compile(builder, errcount, printPipeline(expected));
+        }
+
+        Compiler parallel(configWith(StandartReporter::EmptyReporter));
+        std::ostringstream actual;
+        ProgramBuilder merged(parallel.parseFiles(files.getPaths()));
+
+        if (!merged) {
+            logger.result(_name, false, "Failed to parse the files together");
+            return false;
+        }
+
+        parallel.compile(merged, errcount, printPipeline(actual));
+
+        if (expected.str().empty() || actual.str() != expected.str()) {
+            logger.result(_name, false, "The merged program differs from the sequentially parsed one");
+            return false;
+        }
+
+        logger.result(_name, true, "");
+        return true;
+    }
+
+private:
+
+    static Pipeline printPipeline(std::ostream& o) {
+        return Pipeline::createDefault().insert(Phase::PrettyPrint(o)).insert(Phase::StopRightAfter("NameAnalysis"));
+    }
+
+    const size_t _fileCount;
+};
+
+TestRunner* buildParseFilesTests() {
+    TestSuiteBuilder parseFiles("ParseFiles");
+
+    parseFiles.addTest(new ReportOrderTest("Report order", 16, 20));
+    parseFiles.addTest(new FatalErrorTest("First fatal error"));
+    parseFiles.addTest(new MergedProgramTest("Merged program", 16));
+
+    return new TestRunner("ParseFilesTests", {parseFiles.build()});
+}
+
+}
+
+}
@@ -0,0 +1,26 @@
+//
+//  ParseFilesTests.h
+//  SFSL
+//
+//  Created by Romain Beguet on 24.10.16.
+//  Copyright (c) 2016 Romain Beguet. All rights reserved.
+//
+
+#ifndef __SFSL__ParseFilesTests__
+#define __SFSL__ParseFilesTests__
+
+#include <iostream>
+
+#include "TestRunner.h"
+
+namespace sfsl {
+
+namespace test {
+
+TestRunner* buildParseFilesTests();
+
+}
+
+}
+
+#endif
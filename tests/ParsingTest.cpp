@@ -0,0 +1,168 @@
+//
+//  ParsingTest.cpp
+//  SFSL
+//
+//  Created by Romain Beguet on 24.10.16.
+//  Copyright (c) 2016 Romain Beguet. All rights reserved.
+//
+
+#include <sstream>
+#include <vector>
+#include <algorithm>
+
+#include "ParsingTest.h"
+#include "sfsl.h"
+#include "Compiler/Common/Positionnable.h"
+#include "Compiler/Frontend/Lexer/Lexer.h"
+#include "Compiler/Frontend/Parser/Parser.h"
+#include "Compiler/Frontend/AST/Visitors/ASTPrinter.h"
+
+namespace sfsl {
+
+namespace test {
+
+static const std::string ErrorAnnotation = "// error: ";
+static const std::string ParsedAnnotation = "// parsed: ";
+
+/**
+ * @brief A reported error, identified by the line on which it was reported and its message
+ */
+typedef std::pair<size_t, std::string> LineMessage;
+
+/**
+ * @brief Records the errors reported while parsing, along with the line on which they were reported
+ */
+class ErrorRecorder final : public common::AbstractReporter {
+public:
+    ErrorRecorder(const std::string& source) : _source(source) {
+        _errorCount = 0;
+    }
+
+    virtual ~ErrorRecorder() {}
+
+    virtual void info(const common::Positionnable&, const std::string&) override {}
+
+    virtual void warning(const common::Positionnable&, const std::string&) override {}
+
+    virtual void error(const common::Positionnable& pos, const std::string& msg) override {
+        _errors.push_back(LineMessage(lineOf(pos.getStartPosition()), msg));
+        ++_errorCount;
+    }
+
+    virtual void fatal(const common::Positionnable& pos, const std::string& msg) override {
+        ++_errorCount;
+        AbstractReporter::fatal(pos, msg);
+    }
+
+    const std::vector<LineMessage>& getErrors() const {
+        return _errors;
+    }
+
+private:
+
+    size_t lineOf(size_t pos) const {
+        pos = std::min(pos, _source.size());
+        return (size_t)std::count(_source.begin(), _source.begin() + pos, '\n') + 1;
+    }
+
+    const std::string& _source;
+    std::vector<LineMessage> _errors;
+};
+
+/**
+ * @brief Collects the text following the given annotation in each line of the source
+ */
+static void collectAnnotations(const std::string& source, const std::string& annotation,
+                               std::vector<LineMessage>& annotations) {
+    std::istringstream lines(source);
+    std::string line;
+
+    for (size_t lineNumber = 1; std::getline(lines, line); ++lineNumber) {
+        size_t at = line.find(annotation);
+        if (at != std::string::npos) {
+            annotations.push_back(LineMessage(lineNumber, line.substr(at + annotation.size())));
+        }
+    }
+}
+
+static std::string toString(const LineMessage& error) {
+    return "line " + utils::T_toString(error.first) + ": " + error.second;
+}
+
+ParsingTest::ParsingTest(const std::string& name, const std::string& source, bool shouldCompile)
+    : AbstractTest(name), _source(source), _shouldCompile(shouldCompile) {
+
+}
+
+ParsingTest::~ParsingTest() {
+
+}
+
+bool ParsingTest::run(AbstractTestLogger& logger) {
+    ErrorRecorder* recorder = new ErrorRecorder(_source);
+    CompCtx_Ptr ctx(common::CompilationContext::CustomReporterCompilationContext(
+                        common::ChunkPolicy(2048), std::unique_ptr<common::AbstractReporter>(recorder)));
+
+    const common::AbstractPrimitiveNamer* namer = StandartPrimitiveNamer::DefaultPrimitiveNamer;
+    std::ostringstream printed;
+
+    try {
+        src::StringSource source(src::InputSourceName::make(ctx, _name), _source);
+        lex::Lexer lexer(ctx->reporter(), ctx->names(), source);
+        ast::Parser parser(ctx, lexer, namer);
+
+        ast::Program* prog = parser.parse();
+
+        // no phase runs on a program with syntax errors, but the parser must still build
+        // a complete tree, which is checked by pretty printing it
+        ast::ASTPrinter printer(ctx, printed);
+        prog->onVisit(&printer);
+    } catch (const common::CompilationFatalError& err) {
+        logger.result(_name, false, std::string("Fatal: ") + err.what());
+        return false;
+    }
+
+    std::vector<LineMessage> expected;
+    collectAnnotations(_source, ErrorAnnotation, expected);
+
+    std::vector<LineMessage> reported(recorder->getErrors());
+
+    if (!_shouldCompile && expected.empty()) {
+        logger.result(_name, false, "no error is expected by the source");
+        return false;
+    }
+
+    std::sort(expected.begin(), expected.end());
+    std::sort(reported.begin(), reported.end());
+
+    std::vector<LineMessage> missing, unexpected;
+    std::set_difference(expected.begin(), expected.end(), reported.begin(), reported.end(), std::back_inserter(missing));
+    std::set_difference(reported.begin(), reported.end(), expected.begin(), expected.end(), std::back_inserter(unexpected));
+
+    if (!unexpected.empty()) {
+        logger.result(_name, false, "unexpected error at " + toString(unexpected.front()));
+        return false;
+    }
+    if (!missing.empty()) {
+        logger.result(_name, false, "missing error at " + toString(missing.front()));
+        return false;
+    }
+
+    std::vector<LineMessage> parsed;
+    collectAnnotations(_source, ParsedAnnotation, parsed);
+
+    for (const LineMessage& text : parsed) {
+        if (printed.str().find(text.second) == std::string::npos) {
+            logger.result(_name, false, "`" + text.second + "` expected at line " +
+                          utils::T_toString(text.first) + " is not in the printed program");
+            return false;
+        }
+    }
+
+    logger.result(_name, true, utils::T_toString(reported.size()) + " syntax error(s)");
+    return true;
+}
+
+}
+
+}
@@ -0,0 +1,48 @@
+//
+//  ParsingTest.h
+//  SFSL
+//
+//  Created by Romain Beguet on 24.10.16.
+//  Copyright (c) 2016 Romain Beguet. All rights reserved.
+//
+
+#ifndef __SFSL__ParsingTest__
+#define __SFSL__ParsingTest__
+
+#include <iostream>
+
+#include "AbstractTest.h"
+
+namespace sfsl {
+
+namespace test {
+
+/**
+ * @brief Parses a source and pretty prints the resulting program, even if syntax errors
+ * were reported, to check that the parser leaves error nodes rather than missing ones.
+ *
+ * The source annotates what is expected from the parse with line comments:
+ * `// error: <message>` expects an error with this message to be reported on the line of
+ * the comment, and `// parsed: <text>` expects the printed program to contain the text.
+ * The reported errors must be exactly the expected ones, so that an error which cascades
+ * into other errors is noticed. A source that must not compile expects at least one error.
+ */
+class ParsingTest : public AbstractTest {
+public:
+    ParsingTest(const std::string& name, const std::string& source, bool shouldCompile);
+
+    virtual ~ParsingTest();
+
+    virtual bool run(AbstractTestLogger& logger) override;
+
+private:
+
+    const std::string _source;
+    bool _shouldCompile;
+};
+
+}
+
+}
+
+#endif
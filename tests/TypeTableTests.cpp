@@ -0,0 +1,182 @@
+//
+//  TypeTableTests.cpp
+//  SFSL
+//
+//  Created by Romain Beguet on 26.10.16.
+//  Copyright (c) 2016 Romain Beguet. All rights reserved.
+//
+
+#include <vector>
+#include <string>
+
+#include "TypeTableTests.h"
+#include "AbstractTest.h"
+#include "../src/Compiler/Common/CompilationContext.h"
+#include "../src/Compiler/Frontend/AST/Nodes/TypeExpressions.h"
+#include "../src/Compiler/Frontend/Types/Types.h"
+
+namespace sfsl {
+
+namespace test {
+
+using namespace type;
+
+/**
+ * @brief Base of the tests of the type table, which provides a fresh compilation
+ * context along with a few classes and type parameters to build types from
+ */
+class TypeTableTest : public AbstractTest {
+public:
+    TypeTableTest(const std::string& name) : AbstractTest(name) {}
+
+    virtual ~TypeTableTest() {}
+
+    virtual bool run(AbstractTestLogger& logger) override {
+        _ctx = common::CompilationContext::DefaultCompilationContext(common::ChunkPolicy(2048));
+
+        A = makeClass("A");
+        B = makeClass("B");
+        Fn = makeClass("Fn");
+
+        P = ProperType::create(makeClass("P"), Environment::Empty, _ctx);
+        Q = ProperType::create(makeClass("Q"), Environment::Empty, _ctx);
+        X = ProperType::create(makeClass("X"), Environment::Empty, _ctx);
+        Y = ProperType::create(makeClass("Y"), Environment::Empty, _ctx);
+
+        _failure.clear();
+        check();
+
+        logger.result(_name, _failure.empty(), _failure);
+        return _failure.empty();
+    }
+
+protected:
+
+    virtual void check() = 0;
+
+    /**
+     * @brief Records the first failed expectation
+     */
+    void expect(bool condition, const std::string& description) {
+        if (!condition && _failure.empty()) {
+            _failure = description;
+        }
+    }
+
+    /**
+     * @return A new environment, built from scratch, substituting `key` with `value`
+     */
+    Environment env(Type* key, Type* value, common::VARIANCE_TYPE vt = common::VAR_T_NONE) const {
+        Environment e;
+        e.insert(Environment::Substitution(vt, key, value));
+        return e;
+    }
+
+    CompCtx_Ptr _ctx;
+
+    ast::ClassDecl* A;
+    ast::ClassDecl* B;
+    ast::ClassDecl* Fn;
+
+    Type* P;
+    Type* Q;
+    Type* X;
+    Type* Y;
+
+private:
+
+    ast::ClassDecl* makeClass(const std::string& name) {
+        return _ctx->memoryManager().New<ast::ClassDecl>(name, nullptr, std::vector<ast::TypeDecl*>(),
+                                                         std::vector<ast::TypeSpecifier*>(),
+                                                         std::vector<ast::DefineDecl*>(), false);
+    }
+
+    std::string _failure;
+};
+
+class ProperTypeTest final : public TypeTableTest {
+public:
+    ProperTypeTest(const std::string& name) : TypeTableTest(name) {}
+
+protected:
+
+    virtual void check() override {
+        ProperType* a = ProperType::create(A, env(P, X), _ctx);
+
+        expect(ProperType::create(A, env(P, X), _ctx) == a, "same class and substitutions give another instance");
+        expect(ProperType::create(A, Environment::Empty, _ctx) == ProperType::create(A, Environment::Empty, _ctx),
+               "same class without substitutions gives another instance");
+
+        expect(ProperType::create(B, env(P, X), _ctx) != a, "another class gives the same instance");
+        expect(ProperType::create(A, env(P, Y), _ctx) != a, "another substituted value gives the same instance");
+        expect(ProperType::create(A, env(Q, X), _ctx) != a, "another substituted key gives the same instance");
+        expect(ProperType::create(A, env(P, X, common::VAR_T_IN), _ctx) != a, "another variance gives the same instance");
+        expect(ProperType::create(A, Environment::Empty, _ctx) != a, "no substitution gives the same instance");
+
+        expect(a->substitute(env(Q, Y), _ctx) == a, "a substitution that changes nothing gives another instance");
+        expect(a->substitute(env(X, Y), _ctx) == ProperType::create(A, env(P, Y), _ctx),
+               "a substitution that changes a value does not give the interned instance");
+    }
+};
+
+class FunctionTypeTest final : public TypeTableTest {
+public:
+    FunctionTypeTest(const std::string& name) : TypeTableTest(name) {}
+
+protected:
+
+    virtual void check() override {
+        FunctionType* f = FunctionType::create({}, {P, X}, Y, Fn, env(Q, X), _ctx);
+
+        expect(FunctionType::create({}, {P, X}, Y, Fn, env(Q, X), _ctx) == f, "same parts give another instance");
+
+        expect(FunctionType::create({}, {X, P}, Y, Fn, env(Q, X), _ctx) != f, "other argument types give the same instance");
+        expect(FunctionType::create({}, {P}, Y, Fn, env(Q, X), _ctx) != f, "fewer argument types give the same instance");
+        expect(FunctionType::create({}, {P, X}, X, Fn, env(Q, X), _ctx) != f, "another return type gives the same instance");
+        expect(FunctionType::create({}, {P, X}, Y, A, env(Q, X), _ctx) != f, "another class gives the same instance");
+        expect(FunctionType::create({}, {P, X}, Y, Fn, env(Q, Y), _ctx) != f, "another environment gives the same instance");
+
+        expect(f->substitute(env(Q, Y), _ctx) == f, "a substitution that changes nothing gives another instance");
+        expect(f->substitute(env(P, Y), _ctx) == FunctionType::create({}, {Y, X}, Y, Fn, env(Q, X), _ctx),
+               "a substitution that changes an argument type does not give the interned instance");
+        expect(f->substitute(env(X, P), _ctx) == FunctionType::create({}, {P, P}, Y, Fn, env(Q, P), _ctx),
+               "a substitution that changes the environment does not give the interned instance");
+    }
+};
+
+class ConstructorApplyTypeTest final : public TypeTableTest {
+public:
+    ConstructorApplyTypeTest(const std::string& name) : TypeTableTest(name) {}
+
+protected:
+
+    virtual void check() override {
+        ConstructorApplyType* c = ConstructorApplyType::create(P, {X, Y}, _ctx);
+
+        expect(ConstructorApplyType::create(P, {X, Y}, _ctx) == c, "same callee and arguments give another instance");
+
+        expect(ConstructorApplyType::create(Q, {X, Y}, _ctx) != c, "another callee gives the same instance");
+        expect(ConstructorApplyType::create(P, {Y, X}, _ctx) != c, "other arguments give the same instance");
+        expect(ConstructorApplyType::create(P, {X}, _ctx) != c, "fewer arguments give the same instance");
+
+        expect(c->substitute(env(Q, X), _ctx) == c, "a substitution that changes nothing gives another instance");
+        expect(c->substitute(env(Y, X), _ctx) == ConstructorApplyType::create(P, {X, X}, _ctx),
+               "a substitution that changes an argument does not give the interned instance");
+        expect(c->substitute(env(P, Q), _ctx) == ConstructorApplyType::create(Q, {X, Y}, _ctx),
+               "a substitution that changes the callee does not give the interned instance");
+    }
+};
+
+TestRunner* buildTypeTableTests() {
+    TestSuiteBuilder hashConsing("HashConsing");
+
+    hashConsing.addTest(new ProperTypeTest("Proper types"));
+    hashConsing.addTest(new FunctionTypeTest("Function types"));
+    hashConsing.addTest(new ConstructorApplyTypeTest("Constructor apply types"));
+
+    return new TestRunner("TypeTableTests", {hashConsing.build()});
+}
+
+}
+
+}
@@ -0,0 +1,26 @@
+//
+//  TypeTableTests.h
+//  SFSL
+//
+//  Created by Romain Beguet on 26.10.16.
+//  Copyright (c) 2016 Romain Beguet. All rights reserved.
+//
+
+#ifndef __SFSL__TypeTableTests__
+#define __SFSL__TypeTableTests__
+
+#include <iostream>
+
+#include "TestRunner.h"
+
+namespace sfsl {
+
+namespace test {
+
+TestRunner* buildTypeTableTests();
+
+}
+
+}
+
+#endif
@@ -0,0 +1,423 @@
+//
+//  VMTests.cpp
+//  SFSL
+//
+//  Created by Romain Beguet on 17.10.16.
+//  Copyright (c) 2016 Romain Beguet. All rights reserved.
+//
+
+#include <sstream>
+#include <fstream>
+#include <cstdio>
+#include <cstring>
+#include <limits>
+
+#include "sfsl.h"
+#include "VMTests.h"
+#include "AbstractTest.h"
+#include "../src/VM/Program.h"
+#include "../src/Compiler/Backend/Bytecode/BytecodeBuffer.h"
+
+namespace sfsl {
+
+namespace test {
+
+static const std::string NATIVES_HEADER =
+        "module test {\n"
+        "    using sfsl.lang\n"
+        "    extern def add: (int, int)->int\n"
+        "    extern def sub: (int, int)->int\n"
+        "    extern def lt: (int, int)->bool\n"
+        "    extern def print: int->unit\n"
+        "    extern def printStr: string->unit\n"
+        "    extern def missing: int->int\n";
+
+static const std::string NATIVES_FOOTER = "\n}";
+
+/**
+ * @brief Compiles a program made of the given definitions, runs its entry point
+ * and compares what it printed through the `print` natives with the expected output.
+ */
+class VMTest final : public AbstractTest {
+public:
+    VMTest(const std::string& name, const std::string& defs, const std::string& expectedOutput,
+           bool shouldFail = false, bool throughModule = false)
+        : AbstractTest(name), _source(NATIVES_HEADER + defs + NATIVES_FOOTER),
+          _expectedOutput(expectedOutput), _shouldFail(shouldFail), _throughModule(throughModule) {
+
+    }
+
+    virtual ~VMTest() {
+
+    }
+
+    virtual bool run(AbstractTestLogger& logger) override {
+        Compiler cmp(CompilerConfig()
+                     .with<opt::Reporter>(StandartReporter::CerrReporter)
+                     .with<opt::InitialChunkSize>(2048));
+
+        try {
+            cmp.loadPlugin(STDLIBNAME);
+
+            ProgramBuilder builder = cmp.parse(_name, _source);
+            VMCollector collector;
+            cmp.compile(builder, collector);
+
+            VirtualMachine vm(collector.get());
+            if (!vm) {
+                logger.result(_name, false, "Fatal: failed to compile the program");
+                return false;
+            }
+
+            if (_throughModule) {
+                std::string path = "vmtest.sfm";
+                vm.save(path);
+                vm = VirtualMachine::load(path);
+                std::remove(path.c_str());
+            }
+
+            std::ostringstream out;
+            link(vm, out);
+
+            try {
+                vm.call("$ENTRY_POINT$");
+            } catch (const RuntimeError& err) {
+                logger.result(_name, _shouldFail, std::string("Runtime error: ") + err.what());
+                return _shouldFail;
+            }
+
+            bool success = !_shouldFail && out.str() == _expectedOutput;
+            logger.result(_name, success, success ? "" : "Output: '" + out.str() + "'");
+            return success;
+
+        } catch (const CompileError& err) {
+            logger.result(_name, false, std::string("Fatal: ") + err.what());
+            return false;
+        } catch (const RuntimeError& err) {
+            logger.result(_name, false, std::string("Fatal: ") + err.what());
+            return false;
+        }
+    }
+
+private:
+
+    static void link(VirtualMachine& vm, std::ostringstream& out) {
+        vm.link("test.add:(sfsl.lang.int, sfsl.lang.int)->sfsl.lang.int", [](vm::RuntimeCtx&, vm::Value, vm::Value* args) {
+            return vm::Value::Int(args[0].i + args[1].i);
+        });
+        vm.link("test.sub:(sfsl.lang.int, sfsl.lang.int)->sfsl.lang.int", [](vm::RuntimeCtx&, vm::Value, vm::Value* args) {
+            return vm::Value::Int(args[0].i - args[1].i);
+        });
+        vm.link("test.lt:(sfsl.lang.int, sfsl.lang.int)->sfsl.lang.bool", [](vm::RuntimeCtx&, vm::Value, vm::Value* args) {
+            return vm::Value::Bool(args[0].i < args[1].i);
+        });
+        vm.link("test.print:(sfsl.lang.int)->sfsl.lang.unit", [&out](vm::RuntimeCtx&, vm::Value, vm::Value* args) {
+            out << args[0].i << ";";
+            return vm::Value::Unit();
+        });
+        vm.link("test.printStr:(sfsl.lang.string)->sfsl.lang.unit", [&out](vm::RuntimeCtx& ctx, vm::Value, vm::Value* args) {
+            out << ctx.getString(args[0]) << ";";
+            return vm::Value::Unit();
+        });
+    }
+
+    const std::string _source;
+    const std::string _expectedOutput;
+    const bool _shouldFail;
+    const bool _throughModule;
+};
+
+/**
+ * @brief Checks that loading a file which is not a valid module is reported as a runtime error
+ */
+class InvalidModuleTest final : public AbstractTest {
+public:
+    InvalidModuleTest(const std::string& name, const std::string& content) : AbstractTest(name), _content(content) {
+
+    }
+
+    virtual ~InvalidModuleTest() {
+
+    }
+
+    virtual bool run(AbstractTestLogger& logger) override {
+        std::string path = "vmtest_invalid.sfm";
+        std::ofstream(path, std::ios::binary) << _content;
+
+        bool success = false;
+        try {
+            VirtualMachine::load(path);
+        } catch (const RuntimeError&) {
+            success = true;
+        }
+
+        std::remove(path.c_str());
+        logger.result(_name, success, "");
+        return success;
+    }
+
+private:
+
+    const std::string _content;
+};
+
+/**
+ * @brief Compiles a program to a module, changes the operand of the first instruction
+ * with the given opcode, and checks that loading the module is reported as a runtime error
+ */
+class CorruptedModuleTest final : public AbstractTest {
+public:
+    CorruptedModuleTest(const std::string& name, bc::OP_CODE opcode, size_t arg)
+        : AbstractTest(name), _opcode(opcode), _arg(arg) {
+
+    }
+
+    virtual ~CorruptedModuleTest() {
+
+    }
+
+    virtual bool run(AbstractTestLogger& logger) override {
+        static const std::string source =
+                NATIVES_HEADER +
+                "class Counter(x: int) {\n"
+                "    def incr() => { x = add(x, 1); x; }\n"
+                "}\n"
+                "def fib(n: int)->int => if (lt(n, 2)) n else add(fib(sub(n, 1)), fib(sub(n, 2)))\n"
+                "@entry def main() => { c := Counter(fib(10)); printStr(\"counter\"); print(c.incr()); }" +
+                NATIVES_FOOTER;
+
+        Compiler cmp(CompilerConfig().with<opt::Reporter>(StandartReporter::CerrReporter));
+        std::string path = "vmtest_corrupted.sfm";
+
+        try {
+            cmp.loadPlugin(STDLIBNAME);
+
+            ProgramBuilder builder = cmp.parse(_name, source);
+            VMCollector collector;
+            cmp.compile(builder, collector);
+            VirtualMachine(collector.get()).save(path);
+        } catch (const std::exception& err) {
+            logger.result(_name, false, std::string("Fatal: ") + err.what());
+            return false;
+        }
+
+        if (!corrupt(path)) {
+            std::remove(path.c_str());
+            logger.result(_name, false, "No instruction to corrupt");
+            return false;
+        }
+
+        bool success = false;
+        try {
+            VirtualMachine::load(path);
+        } catch (const RuntimeError&) {
+            success = true;
+        }
+
+        std::remove(path.c_str());
+        logger.result(_name, success, success ? "" : "The corrupted module was loaded");
+        return success;
+    }
+
+private:
+
+    bool corrupt(const std::string& path) const {
+        std::fstream f(path, std::ios::binary | std::ios::in | std::ios::out);
+
+        // the section table of the header starts after the magic number, the version, the byte order,
+        // the four type sizes and the constant count, and starts with the offset and count of the code
+        uint64_t codeSection[2];
+        f.seekg(24);
+        f.read(reinterpret_cast<char*>(codeSection), sizeof(codeSection));
+
+        for (uint64_t i = 0; f && i < codeSection[1]; ++i) {
+            std::streamoff pos = (std::streamoff)(codeSection[0] + i * sizeof(vm::Instruction));
+            vm::Instruction instr;
+            f.seekg(pos);
+            f.read(reinterpret_cast<char*>(&instr), sizeof(instr));
+
+            if (instr.opcode == _opcode) {
+                instr.arg = _arg;
+                f.seekp(pos);
+                f.write(reinterpret_cast<const char*>(&instr), sizeof(instr));
+                return (bool)f;
+            }
+        }
+
+        return false;
+    }
+
+    const bc::OP_CODE _opcode;
+    const size_t _arg;
+};
+
+/**
+ * @brief Decodes an instruction whose operand starts with the bytes of the given number of reals
+ * whose bits are all set, which are all continuation bytes, and ends with the given varint.
+ * Checks that the operand is either decoded to the expected value or rejected as invalid bytecode.
+ */
+class OperandDecodingTest final : public AbstractTest {
+public:
+    OperandDecodingTest(const std::string& name, size_t continuationReals, size_t last, bool valid)
+        : AbstractTest(name), _continuationReals(continuationReals), _last(last), _valid(valid) {
+
+    }
+
+    virtual ~OperandDecodingTest() {
+
+    }
+
+    virtual bool run(AbstractTestLogger& logger) override {
+        bc::BytecodeBuffer buffer;
+        buffer.emit(bc::OP_LOAD_CONST, common::Positionnable());
+
+        sfsl_real_t allBitsSet;
+        std::memset(&allBitsSet, 0xFF, sizeof(allBitsSet));
+        for (size_t i = 0; i < _continuationReals; ++i) {
+            buffer.writeReal(allBitsSet);
+        }
+        buffer.writeUInt(_last);
+        buffer.finish();
+
+        size_t offset = 0;
+        bc::DecodedInstruction instr;
+
+        try {
+            buffer.decode(offset, instr);
+        } catch (const common::CompilationFatalError& err) {
+            logger.result(_name, !_valid, err.what());
+            return !_valid;
+        }
+
+        bool success = _valid && instr.arg == _last && offset == buffer.getCode().size();
+        logger.result(_name, success, _valid ? "" : "The operand was decoded");
+        return success;
+    }
+
+private:
+
+    const size_t _continuationReals;
+    const size_t _last;
+    const bool _valid;
+};
+
+TestRunner* buildVMTests() {
+    TestSuiteBuilder basic("Basic");
+
+    basic.addTest(new VMTest("Native calls",
+        "@entry def main() => print(add(1, sub(5, 3)))",
+        "3;"));
+
+    basic.addTest(new VMTest("Literals and locals",
+        "@entry def main() => { x := 4; s := \"hello\"; y := x; printStr(s); print(y); }",
+        "hello;4;"));
+
+    basic.addTest(new VMTest("Wide literals",
+        "@entry def main() => { print(sub(0, 300)); print(add(2147483647, 1)); print(sub(sub(0, 129), 1)); }",
+        "-300;2147483648;-130;"));
+
+    basic.addTest(new VMTest("If expressions",
+        "def max(a: int, b: int) => if (lt(a, b)) b else a\n"
+        "@entry def main() => { print(max(2, 7)); print(max(9, 3)); }",
+        "7;9;"));
+
+    basic.addTest(new VMTest("Recursion",
+        "def fib(n: int)->int => if (lt(n, 2)) n else add(fib(sub(n, 1)), fib(sub(n, 2)))\n"
+        "@entry def main() => print(fib(15))",
+        "610;"));
+
+    basic.addTest(new VMTest("Global definitions",
+        "def answer = add(40, 2)\n"
+        "@entry def main() => print(answer)",
+        "42;"));
+
+    TestSuiteBuilder objects("Objects");
+
+    objects.addTest(new VMTest("Fields and methods",
+        "class Counter(x: int) {\n"
+        "    def incr() => { x = add(x, 1); x; }\n"
+        "}\n"
+        "@entry def main() => { c := Counter(10); c.incr(); print(c.incr()); }",
+        "12;"));
+
+    objects.addTest(new VMTest("Virtual calls",
+        "type Shape = abstract class {\n"
+        "    abstract def size: ()->int\n"
+        "}\n"
+        "class Square(n: int) : Shape {\n"
+        "    redef size() => add(n, n)\n"
+        "}\n"
+        "class Point() : Shape {\n"
+        "    redef size() => 0\n"
+        "}\n"
+        "def show(s: Shape) => print(s.size())\n"
+        "@entry def main() => { show(Square(3)); show(Point()); }",
+        "6;0;"));
+
+    objects.addTest(new VMTest("Higher order functions",
+        "def twice(f: int->int, x: int) => f(f(x))\n"
+        "def inc(x: int) => add(x, 1)\n"
+        "@entry def main() => { print(twice(inc, 5)); print(twice((x: int) => sub(x, 2), 5)); }",
+        "7;1;"));
+
+    objects.addTest(new VMTest("Garbage collection",
+        "class Node(v: int) {\n"
+        "    def value() => v\n"
+        "}\n"
+        "def build(n: int, acc: int)->int => if (lt(n, 1)) acc else {\n"
+        "    node := Node(n);\n"
+        "    s := \"garbage\";\n"
+        "    build(sub(n, 1), add(acc, node.value()));\n"
+        "}\n"
+        "@entry def main() => print(build(3000, 0))",
+        "4501500;"));
+
+    TestSuiteBuilder errors("Errors");
+
+    errors.addTest(new VMTest("Unlinked extern",
+        "@entry def main() => print(missing(1))",
+        "", true));
+
+    errors.addTest(new VMTest("Stack overflow",
+        "def loop(n: int)->int => add(loop(n), 1)\n"
+        "@entry def main() => print(loop(0))",
+        "", true));
+
+    TestSuiteBuilder modules("Modules");
+
+    modules.addTest(new VMTest("Round trip",
+        "class Counter(x: int) {\n"
+        "    def incr() => { x = add(x, 1); x; }\n"
+        "}\n"
+        "def fib(n: int)->int => if (lt(n, 2)) n else add(fib(sub(n, 1)), fib(sub(n, 2)))\n"
+        "@entry def main() => { c := Counter(fib(10)); printStr(\"counter\"); print(c.incr()); }",
+        "counter;56;", false, true));
+
+    modules.addTest(new VMTest("Positions of runtime errors",
+        "@entry def main() => print(missing(1))",
+        "", true, true));
+
+    modules.addTest(new InvalidModuleTest("Not a module", "this is not a module"));
+    modules.addTest(new InvalidModuleTest("Truncated module", std::string("SFSM\x01\0\0\0", 8)));
+    modules.addTest(new CorruptedModuleTest("Constant index out of bounds", bc::OP_LOAD_CONST, 100000));
+    modules.addTest(new CorruptedModuleTest("String index out of bounds", bc::OP_PUSH_STRING, 100000));
+    modules.addTest(new CorruptedModuleTest("Jump target out of bounds", bc::OP_IF_FALSE, 100000));
+    modules.addTest(new CorruptedModuleTest("Method index out of bounds", bc::OP_MAKE_METHOD, 100000));
+    modules.addTest(new CorruptedModuleTest("Stack index out of bounds", bc::OP_LOAD_STACK, 100000));
+
+    TestSuiteBuilder decoding("Decoding");
+
+    // a varint of a size_t spans at most one byte per 7 bits
+    const size_t maxOperandSize = (sizeof(size_t) * 8 + 6) / 7;
+
+    decoding.addTest(new OperandDecodingTest("Widest operand", 0, std::numeric_limits<size_t>::max(), true));
+    decoding.addTest(new OperandDecodingTest("Overlong operand", maxOperandSize / sizeof(sfsl_real_t) + 1, 0, false));
+    decoding.addTest(new OperandDecodingTest("Operand overflowing its last byte",
+                                             (maxOperandSize - 2) / sizeof(sfsl_real_t), 0x3FFF, false));
+
+    return new TestRunner("VMTests", {basic.build(), objects.build(), errors.build(), modules.build(), decoding.build()});
+}
+
+}
+
+}
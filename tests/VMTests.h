@@ -0,0 +1,26 @@
+//
+//  VMTests.h
+//  SFSL
+//
+//  Created by Romain Beguet on 17.10.16.
+//  Copyright (c) 2016 Romain Beguet. All rights reserved.
+//
+
+#ifndef __SFSL__VMTests__
+#define __SFSL__VMTests__
+
+#include <iostream>
+
+#include "TestRunner.h"
+
+namespace sfsl {
+
+namespace test {
+
+TestRunner* buildVMTests();
+
+}
+
+}
+
+#endif
@@ -49,7 +49,7 @@ void CapturesChecker::visitClosure(const common::Positionnable& pos, ast::Annota
             bool ok = false;
 
             for (auto candidate = expected.begin(); candidate != expected.end();) {
-                if (c.newField->getValue() == candidate->first) {
+                if (c.newField->getValue().str() == candidate->first) {
                     candidate = expected.erase(candidate);
                     ok = true;
                     break;
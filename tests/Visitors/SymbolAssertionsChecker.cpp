@@ -49,7 +49,7 @@ void SymbolAssertionsChecker::visit(ast::TypeParameter* tparam) {
 
 void SymbolAssertionsChecker::visit(ast::FunctionCall* call) {
     if (ast::Identifier* id = ast::getIfNodeOfType<ast::Identifier>(call->getCallee(), _ctx)) {
-        if (id->getValue() == ASSERT_SAME_SYM) {
+        if (id->getValue().str() == ASSERT_SAME_SYM) {
             const std::vector<ast::Expression*>& args(call->getArgs());
             if (args.size() != 2) {
                 _ctx->reporter().fatal(*call, "Expected 2 arguments, got " + utils::T_toString(args.size()));
@@ -86,7 +86,7 @@ sym::Symbol*& SymbolAssertionsChecker::findSymbolLocation(const std::string& nam
 }
 
 void SymbolAssertionsChecker::tryAddTestSymbol(sym::Symbol* s) {
-    if (s->getName().substr(0, 5) == "test_") {
+    if (s->getName().str().substr(0, 5) == "test_") {
         findSymbolLocation(s->getName(), 0) = s;
     }
 }
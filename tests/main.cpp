@@ -2,6 +2,13 @@
 #include "FileSystemTestGenerator.h"
 #include "PhaseGraphTests.h"
 #include "CanSubtypeTests.h"
+#include "VMTests.h"
+#include "MemoryManagerTests.h"
+#include "CharScanningTests.h"
+#include "ParseFilesTests.h"
+#include "NumberLiteralTests.h"
+#include "EnvironmentTests.h"
+#include "TypeTableTests.h"
 #include "sfsl.h"
 
 using namespace sfsl;
@@ -57,8 +64,16 @@ private:
 
 int main() {
     CoutLogger logger;
-    test::buildPhaseGraphTests()->run(logger);
-    test::buildCanSubtypeTests()->run(logger);
-    test::FileSystemTestGenerator("sfsl").findAndGenerate()->run(logger);
-    return 0;
+    bool success = true;
+    success &= test::buildPhaseGraphTests()->run(logger);
+    success &= test::buildCanSubtypeTests()->run(logger);
+    success &= test::buildVMTests()->run(logger);
+    success &= test::buildMemoryManagerTests()->run(logger);
+    success &= test::buildCharScanningTests()->run(logger);
+    success &= test::buildParseFilesTests()->run(logger);
+    success &= test::buildNumberLiteralTests()->run(logger);
+    success &= test::buildEnvironmentTests()->run(logger);
+    success &= test::buildTypeTableTests()->run(logger);
+    success &= test::FileSystemTestGenerator("sfsl").findAndGenerate()->run(logger);
+    return success ? 0 : 1;
 }
@@ -59,7 +59,7 @@ public:
         }
 
         src::StringSource source(src::InputSourceName::make(ctx, "tmp"), _toComplete);
-        lex::Lexer toCompleteLexer(ctx->memoryManager(), ctx->reporter(), source);
+        lex::Lexer toCompleteLexer(ctx->reporter(), ctx->names(), source);
         ast::Parser toCompleteParser(ctx, toCompleteLexer, namer);
 
         _exprToComplete = toCompleteParser.parseSingleExpression();
@@ -121,7 +121,7 @@ public:
                 if (ast::ClassDecl* clss = pt->getClass()) {
                     sym::Scope* clssScope = clss->getScope();
 
-                    for (const std::pair<std::string, sym::SymbolData>& entry : clssScope->getAllSymbols()) {
+                    for (const std::pair<common::Name, sym::SymbolData>& entry : clssScope->getAllSymbols()) {
                         outputFromSymbolData(entry.second, tp->applyTCCallsOnly(_ctx)->getEnvironment());
                     }
                 }
@@ -220,15 +220,14 @@ int main(int argc, char** argv) {
         return 2;
     }
 
-    std::ifstream f(sourceFile);
-    std::stringstream buffer;
-    buffer << f.rdbuf();
-
-    std::string source = buffer.str();
+    if (!std::ifstream(sourceFile)) {
+        std::cerr << "could not open source file " << sourceFile << std::endl;
+        return 3;
+    }
 
     Compiler cmp(CompilerConfig().with<opt::Reporter>(StandartReporter::EmptyReporter));
 
-    ProgramBuilder prog = cmp.parse(sourceFile, source);
+    ProgramBuilder prog = cmp.parseFile(sourceFile);
 
     if (!prog) {
         return 3;